@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-04-29     RT-Thread    first version
+ * 2026-10-19     RT-Thread    bring the modem up alongside freemodbus
+ * 2026-10-19     RT-Thread    read the buffered downlink messages while running
  */
 
 #include <rtthread.h>
@@ -17,13 +19,16 @@
 
 #include "mqtt_ctl.h"
 
+#ifdef RT_USING_PM
+#include <rtdevice.h>
+#endif
+
 static unsigned char is_stop = 0;
 
 int mqtt_ctl_test(int argc, char **argv);
 extern int mb_master_sample(int argc, char **argv);
 
 mqtt_ctl_t my_handler = NULL;
-char msg_buf[256];
 rt_sem_t recv_sem = NULL;
 
 int main(void)
@@ -31,7 +36,15 @@ int main(void)
     /* 初始化信号量 */
     recv_sem = rt_sem_create("recv_sem", 0, RT_IPC_FLAG_PRIO);
 
-    /* 初始化 freemodbus */
+#ifdef RT_USING_PM
+    /* 空闲时允许睡眠, 由下一个定时器到期时间唤醒 */
+    rt_pm_release(PM_SLEEP_MODE_NONE);
+#endif
+
+    /* 先启动 AT 客户端, 模组上电后的 RDY 不会丢失 */
+    my_handler = mqtt_ctl_create();
+
+    /* 初始化 freemodbus, 与模组启动同时进行 */
     mb_master_sample(0, NULL);
 
     /* 运行 mqtt_ctl */
@@ -48,7 +61,10 @@ int main(void)
 
 int mqtt_ctl_test(int argc, char **argv)
 {
-    my_handler = mqtt_ctl_create();
+    if (my_handler == NULL)
+    {
+        my_handler = mqtt_ctl_create();
+    }
     if (my_handler == NULL)
     {
         return -1;
@@ -88,7 +104,7 @@ int mqtt_ctl_test(int argc, char **argv)
 
     while (!my_handler->is_open)
     {
-        rt_thread_delay(100);
+        rt_thread_mdelay(10);
     }
 
     if (my_handler->conn)
@@ -107,7 +123,7 @@ int mqtt_ctl_test(int argc, char **argv)
 
     while (!my_handler->is_conn)
     {
-        rt_thread_delay(100);
+        rt_thread_mdelay(10);
     }
 
     if (my_handler->sub)
@@ -123,9 +139,10 @@ int mqtt_ctl_test(int argc, char **argv)
         }
     }
 
+    /* 读取模组缓存的下行消息, 一次读完一批 */
     while (!is_stop)
     {
-        rt_thread_delay(100);
+        mqtt_ctl_recv_fetch(my_handler, 100);
     }
 
     if (my_handler->unsub)
@@ -155,6 +172,7 @@ int mqtt_ctl_test(int argc, char **argv)
     }
 
     mqtt_ctl_delete(my_handler);
+    my_handler = NULL;
     return 0;
 }
 #ifdef FINSH_USING_MSH
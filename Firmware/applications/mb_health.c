@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+#include "mb_health.h"
+#include <rthw.h>
+
+#define DBG_TAG "mb_health"
+#define DBG_LVL DBG_LOG
+#include <rtdbg.h>
+
+/*
+ * The respond timeout of a slave follows its round trip time the way TCP
+ * does (RFC 6298): a smoothed RTT and a mean deviation, the timeout the
+ * RTT plus four deviations, doubled by each timeout. A slave missing
+ * MB_HEALTH_FAIL_NUM replies in a row opens its breaker: the requests to
+ * it fail at once, and one probe a backoff goes out to see if it is back,
+ * the backoff doubled by each probe lost.
+ */
+enum mb_health_state
+{
+    MB_HEALTH_CLOSED = 0,           // the requests go out
+    MB_HEALTH_OPEN,                 // the requests fail until the backoff is over
+    MB_HEALTH_HALF_OPEN,            // one probe is out
+};
+
+struct mb_health
+{
+    rt_uint8_t slave;               // 0 for a free entry
+    rt_uint8_t state;
+    rt_uint8_t fails;               // the timeouts in a row
+    rt_uint8_t sampled;
+    rt_uint16_t srtt;               // ms << 3
+    rt_uint16_t rttvar;             // ms << 2, four deviations
+    rt_uint16_t rto;                // ms
+    rt_uint16_t backoff;            // ms
+    rt_tick_t retry;                // the tick the next probe may go out
+    rt_tick_t used;
+    rt_uint32_t requests;
+    rt_uint32_t timeouts;
+    rt_uint32_t skipped;            // failed without the bus
+};
+
+static const char *const state_name[] = {"closed", "open", "half"};
+
+static struct mb_health health[MB_HEALTH_SLAVE_NUM];
+static rt_uint32_t saved_ms;        // the bus time the fixed respond timeout would have taken more
+
+/* The entry of a slave, a new one takes the least recently used entry, healthy ones first */
+static struct mb_health *health_get(rt_uint8_t slave)
+{
+    struct mb_health *entry, *victim = RT_NULL;
+
+    for (entry = health; entry < health + MB_HEALTH_SLAVE_NUM; entry++)
+    {
+        if (entry->slave == slave)
+        {
+            entry->used = rt_tick_get();
+            return entry;
+        }
+    }
+
+    for (entry = health; entry < health + MB_HEALTH_SLAVE_NUM; entry++)
+    {
+        if (entry->slave == 0)
+        {
+            victim = entry;
+            break;
+        }
+        if (victim == RT_NULL || (victim->state != MB_HEALTH_CLOSED && entry->state == MB_HEALTH_CLOSED) ||
+            ((victim->state == MB_HEALTH_CLOSED) == (entry->state == MB_HEALTH_CLOSED) &&
+             (rt_int32_t)(entry->used - victim->used) < 0))
+        {
+            victim = entry;
+        }
+    }
+
+    rt_memset(victim, 0, sizeof(struct mb_health));
+    victim->slave = slave;
+    victim->rto = MB_HEALTH_RTO_INIT_MS;
+    victim->used = rt_tick_get();
+    return victim;
+}
+
+/**
+ * mb_health_timeout - Get the respond timeout of a slave
+ * @slave: the slave address
+ *
+ * Return: the timeout in ms
+ */
+rt_uint32_t mb_health_timeout(rt_uint8_t slave)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    rt_uint32_t rto = health_get(slave)->rto;
+
+    rt_hw_interrupt_enable(level);
+    return rto;
+}
+
+/**
+ * mb_health_rtt - Add a round trip time sample of a slave
+ * @slave: the slave address
+ * @rtt_ms: from the end of the request to the first byte of the reply
+ */
+void mb_health_rtt(rt_uint8_t slave, rt_uint32_t rtt_ms)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    struct mb_health *entry = health_get(slave);
+    rt_int32_t err;
+    rt_uint32_t rto;
+
+    if (rtt_ms > MB_HEALTH_RTO_MAX_MS)
+    {
+        rtt_ms = MB_HEALTH_RTO_MAX_MS;
+    }
+
+    if (!entry->sampled)
+    {
+        entry->srtt = rtt_ms << 3;
+        entry->rttvar = rtt_ms << 1;
+        entry->sampled = 1;
+    }
+    else
+    {
+        err = (rt_int32_t)rtt_ms - (entry->srtt >> 3);
+        entry->srtt += err;
+        if (err < 0)
+        {
+            err = -err;
+        }
+        entry->rttvar += err - (entry->rttvar >> 2);
+    }
+
+    rto = (entry->srtt >> 3) + entry->rttvar;
+    if (rto < MB_HEALTH_RTO_MIN_MS)
+    {
+        rto = MB_HEALTH_RTO_MIN_MS;
+    }
+    else if (rto > MB_HEALTH_RTO_MAX_MS)
+    {
+        rto = MB_HEALTH_RTO_MAX_MS;
+    }
+    entry->rto = rto;
+
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * mb_health_allow - Check the breaker of a slave before a request
+ * @slave: the slave address
+ *
+ * Return: RT_TRUE to send the request, RT_FALSE to fail it without the bus
+ */
+rt_bool_t mb_health_allow(rt_uint8_t slave)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    struct mb_health *entry = health_get(slave);
+    rt_bool_t allow = RT_TRUE;
+
+    if (entry->state == MB_HEALTH_OPEN && (rt_int32_t)(rt_tick_get() - entry->retry) >= 0)
+    {
+        /* the backoff is over, this request is the probe */
+        entry->state = MB_HEALTH_HALF_OPEN;
+    }
+    else if (entry->state != MB_HEALTH_CLOSED)
+    {
+        entry->skipped++;
+        saved_ms += MB_HEALTH_RTO_INIT_MS;
+        allow = RT_FALSE;
+    }
+    if (allow)
+    {
+        entry->requests++;
+    }
+
+    rt_hw_interrupt_enable(level);
+    return allow;
+}
+
+/**
+ * mb_health_done - Report the end of a request the breaker let out
+ * @slave: the slave address
+ * @answered: RT_FALSE when the slave did not reply in time
+ */
+void mb_health_done(rt_uint8_t slave, rt_bool_t answered)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    struct mb_health *entry = health_get(slave);
+    rt_uint8_t state = entry->state;
+
+    if (answered)
+    {
+        entry->fails = 0;
+        entry->backoff = 0;
+        entry->state = MB_HEALTH_CLOSED;
+    }
+    else
+    {
+        entry->timeouts++;
+        if (entry->rto < MB_HEALTH_RTO_INIT_MS)
+        {
+            saved_ms += MB_HEALTH_RTO_INIT_MS - entry->rto;
+        }
+        /* the next reply may be late, not lost */
+        entry->rto = entry->rto * 2 > MB_HEALTH_RTO_MAX_MS ? MB_HEALTH_RTO_MAX_MS : entry->rto * 2;
+
+        if (entry->fails < 0xFF)
+        {
+            entry->fails++;
+        }
+        if (state == MB_HEALTH_HALF_OPEN || entry->fails >= MB_HEALTH_FAIL_NUM)
+        {
+            if (entry->backoff == 0)
+            {
+                entry->backoff = MB_HEALTH_BACKOFF_MIN_MS;
+            }
+            else if (state == MB_HEALTH_HALF_OPEN)
+            {
+                entry->backoff = entry->backoff > MB_HEALTH_BACKOFF_MAX_MS / 2 ?
+                                 MB_HEALTH_BACKOFF_MAX_MS : entry->backoff * 2;
+            }
+            entry->retry = rt_tick_get() + rt_tick_from_millisecond(entry->backoff);
+            entry->state = MB_HEALTH_OPEN;
+        }
+    }
+
+    rt_hw_interrupt_enable(level);
+
+    if (state != MB_HEALTH_CLOSED && answered)
+    {
+        LOG_I("slave %d is back.", slave);
+    }
+    else if (state == MB_HEALTH_CLOSED && entry->state == MB_HEALTH_OPEN)
+    {
+        LOG_W("slave %d missed %d replies, probe it every %d ms.", slave, entry->fails, entry->backoff);
+    }
+}
+
+/**
+ * mb_health_cancel - End a request the breaker let out without a frame sent
+ * @slave: the slave address
+ *
+ * Nothing is learnt of the slave, a probe not sent goes out with the next request.
+ */
+void mb_health_cancel(rt_uint8_t slave)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    struct mb_health *entry = health_get(slave);
+
+    if (entry->requests > 0)
+    {
+        entry->requests--;
+    }
+    if (entry->state == MB_HEALTH_HALF_OPEN)
+    {
+        entry->state = MB_HEALTH_OPEN;
+        entry->retry = rt_tick_get();
+    }
+
+    rt_hw_interrupt_enable(level);
+}
+
+static int mb_health(int argc, char **argv)
+{
+    struct mb_health *entry;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "-r"))
+    {
+        rt_base_t level = rt_hw_interrupt_disable();
+
+        rt_memset(health, 0, sizeof(health));
+        saved_ms = 0;
+        rt_hw_interrupt_enable(level);
+        return 0;
+    }
+    else if (argc > 1)
+    {
+        rt_kprintf("Usage: mb_health [-r]\r\n");
+        return -1;
+    }
+
+    rt_kprintf("slave state   srtt rttvar   rto fails  requests  timeouts   skipped backoff\r\n");
+    for (entry = health; entry < health + MB_HEALTH_SLAVE_NUM; entry++)
+    {
+        if (entry->slave == 0)
+        {
+            continue;
+        }
+        rt_kprintf("%5d %-6s %5d %6d %5d %5d %9d %9d %9d %7d\r\n", entry->slave, state_name[entry->state],
+                   entry->srtt >> 3, entry->rttvar >> 2, entry->rto, entry->fails,
+                   entry->requests, entry->timeouts, entry->skipped, entry->backoff);
+    }
+    rt_kprintf("bus time saved against the fixed %d ms timeout: %d ms\r\n", MB_HEALTH_RTO_INIT_MS, saved_ms);
+    return 0;
+}
+MSH_CMD_EXPORT(mb_health, show the respond timeouts and the breakers of the modbus slaves);
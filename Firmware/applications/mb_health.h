@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+#ifndef APPLICATIONS_MB_HEALTH_H_
+#define APPLICATIONS_MB_HEALTH_H_
+
+#include <rtthread.h>
+
+#define MB_HEALTH_SLAVE_NUM     16      // The slaves followed at a time
+#define MB_HEALTH_RTO_INIT_MS   100     // The respond timeout before the first reply, the fixed one of FreeModbus
+#define MB_HEALTH_RTO_MIN_MS    20
+#define MB_HEALTH_RTO_MAX_MS    1000
+#define MB_HEALTH_FAIL_NUM      3       // The timeouts in a row opening the breaker
+#define MB_HEALTH_BACKOFF_MIN_MS 1000   // The first wait before a probe
+#define MB_HEALTH_BACKOFF_MAX_MS 60000
+
+rt_uint32_t mb_health_timeout(rt_uint8_t slave);
+void mb_health_rtt(rt_uint8_t slave, rt_uint32_t rtt_ms);
+rt_bool_t mb_health_allow(rt_uint8_t slave);
+void mb_health_done(rt_uint8_t slave, rt_bool_t answered);
+void mb_health_cancel(rt_uint8_t slave);
+
+#endif /* APPLICATIONS_MB_HEALTH_H_ */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+/*
+ * The timer port of the FreeModbus master with the respond timeout of the
+ * slave addressed, see mb_health.c. It takes the place of port/porttimer_m.c
+ * of the package, .cproject and packages/SConscript leave that file out.
+ */
+#include <rtthread.h>
+
+#include "port.h"
+#include "mb.h"
+#include "mb_m.h"
+#include "mbport.h"
+#include "mb_health.h"
+
+#if MB_MASTER_RTU_ENABLED > 0 || MB_MASTER_ASCII_ENABLED > 0
+
+static struct rt_timer timer;
+static USHORT usT35TimeOut50us;
+
+/* the slave and the tick of the request the respond timeout is running for */
+static UCHAR respond_slave;
+static rt_tick_t respond_tick;
+
+static void prvvTIMERExpiredISR(void);
+static void timer_timeout_ind(void *parameter);
+
+BOOL xMBMasterPortTimersInit(USHORT usTimeOut50us)
+{
+    /* backup T35 ticks */
+    usT35TimeOut50us = usTimeOut50us;
+
+    rt_timer_init(&timer, "master timer",
+                  timer_timeout_ind, /* bind timeout callback function */
+                  RT_NULL,
+                  (50 * usT35TimeOut50us) / (1000 * 1000 / RT_TICK_PER_SECOND) + 1,
+                  RT_TIMER_FLAG_ONE_SHOT); /* one shot */
+
+    return TRUE;
+}
+
+void vMBMasterPortTimersT35Enable()
+{
+    rt_tick_t timer_tick = (50 * usT35TimeOut50us) / (1000 * 1000 / RT_TICK_PER_SECOND) + 1;
+
+    /* the first byte of the reply ends the round trip */
+    if (respond_slave != 0)
+    {
+        mb_health_rtt(respond_slave, (rt_tick_get() - respond_tick) * 1000 / RT_TICK_PER_SECOND);
+        respond_slave = 0;
+    }
+
+    /* Set current timer mode, don't change it.*/
+    vMBMasterSetCurTimerMode(MB_TMODE_T35);
+
+    rt_timer_control(&timer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
+
+    rt_timer_start(&timer);
+}
+
+void vMBMasterPortTimersConvertDelayEnable()
+{
+    rt_tick_t timer_tick = rt_tick_from_millisecond(MB_MASTER_DELAY_MS_CONVERT);
+
+    respond_slave = 0;
+
+    /* Set current timer mode, don't change it.*/
+    vMBMasterSetCurTimerMode(MB_TMODE_CONVERT_DELAY);
+
+    rt_timer_control(&timer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
+
+    rt_timer_start(&timer);
+}
+
+void vMBMasterPortTimersRespondTimeoutEnable()
+{
+    UCHAR slave = ucMBMasterGetDestAddress();
+    rt_tick_t timer_tick = rt_tick_from_millisecond(mb_health_timeout(slave));
+
+    respond_slave = slave;
+    respond_tick = rt_tick_get();
+
+    /* Set current timer mode, don't change it.*/
+    vMBMasterSetCurTimerMode(MB_TMODE_RESPOND_TIMEOUT);
+
+    rt_timer_control(&timer, RT_TIMER_CTRL_SET_TIME, &timer_tick);
+
+    rt_timer_start(&timer);
+}
+
+void vMBMasterPortTimersDisable()
+{
+    rt_timer_stop(&timer);
+}
+
+void prvvTIMERExpiredISR(void)
+{
+    respond_slave = 0;
+    (void) pxMBMasterPortCBTimerExpired();
+}
+
+static void timer_timeout_ind(void *parameter)
+{
+    prvvTIMERExpiredISR();
+}
+
+#endif /* MB_MASTER_RTU_ENABLED > 0 || MB_MASTER_ASCII_ENABLED > 0 */
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ * 2026-10-19     RT-Thread    8 bytes an index entry
+ */
+#include "mb_regstore.h"
+#include <stdlib.h>
+
+#define DBG_TAG "mb_regstore"
+#define DBG_LVL DBG_LOG
+#include <rtdbg.h>
+
+/*
+ * The ranges of all the slaves are sorted by slave, type and start address,
+ * the ranges touching each other merged. A lookup is a binary search of the
+ * index, the values of a range are a slice of one word pool, 16 bits a word
+ * for the bit tables.
+ */
+struct mb_range
+{
+    rt_uint8_t slave;
+    rt_uint8_t type;
+    rt_uint16_t start;
+    rt_uint16_t count;                     // registers or bits
+    rt_uint16_t offset;                    // the first word in the pool
+};
+
+#define MB_RANGE_MAX 0xFFFF                 // The largest count and the last offset of a range
+
+static struct mb_range *range_index;
+static rt_size_t range_num;
+static rt_uint16_t *word_pool;
+static rt_size_t word_num;
+
+static int range_cmp(const void *a, const void *b)
+{
+    const struct mb_range *x = (const struct mb_range *)a;
+    const struct mb_range *y = (const struct mb_range *)b;
+
+    if (x->slave != y->slave)
+    {
+        return x->slave - y->slave;
+    }
+    if (x->type != y->type)
+    {
+        return x->type - y->type;
+    }
+    return (int)x->start - (int)y->start;
+}
+
+static rt_size_t range_words(int type, rt_uint32_t count)
+{
+    return (type == MB_STORE_COIL || type == MB_STORE_DISCRETE) ? (count + 15) / 16 : count;
+}
+
+/**
+ * mb_regstore_init - Build the store of the configured point list
+ * @points: the ranges, any order, overlapping allowed
+ * @num: the number of ranges
+ *
+ * Return: 0 on success, -1 without memory
+ */
+int mb_regstore_init(const struct mb_regstore_point *points, rt_size_t num)
+{
+    struct mb_range *ranges;
+    rt_size_t index, merged = 0;
+    rt_uint32_t words = 0, end;
+
+    ranges = (struct mb_range *)rt_calloc(num ? num : 1, sizeof(struct mb_range));
+    if (ranges == RT_NULL)
+    {
+        LOG_E("No memory for the index of %d ranges.", (int)num);
+        return -1;
+    }
+
+    for (index = 0; index < num; index++)
+    {
+        ranges[index].slave = points[index].slave;
+        ranges[index].type = points[index].type;
+        ranges[index].start = points[index].start;
+        ranges[index].count = points[index].count;
+    }
+    qsort(ranges, num, sizeof(struct mb_range), range_cmp);
+
+    for (index = 0; index < num; index++)
+    {
+        struct mb_range *prev = merged ? &ranges[merged - 1] : RT_NULL;
+
+        if (prev && prev->slave == ranges[index].slave && prev->type == ranges[index].type &&
+            ranges[index].start <= (rt_uint32_t)prev->start + prev->count)
+        {
+            end = (rt_uint32_t)ranges[index].start + ranges[index].count;
+            if (end - prev->start > MB_RANGE_MAX)
+            {
+                LOG_E("Slave %d has more than %d registers in a row.", prev->slave, MB_RANGE_MAX);
+                rt_free(ranges);
+                return -1;
+            }
+            if (end > (rt_uint32_t)prev->start + prev->count)
+            {
+                prev->count = end - prev->start;
+            }
+            continue;
+        }
+        ranges[merged++] = ranges[index];
+    }
+
+    for (index = 0; index < merged; index++)
+    {
+        if (words > MB_RANGE_MAX)
+        {
+            LOG_E("More than %d register words.", MB_RANGE_MAX);
+            rt_free(ranges);
+            return -1;
+        }
+        ranges[index].offset = words;
+        words += range_words(ranges[index].type, ranges[index].count);
+    }
+
+    rt_free(word_pool);
+    rt_free(range_index);
+    word_pool = (rt_uint16_t *)rt_calloc(words ? words : 1, sizeof(rt_uint16_t));
+    if (word_pool == RT_NULL)
+    {
+        LOG_E("No memory for %d register words.", words);
+        rt_free(ranges);
+        range_index = RT_NULL;
+        range_num = 0;
+        return -1;
+    }
+    range_index = (struct mb_range *)rt_realloc(ranges, (merged ? merged : 1) * sizeof(struct mb_range));
+    if (range_index == RT_NULL)
+    {
+        range_index = ranges;
+    }
+    range_num = merged;
+    word_num = words;
+
+    LOG_I("%d ranges, %d words, %d bytes.", (int)range_num, (int)word_num,
+          (int)(range_num * sizeof(struct mb_range) + word_num * sizeof(rt_uint16_t)));
+    return 0;
+}
+
+/* The range holding addr to addr + count - 1, O(log n) */
+static const struct mb_range *range_find(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint16_t count)
+{
+    const struct mb_range *found = RT_NULL;
+    rt_size_t low = 0, high = range_num;
+
+    /* the last range starting at addr or before */
+    while (low < high)
+    {
+        rt_size_t mid = (low + high) / 2;
+        const struct mb_range *range = &range_index[mid];
+
+        if (range->slave < slave ||
+            (range->slave == slave && (range->type < type || (range->type == type && range->start <= addr))))
+        {
+            found = range;
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if (found == RT_NULL || found->slave != slave || found->type != type ||
+        (rt_uint32_t)addr + count > (rt_uint32_t)found->start + found->count)
+    {
+        return RT_NULL;
+    }
+    return found;
+}
+
+/**
+ * mb_regstore_contains - Check a request against the configured ranges
+ * @slave: the slave address
+ * @type: enum mb_regstore_type
+ * @addr: the first address, 0 based
+ * @count: registers or bits
+ *
+ * Return: RT_TRUE when one range holds them all
+ */
+rt_bool_t mb_regstore_contains(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint16_t count)
+{
+    return range_find(slave, type, addr, count) != RT_NULL;
+}
+
+/**
+ * mb_regstore_put_regs - Store the registers of a frame
+ * @slave: the slave address
+ * @type: MB_STORE_HOLDING or MB_STORE_INPUT
+ * @addr: the first address, 0 based
+ * @frame: the values, big endian
+ * @count: the number of registers
+ *
+ * Return: 0 on success, -1 outside the configured ranges
+ */
+int mb_regstore_put_regs(rt_uint8_t slave, int type, rt_uint16_t addr, const rt_uint8_t *frame, rt_uint16_t count)
+{
+    const struct mb_range *range = range_find(slave, type, addr, count);
+    rt_uint16_t *regs;
+
+    if (range == RT_NULL)
+    {
+        return -1;
+    }
+
+    regs = word_pool + range->offset + (addr - range->start);
+    while (count--)
+    {
+        *regs++ = ((rt_uint16_t)frame[0] << 8) | frame[1];
+        frame += 2;
+    }
+    return 0;
+}
+
+/**
+ * mb_regstore_put_bits - Store the coils or discrete inputs of a frame
+ * @slave: the slave address
+ * @type: MB_STORE_COIL or MB_STORE_DISCRETE
+ * @addr: the first address, 0 based
+ * @frame: the bits, the first in bit 0 of the first byte
+ * @count: the number of bits
+ *
+ * Return: 0 on success, -1 outside the configured ranges
+ */
+int mb_regstore_put_bits(rt_uint8_t slave, int type, rt_uint16_t addr, const rt_uint8_t *frame, rt_uint16_t count)
+{
+    const struct mb_range *range = range_find(slave, type, addr, count);
+    rt_uint16_t *words;
+    rt_uint32_t bit, index;
+
+    if (range == RT_NULL)
+    {
+        return -1;
+    }
+
+    words = word_pool + range->offset;
+    bit = addr - range->start;
+    for (index = 0; index < count; index++, bit++)
+    {
+        if (frame[index / 8] & (1 << (index % 8)))
+        {
+            words[bit / 16] |= 1 << (bit % 16);
+        }
+        else
+        {
+            words[bit / 16] &= ~(1 << (bit % 16));
+        }
+    }
+    return 0;
+}
+
+/**
+ * mb_regstore_get_regs - Read the stored registers
+ * @slave: the slave address
+ * @type: MB_STORE_HOLDING or MB_STORE_INPUT
+ * @addr: the first address, 0 based
+ * @regs: the values
+ * @count: the number of registers
+ *
+ * Return: 0 on success, -1 outside the configured ranges
+ */
+int mb_regstore_get_regs(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint16_t *regs, rt_uint16_t count)
+{
+    const struct mb_range *range = range_find(slave, type, addr, count);
+
+    if (range == RT_NULL)
+    {
+        return -1;
+    }
+
+    rt_memcpy(regs, word_pool + range->offset + (addr - range->start), count * sizeof(rt_uint16_t));
+    return 0;
+}
+
+/**
+ * mb_regstore_get_bits - Read the stored coils or discrete inputs
+ * @slave: the slave address
+ * @type: MB_STORE_COIL or MB_STORE_DISCRETE
+ * @addr: the first address, 0 based
+ * @bits: a byte a bit, 0 or 1
+ * @count: the number of bits
+ *
+ * Return: 0 on success, -1 outside the configured ranges
+ */
+int mb_regstore_get_bits(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint8_t *bits, rt_uint16_t count)
+{
+    const struct mb_range *range = range_find(slave, type, addr, count);
+    const rt_uint16_t *words;
+    rt_uint32_t bit, index;
+
+    if (range == RT_NULL)
+    {
+        return -1;
+    }
+
+    words = word_pool + range->offset;
+    bit = addr - range->start;
+    for (index = 0; index < count; index++, bit++)
+    {
+        bits[index] = (words[bit / 16] >> (bit % 16)) & 1;
+    }
+    return 0;
+}
+
+static int mb_regstore(int argc, char **argv)
+{
+    static const char *const type_name[] = {"coil", "discrete", "holding", "input"};
+    rt_size_t index;
+
+    rt_kprintf("%d ranges, %d words, %d bytes\r\n", (int)range_num, (int)word_num,
+               (int)(range_num * sizeof(struct mb_range) + word_num * sizeof(rt_uint16_t)));
+    for (index = 0; index < range_num; index++)
+    {
+        rt_kprintf("slave %3d %-8s %5d - %5d\r\n", range_index[index].slave, type_name[range_index[index].type],
+                   range_index[index].start, (int)range_index[index].start + range_index[index].count - 1);
+    }
+    return 0;
+}
+MSH_CMD_EXPORT(mb_regstore, show the register ranges of the modbus slaves);
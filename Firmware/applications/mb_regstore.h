@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+#ifndef APPLICATIONS_MB_REGSTORE_H_
+#define APPLICATIONS_MB_REGSTORE_H_
+
+#include <rtthread.h>
+
+/* the register tables of a slave */
+enum mb_regstore_type
+{
+    MB_STORE_COIL = 0,
+    MB_STORE_DISCRETE,
+    MB_STORE_HOLDING,
+    MB_STORE_INPUT,
+};
+
+/* a range of registers or bits a slave exposes, the configured point list */
+struct mb_regstore_point
+{
+    rt_uint8_t slave;
+    rt_uint8_t type;                       // enum mb_regstore_type
+    rt_uint16_t start;                     // the first address, 0 based
+    rt_uint16_t count;                     // registers or bits
+};
+
+int mb_regstore_init(const struct mb_regstore_point *points, rt_size_t num);
+rt_bool_t mb_regstore_contains(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint16_t count);
+
+/* the registers are in the frame order, big endian, the bits packed from bit 0 */
+int mb_regstore_put_regs(rt_uint8_t slave, int type, rt_uint16_t addr, const rt_uint8_t *frame, rt_uint16_t count);
+int mb_regstore_put_bits(rt_uint8_t slave, int type, rt_uint16_t addr, const rt_uint8_t *frame, rt_uint16_t count);
+
+int mb_regstore_get_regs(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint16_t *regs, rt_uint16_t count);
+int mb_regstore_get_bits(rt_uint8_t slave, int type, rt_uint16_t addr, rt_uint8_t *bits, rt_uint16_t count);
+
+#endif /* APPLICATIONS_MB_REGSTORE_H_ */
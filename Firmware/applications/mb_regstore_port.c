@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+/*
+ * The register callbacks of the FreeModbus master, the values of the replies
+ * and of the write requests go to the sparse register store. They take the
+ * place of port/user_mb_app_m.c of the package and its dense per slave
+ * arrays, .cproject and packages/SConscript leave that file out.
+ */
+#include "mb.h"
+#include "mb_m.h"
+#include "mb_regstore.h"
+
+/**
+ * eMBMasterRegInputCB - Store the input registers of a reply
+ * @pucRegBuffer: the registers, big endian
+ * @usAddress: the first register, 1 based
+ * @usNRegs: the number of registers
+ *
+ * Return: MB_ENOERR, MB_ENOREG outside the configured ranges
+ */
+eMBErrorCode eMBMasterRegInputCB(UCHAR *pucRegBuffer, USHORT usAddress, USHORT usNRegs)
+{
+    /* it already plus one in modbus function method. */
+    usAddress--;
+
+    if (mb_regstore_put_regs(ucMBMasterGetDestAddress(), MB_STORE_INPUT, usAddress, pucRegBuffer, usNRegs) != 0)
+    {
+        return MB_ENOREG;
+    }
+    return MB_ENOERR;
+}
+
+/**
+ * eMBMasterRegHoldingCB - Store the holding registers of a reply or a write
+ * @pucRegBuffer: the registers, big endian
+ * @usAddress: the first register, 1 based
+ * @usNRegs: the number of registers
+ * @eMode: read or write, both update the store
+ *
+ * Return: MB_ENOERR, MB_ENOREG outside the configured ranges
+ */
+eMBErrorCode eMBMasterRegHoldingCB(UCHAR *pucRegBuffer, USHORT usAddress, USHORT usNRegs, eMBRegisterMode eMode)
+{
+    (void)eMode;
+    /* it already plus one in modbus function method. */
+    usAddress--;
+
+    if (mb_regstore_put_regs(ucMBMasterGetDestAddress(), MB_STORE_HOLDING, usAddress, pucRegBuffer, usNRegs) != 0)
+    {
+        return MB_ENOREG;
+    }
+    return MB_ENOERR;
+}
+
+/**
+ * eMBMasterRegCoilsCB - Store the coils of a reply or a write
+ * @pucRegBuffer: the coils, packed from bit 0
+ * @usAddress: the first coil, 1 based
+ * @usNCoils: the number of coils
+ * @eMode: read or write, both update the store
+ *
+ * Return: MB_ENOERR, MB_ENOREG outside the configured ranges
+ */
+eMBErrorCode eMBMasterRegCoilsCB(UCHAR *pucRegBuffer, USHORT usAddress, USHORT usNCoils, eMBRegisterMode eMode)
+{
+    (void)eMode;
+    /* it already plus one in modbus function method. */
+    usAddress--;
+
+    if (mb_regstore_put_bits(ucMBMasterGetDestAddress(), MB_STORE_COIL, usAddress, pucRegBuffer, usNCoils) != 0)
+    {
+        return MB_ENOREG;
+    }
+    return MB_ENOERR;
+}
+
+/**
+ * eMBMasterRegDiscreteCB - Store the discrete inputs of a reply
+ * @pucRegBuffer: the inputs, packed from bit 0
+ * @usAddress: the first input, 1 based
+ * @usNDiscrete: the number of inputs
+ *
+ * Return: MB_ENOERR, MB_ENOREG outside the configured ranges
+ */
+eMBErrorCode eMBMasterRegDiscreteCB(UCHAR *pucRegBuffer, USHORT usAddress, USHORT usNDiscrete)
+{
+    /* it already plus one in modbus function method. */
+    usAddress--;
+
+    if (mb_regstore_put_bits(ucMBMasterGetDestAddress(), MB_STORE_DISCRETE, usAddress, pucRegBuffer, usNDiscrete) != 0)
+    {
+        return MB_ENOREG;
+    }
+    return MB_ENOERR;
+}
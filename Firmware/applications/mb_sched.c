@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ * 2026-10-19     RT-Thread    queue the requests of a thread by class
+ */
+#include "mb_sched.h"
+#include <string.h>
+
+/*
+ * The bus is taken by class, not by arrival, a class up for each
+ * MB_SCHED_AGING_MS of waiting so the polls and the backfill are not
+ * starved. A thread with many requests, as the send thread of the cloud,
+ * submits them to the queue and runs the one mb_sched_next gives; the
+ * threads with a request each wait in mb_sched_acquire and the bus goes to
+ * the best waiter when a transaction ends. The owner runs at
+ * MB_SCHED_BUS_PRIORITY at least, a busy thread between it and the bus
+ * would hold the bus idle.
+ */
+struct mb_sched_waiter
+{
+    struct mb_sched_req req;
+    struct rt_semaphore sem;
+    rt_thread_t thread;
+    rt_uint8_t granted;
+};
+
+struct mb_sched_stat
+{
+    rt_uint32_t count;
+    rt_uint32_t timeouts;       // no turn before the timeout
+    rt_uint32_t wait_sum;       // ms, from the acquire to the turn
+    rt_uint32_t wait_max;
+    rt_uint32_t bus_sum;        // ms, from the turn to the release
+    rt_uint32_t bus_max;
+};
+
+static const char *const class_name[MB_SCHED_CLASS_NUM] = {"control", "alarm", "poll", "bulk"};
+
+static rt_list_t waiters = RT_LIST_OBJECT_INIT(waiters);
+static rt_list_t queued = RT_LIST_OBJECT_INIT(queued);
+static rt_thread_t owner;
+static rt_uint8_t owner_cls;
+static rt_uint8_t owner_priority;   // the priority to give back
+static rt_tick_t owner_tick;
+static struct mb_sched_stat mb_sched_stats[MB_SCHED_CLASS_NUM];
+
+static rt_uint32_t sched_ms(rt_tick_t ticks)
+{
+    return ticks * 1000 / RT_TICK_PER_SECOND;
+}
+
+/* Give the bus to a thread, the scheduler is locked */
+static void sched_grant(rt_thread_t thread, int cls, rt_tick_t submit)
+{
+    rt_uint8_t priority = MB_SCHED_BUS_PRIORITY;
+    rt_uint32_t wait;
+
+    owner = thread;
+    owner_cls = cls;
+    owner_tick = rt_tick_get();
+    owner_priority = thread->current_priority;
+    if (thread->current_priority > priority)
+    {
+        rt_thread_control(thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+    }
+
+    wait = sched_ms(owner_tick - submit);
+    mb_sched_stats[cls].count++;
+    mb_sched_stats[cls].wait_sum += wait;
+    if (wait > mb_sched_stats[cls].wait_max)
+    {
+        mb_sched_stats[cls].wait_max = wait;
+    }
+}
+
+/* The request of a list to go next, the scheduler is locked */
+static struct mb_sched_req *sched_pick(rt_list_t *list)
+{
+    struct mb_sched_req *req, *best = RT_NULL;
+    rt_tick_t now = rt_tick_get();
+    rt_int32_t score, best_score = 0;
+    rt_list_t *node;
+
+    rt_list_for_each(node, list)
+    {
+        req = rt_list_entry(node, struct mb_sched_req, list);
+        score = (rt_int32_t)req->cls * MB_SCHED_AGING_MS - (rt_int32_t)sched_ms(now - req->submit);
+        /* the first of the same score arrived first */
+        if (best == RT_NULL || score < best_score)
+        {
+            best = req;
+            best_score = score;
+        }
+    }
+
+    return best;
+}
+
+/* Take the best request of a list, RT_NULL with the list empty */
+static struct mb_sched_req *sched_take(rt_list_t *list)
+{
+    struct mb_sched_req *req;
+
+    rt_enter_critical();
+    req = sched_pick(list);
+    if (req != RT_NULL)
+    {
+        rt_list_remove(&req->list);
+    }
+    rt_exit_critical();
+
+    return req;
+}
+
+static void sched_submit(rt_list_t *list, struct mb_sched_req *req, int cls, rt_tick_t submit)
+{
+    RT_ASSERT(cls >= 0 && cls < MB_SCHED_CLASS_NUM);
+
+    req->submit = submit;
+    req->cls = cls;
+    rt_enter_critical();
+    rt_list_insert_before(list, &req->list);
+    rt_exit_critical();
+}
+
+static rt_err_t sched_acquire(int cls, rt_tick_t submit, rt_int32_t timeout)
+{
+    struct mb_sched_waiter waiter;
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(cls >= 0 && cls < MB_SCHED_CLASS_NUM);
+
+    waiter.thread = rt_thread_self();
+    waiter.req.submit = submit;
+    waiter.req.cls = cls;
+    waiter.granted = 0;
+
+    rt_enter_critical();
+    if (owner == RT_NULL)
+    {
+        sched_grant(waiter.thread, cls, submit);
+        rt_exit_critical();
+        return RT_EOK;
+    }
+    if (timeout == 0)
+    {
+        mb_sched_stats[cls].timeouts++;
+        rt_exit_critical();
+        return -RT_ETIMEOUT;
+    }
+    rt_sem_init(&waiter.sem, "mb_sched", 0, RT_IPC_FLAG_PRIO);
+    rt_list_insert_before(&waiters, &waiter.req.list);
+    rt_exit_critical();
+
+    rt_sem_take(&waiter.sem, timeout);
+
+    rt_enter_critical();
+    /* the turn may come between the timeout and here */
+    if (!waiter.granted)
+    {
+        rt_list_remove(&waiter.req.list);
+        mb_sched_stats[cls].timeouts++;
+        result = -RT_ETIMEOUT;
+    }
+    rt_exit_critical();
+
+    rt_sem_detach(&waiter.sem);
+    return result;
+}
+
+/**
+ * mb_sched_acquire - Wait for the turn of the caller on the bus
+ * @cls: enum mb_sched_class
+ * @timeout: the ticks to wait, RT_WAITING_FOREVER to wait until the turn
+ *
+ * The eMBMasterReq* calls go between mb_sched_acquire and mb_sched_release.
+ *
+ * Return: RT_EOK with the bus, -RT_ETIMEOUT without
+ */
+rt_err_t mb_sched_acquire(int cls, rt_int32_t timeout)
+{
+    return sched_acquire(cls, rt_tick_get(), timeout);
+}
+
+/**
+ * mb_sched_submit - Queue a request for the bus
+ * @req: the request, in the queue until mb_sched_next gives it
+ * @cls: enum mb_sched_class
+ */
+void mb_sched_submit(struct mb_sched_req *req, int cls)
+{
+    sched_submit(&queued, req, cls, rt_tick_get());
+}
+
+/**
+ * mb_sched_next - Take the queued request to run next
+ *
+ * The best class goes first, a class up for each MB_SCHED_AGING_MS queued.
+ *
+ * Return: the request, RT_NULL with the queue empty
+ */
+struct mb_sched_req *mb_sched_next(void)
+{
+    return sched_take(&queued);
+}
+
+/**
+ * mb_sched_acquire_req - Wait for the turn of a request taken by mb_sched_next
+ * @req: the request, its wait counts from mb_sched_submit
+ * @timeout: the ticks to wait, RT_WAITING_FOREVER to wait until the turn
+ *
+ * Return: RT_EOK with the bus, -RT_ETIMEOUT without
+ */
+rt_err_t mb_sched_acquire_req(struct mb_sched_req *req, rt_int32_t timeout)
+{
+    return sched_acquire(req->cls, req->submit, timeout);
+}
+
+/**
+ * mb_sched_release - End the turn of the caller, the next waiter starts at once
+ */
+void mb_sched_release(void)
+{
+    struct mb_sched_waiter *next;
+    struct mb_sched_req *req;
+    rt_uint32_t used;
+
+    rt_enter_critical();
+    RT_ASSERT(owner == rt_thread_self());
+
+    if (owner->current_priority != owner_priority)
+    {
+        rt_thread_control(owner, RT_THREAD_CTRL_CHANGE_PRIORITY, &owner_priority);
+    }
+    used = sched_ms(rt_tick_get() - owner_tick);
+    mb_sched_stats[owner_cls].bus_sum += used;
+    if (used > mb_sched_stats[owner_cls].bus_max)
+    {
+        mb_sched_stats[owner_cls].bus_max = used;
+    }
+    owner = RT_NULL;
+
+    req = sched_pick(&waiters);
+    if (req != RT_NULL)
+    {
+        next = rt_container_of(req, struct mb_sched_waiter, req);
+        rt_list_remove(&req->list);
+        next->granted = 1;
+        sched_grant(next->thread, req->cls, req->submit);
+        rt_sem_release(&next->sem);
+    }
+    /* switches to the next owner, boosted over the caller */
+    rt_exit_critical();
+}
+
+static int mb_sched(int argc, char **argv)
+{
+    struct mb_sched_stat copy[MB_SCHED_CLASS_NUM];
+    int index, waiting, waiting_req;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "-r"))
+    {
+        rt_enter_critical();
+        rt_memset(mb_sched_stats, 0, sizeof(mb_sched_stats));
+        rt_exit_critical();
+        return 0;
+    }
+    else if (argc > 1)
+    {
+        rt_kprintf("Usage: mb_sched [-r]\r\n");
+        return -1;
+    }
+
+    rt_enter_critical();
+    rt_memcpy(copy, mb_sched_stats, sizeof(mb_sched_stats));
+    waiting = rt_list_len(&waiters);
+    waiting_req = rt_list_len(&queued);
+    rt_exit_critical();
+
+    rt_kprintf("class       count  timeout  wait avg  wait max   bus avg   bus max (ms)\r\n");
+    for (index = 0; index < MB_SCHED_CLASS_NUM; index++)
+    {
+        rt_uint32_t count = copy[index].count ? copy[index].count : 1;
+
+        rt_kprintf("%-8s %8d %8d %9d %9d %9d %9d\r\n", class_name[index], copy[index].count, copy[index].timeouts,
+                   copy[index].wait_sum / count, copy[index].wait_max, copy[index].bus_sum / count, copy[index].bus_max);
+    }
+    rt_kprintf("waiting: %d, queued: %d\r\n", waiting, waiting_req);
+    return 0;
+}
+MSH_CMD_EXPORT(mb_sched, show the bus latency of the modbus transaction classes);
+
+/* The order the queue gives to the polls and a backfill queued before a control write */
+static int mb_sched_bench(int argc, char **argv)
+{
+    static const rt_uint8_t submit_cls[] = {MB_SCHED_POLL, MB_SCHED_POLL, MB_SCHED_POLL, MB_SCHED_BULK,
+                                            MB_SCHED_POLL, MB_SCHED_POLL, MB_SCHED_CONTROL};
+    struct mb_sched_req req[sizeof(submit_cls)];
+    rt_list_t list = RT_LIST_OBJECT_INIT(list);
+    struct mb_sched_req *next;
+    rt_tick_t now = rt_tick_get(), submit;
+    int round, index;
+
+    for (round = 0; round < 2; round++)
+    {
+        /* the second round the backfill waited long enough to go up to the control class */
+        for (index = 0; index < sizeof(submit_cls); index++)
+        {
+            submit = now;
+            if (round == 1 && submit_cls[index] == MB_SCHED_BULK)
+            {
+                submit -= rt_tick_from_millisecond((MB_SCHED_BULK + 1) * MB_SCHED_AGING_MS);
+            }
+            sched_submit(&list, &req[index], submit_cls[index], submit);
+        }
+
+        rt_kprintf(round == 0 ? "queued:" : "queued, bulk %d ms before:", (MB_SCHED_BULK + 1) * MB_SCHED_AGING_MS);
+        for (index = 0; index < sizeof(submit_cls); index++)
+        {
+            rt_kprintf(" %s#%d", class_name[submit_cls[index]], index);
+        }
+        rt_kprintf("\r\ntaken: ");
+        while ((next = sched_take(&list)) != RT_NULL)
+        {
+            rt_kprintf(" %s#%d", class_name[next->cls], (int)(next - req));
+        }
+        rt_kprintf("\r\n");
+    }
+    return 0;
+}
+MSH_CMD_EXPORT(mb_sched_bench, show the order the queued modbus requests take the bus);
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ * 2026-10-19     RT-Thread    queue the requests of a thread by class
+ */
+#ifndef APPLICATIONS_MB_SCHED_H_
+#define APPLICATIONS_MB_SCHED_H_
+
+#include <rtthread.h>
+
+#define MB_SCHED_AGING_MS       500     // The wait worth one class up
+#define MB_SCHED_BUS_PRIORITY   10      // The thread priority while a thread owns the bus
+
+/* the transaction classes, the first goes first */
+enum mb_sched_class
+{
+    MB_SCHED_CONTROL = 0,       // the write commands of the cloud
+    MB_SCHED_ALARM,             // the alarm reads
+    MB_SCHED_POLL,              // the periodic polls and the reads of the cloud
+    MB_SCHED_BULK,              // the bulk backfill
+    MB_SCHED_CLASS_NUM
+};
+
+/* a request queued for the bus, the head of the struct of the caller */
+struct mb_sched_req
+{
+    rt_list_t list;
+    rt_tick_t submit;
+    rt_uint8_t cls;
+};
+
+rt_err_t mb_sched_acquire(int cls, rt_int32_t timeout);
+void mb_sched_release(void);
+
+void mb_sched_submit(struct mb_sched_req *req, int cls);
+struct mb_sched_req *mb_sched_next(void);
+rt_err_t mb_sched_acquire_req(struct mb_sched_req *req, rt_int32_t timeout);
+
+#endif /* APPLICATIONS_MB_SCHED_H_ */
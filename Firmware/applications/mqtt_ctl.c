@@ -6,8 +6,17 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-04-29     David       the first version
+ * 2026-10-19     RT-Thread    fast boot with the RDY URC and the cached configuration
+ * 2026-10-19     RT-Thread    queue the downlink messages, read the modem buffers in one batch
+ * 2026-10-19     RT-Thread    run the slow URC functions on the AT URC worker
+ * 2026-10-19     RT-Thread    stamp the downlink messages and the publish acks for the request trace
+ * 2026-10-19     RT-Thread    keep AT+QMTRECV out of the two phases of a publish
+ * 2026-10-19     RT-Thread    keep the configuration hash page out of the FAL partitions
+ * 2026-10-19     RT-Thread    publish the latency telemetry on its own topic
  */
 #include "mqtt_ctl.h"
+#include "req_trace.h"
+#include <rthw.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -16,10 +25,40 @@
 #define DBG_LVL DBG_LOG
 #include <rtdbg.h>
 
+#ifdef BSP_USING_ON_CHIP_FLASH
+#include <board.h>
+#include <drv_flash.h>
+#ifdef RT_USING_FAL
+#include <fal.h>
+#endif
+#endif
+
 #define MQTT_BUFFER_SIZE 256
 #define MQTT_RESP_SIZE 256
 #define MQTT_RESP_TIMEOUT 2000
 
+#define MQTT_RDY_PROBE_MS 500       // Probe with AT when no RDY comes in this time
+#define MQTT_URC_POLL_MS 10
+#define MQTT_CONN_TIMEOUT 30000     // Longer than the packet retries of the modem
+
+#define MQTT_RECV_LINE_SIZE 512     // AT client line, a +QMTRECV line holds the topic and the payload
+#define MQTT_RECV_QUEUE_SIZE 1024   // Downlink queue bytes
+#define MQTT_RECV_QUEUE_SLOTS 8     // Downlink queue messages
+#define MQTT_RECV_RESP_SIZE 64      // The messages come as URC lines, the response is only OK
+#define MQTT_RECV_BATCH_MS 20       // Let the buffer notifications of a burst come before the read
+
+#define MQTT_CFG_ALIAUTH "a1mRa3t2xvm,dev_1,92664c8f6a77a8e52d35866dcf4d6737"
+
+#define MQTT_TOPIC_UPDATE "/a1mRa3t2xvm/dev_1/user/update"          // The replies of the commands
+#define MQTT_TOPIC_TELEMETRY "/a1mRa3t2xvm/dev_1/user/telemetry"    // The latency telemetry
+
+/* The hash of the configuration applied to the modem, kept in the last flash page, the image must end before it */
+#define MQTT_CFG_MAGIC 0x4643514D   // "MQCF"
+#ifdef BSP_USING_ON_CHIP_FLASH
+#define MQTT_CFG_HASH_ADDR (STM32_FLASH_END_ADDRESS - FLASH_PAGE_SIZE)
+#define MQTT_CFG_FLASH_NAME "onchip_flash"  // The FAL device of drv_flash_f1.c
+#endif
+
 static int min(int a, int b);
 
 static int mqtt_ctl_cfg(mqtt_ctl_t handler);
@@ -30,6 +69,7 @@ static int mqtt_ctl_disconn(mqtt_ctl_t handler);
 static int mqtt_ctl_sub(mqtt_ctl_t handler);
 static int mqtt_ctl_unsub(mqtt_ctl_t handler);
 static int mqtt_ctl_pubex(mqtt_ctl_t handler, const char *buf, int buf_size);
+static int mqtt_ctl_pubtel(mqtt_ctl_t handler, const char *buf, int buf_size);
 
 static void ready_func(struct at_client *client, const char *data, rt_size_t size);
 static void urc_stat_func(struct at_client *client, const char *data, rt_size_t size);
@@ -43,24 +83,220 @@ static void urc_pubex_func(struct at_client *client, const char *data, rt_size_t
 static void urc_recv_func(struct at_client *client, const char *data, rt_size_t size);
 static int mqtt_urc_init(void);
 
+/*
+ * The functions logging and parsing run on the URC worker. +QMTRECV only
+ * copies the message to the queue and +QMTPUBEX stamps the request trace.
+ */
 static struct at_urc urc_table[] = {
-    {"RDY", "\r\n", ready_func},
-    {"+QMTSTAT", "\r\n", urc_stat_func},
-    {"+QMTCLOSE", "\r\n", urc_close_func},
-    {"+QMTDISC", "\r\n", urc_disc_func},
-    {"+QMTSUB", "\r\n", urc_sub_func},
-    {"+QMTUNS", "\r\n", urc_uns_func},
-    {"+QMTPUBEX", "\r\n", urc_pubex_func},
-    {"+QMTRECV", "\r\n", urc_recv_func},
-
-    {"+QMTOPEN", "\r\n", urc_open_func},
-    {"+QMTCONN", "\r\n", urc_conn_func},
+    {"RDY", "\r\n", ready_func, AT_URC_FLAG_DEFER},
+    {"+QMTSTAT", "\r\n", urc_stat_func, AT_URC_FLAG_DEFER},
+    {"+QMTCLOSE", "\r\n", urc_close_func, AT_URC_FLAG_DEFER},
+    {"+QMTDISC", "\r\n", urc_disc_func, AT_URC_FLAG_DEFER},
+    {"+QMTSUB", "\r\n", urc_sub_func, AT_URC_FLAG_DEFER},
+    {"+QMTUNS", "\r\n", urc_uns_func, AT_URC_FLAG_DEFER},
+    {"+QMTPUBEX", "\r\n", urc_pubex_func, 0},
+    {"+QMTRECV", "\r\n", urc_recv_func, 0},
+
+    {"+QMTOPEN", "\r\n", urc_open_func, AT_URC_FLAG_DEFER},
+    {"+QMTCONN", "\r\n", urc_conn_func, AT_URC_FLAG_DEFER},
 };
 
 extern mqtt_ctl_t my_handler;
-extern char msg_buf[256];
 extern rt_sem_t recv_sem;
 
+/* RDY may come before my_handler is set */
+static struct rt_semaphore rdy_sem;
+static rt_uint8_t rdy_sem_inited = 0;
+
+static rt_uint32_t mqtt_cfg_saved_hash;     // Lost on reset without the on-chip flash page
+#ifdef MQTT_CFG_HASH_ADDR
+static rt_uint8_t mqtt_cfg_in_flash = 0;    // The page is out of the FAL partitions
+#endif
+
+static void mqtt_ctl_stamp(mqtt_ctl_t handler, int stage)
+{
+    if (handler->boot_tick[stage] == 0)
+    {
+        rt_tick_t tick = rt_tick_get();
+        handler->boot_tick[stage] = tick ? tick : 1;
+    }
+}
+
+/* FNV-1a of the settings the modem keeps */
+static rt_uint32_t mqtt_cfg_hash(void)
+{
+    const char *p = MQTT_CFG_ALIAUTH;
+    rt_uint32_t hash = 2166136261UL;
+
+    while (*p)
+    {
+        hash ^= (rt_uint8_t)*p++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+#ifdef MQTT_CFG_HASH_ADDR
+/* Erasing the page must not break a FAL partition of the on-chip flash */
+static rt_bool_t mqtt_cfg_page_free(void)
+{
+#ifdef RT_USING_FAL
+    const struct fal_partition *part;
+    const struct fal_flash_dev *flash;
+    rt_uint32_t start;
+    size_t num, i;
+
+    if (fal_init_check() != 1)
+    {
+        fal_init();
+    }
+    if (fal_init_check() != 1)
+    {
+        return RT_TRUE;
+    }
+
+    part = fal_get_partition_table(&num);
+    for (i = 0; i < num; i++)
+    {
+        if (rt_strcmp(part[i].flash_name, MQTT_CFG_FLASH_NAME) != 0)
+        {
+            continue;
+        }
+        flash = fal_flash_device_find(part[i].flash_name);
+        if (flash == RT_NULL)
+        {
+            continue;
+        }
+        start = flash->addr + part[i].offset;
+        if (MQTT_CFG_HASH_ADDR < start + part[i].len && MQTT_CFG_HASH_ADDR + FLASH_PAGE_SIZE > start)
+        {
+            LOG_E("The configuration hash page 0x%08x is in the partition %s.", MQTT_CFG_HASH_ADDR, part[i].name);
+            return RT_FALSE;
+        }
+    }
+#endif /* RT_USING_FAL */
+    return RT_TRUE;
+}
+#endif /* MQTT_CFG_HASH_ADDR */
+
+static rt_uint32_t mqtt_cfg_hash_load(void)
+{
+#ifdef MQTT_CFG_HASH_ADDR
+    rt_uint32_t rec[2];
+
+    if (!mqtt_cfg_in_flash)
+    {
+        return mqtt_cfg_saved_hash;
+    }
+    if (stm32_flash_read(MQTT_CFG_HASH_ADDR, (rt_uint8_t *)rec, sizeof(rec)) != sizeof(rec) || rec[0] != MQTT_CFG_MAGIC)
+    {
+        return 0;
+    }
+    return rec[1];
+#else
+    return mqtt_cfg_saved_hash;
+#endif
+}
+
+/* 0 forgets the configuration, the next boot applies it again */
+static void mqtt_cfg_hash_store(rt_uint32_t hash)
+{
+    if (mqtt_cfg_hash_load() == hash)
+    {
+        return;
+    }
+    mqtt_cfg_saved_hash = hash;
+#ifdef MQTT_CFG_HASH_ADDR
+    rt_uint32_t rec[2] = {MQTT_CFG_MAGIC, hash};
+
+    if (!mqtt_cfg_in_flash)
+    {
+        return;
+    }
+    stm32_flash_erase(MQTT_CFG_HASH_ADDR, FLASH_PAGE_SIZE);
+    if (hash != 0 && stm32_flash_write(MQTT_CFG_HASH_ADDR, (const rt_uint8_t *)rec, sizeof(rec)) != sizeof(rec))
+    {
+        LOG_W("Failed to save the configuration hash.");
+    }
+#endif
+}
+
+/*
+ * The message is copied behind the time it came, send_thread_entry parses it
+ * when recv_sem is released.
+ */
+static void mqtt_recv_push(mqtt_ctl_t handler, const char *payload, int len)
+{
+    rt_uint32_t recv_time = req_trace_now();
+    rt_rbb_blk_t blk;
+    rt_base_t level;
+
+    blk = rt_rbb_blk_alloc(handler->recv_rbb, sizeof(recv_time) + len + 1);
+    if (blk == RT_NULL)
+    {
+        handler->recv_dropped++;
+        LOG_W("Receive queue full, a message of %d bytes dropped.", len);
+        return;
+    }
+    rt_memcpy(blk->buf, &recv_time, sizeof(recv_time));
+    rt_memcpy(blk->buf + sizeof(recv_time), payload, len);
+    blk->buf[sizeof(recv_time) + len] = '\0';
+    rt_rbb_blk_put(blk);
+
+    level = rt_hw_interrupt_disable();
+    handler->recv_count++;
+    handler->recv_depth++;
+    if (handler->recv_depth > handler->recv_depth_max)
+    {
+        handler->recv_depth_max = handler->recv_depth;
+    }
+    rt_hw_interrupt_enable(level);
+
+    rt_sem_release(recv_sem);
+}
+
+/* +QMTRECV: <client_idx>,<msgid>,"<topic>"[,<payload_len>],"<payload>" */
+static int mqtt_recv_payload(const char *line, const char **payload)
+{
+    const char *p = strchr(line, '"');
+    const char *end;
+    char *num_end;
+    long len;
+
+    if (p == NULL || (p = strchr(p + 1, '"')) == NULL || p[1] != ',')
+    {
+        return -1;
+    }
+    p += 2;
+
+    if (*p != '"')
+    {
+        len = strtol(p, &num_end, 10);
+        if (*num_end != ',' || num_end[1] != '"')
+        {
+            return -1;
+        }
+        p = num_end + 2;
+        if (len >= 0 && len <= (long)rt_strlen(p))
+        {
+            *payload = p;
+            return (int)len;
+        }
+    }
+    else
+    {
+        p++;
+    }
+
+    end = strrchr(p, '"');
+    if (end == NULL)
+    {
+        return -1;
+    }
+    *payload = p;
+    return end - p;
+}
+
 mqtt_ctl_t mqtt_ctl_create(void)
 {
     mqtt_ctl_t handler = (mqtt_ctl_t)rt_malloc(sizeof(struct mqtt_ctl));
@@ -73,8 +309,18 @@ mqtt_ctl_t mqtt_ctl_create(void)
 
     rt_memset(handler, 0, sizeof(struct mqtt_ctl));
 
+    if (!rdy_sem_inited)
+    {
+        rt_sem_init(&rdy_sem, "mq_rdy", 0, RT_IPC_FLAG_PRIO);
+        rdy_sem_inited = 1;
+#ifdef MQTT_CFG_HASH_ADDR
+        /* Kept in RAM when the page is taken */
+        mqtt_cfg_in_flash = mqtt_cfg_page_free();
+#endif
+    }
+
     const char *uart_name = "uart2";
-    if (at_client_init(uart_name, MQTT_BUFFER_SIZE) != 0)
+    if (at_client_init(uart_name, MQTT_RECV_LINE_SIZE) != 0)
     {
         LOG_E("AT client initialization failed.");
         goto error;
@@ -95,6 +341,17 @@ mqtt_ctl_t mqtt_ctl_create(void)
         goto error;
     }
 
+    handler->recv_rbb = rt_rbb_create(MQTT_RECV_QUEUE_SIZE, MQTT_RECV_QUEUE_SLOTS);
+    handler->recv_resp = at_create_resp(MQTT_RECV_RESP_SIZE, 0, MQTT_RESP_TIMEOUT);
+    handler->fetch_sem = rt_sem_create("mq_fet", 0, RT_IPC_FLAG_PRIO);
+    handler->cmd_lock = rt_mutex_create("mq_cmd", RT_IPC_FLAG_PRIO);
+    if (handler->recv_rbb == NULL || handler->recv_resp == NULL || handler->fetch_sem == NULL ||
+        handler->cmd_lock == NULL)
+    {
+        LOG_E("Failed to create the MQTT receive queue.");
+        goto error;
+    }
+
     handler->cfg = mqtt_ctl_cfg;
     handler->open = mqtt_ctl_open;
     handler->close = mqtt_ctl_close;
@@ -103,6 +360,7 @@ mqtt_ctl_t mqtt_ctl_create(void)
     handler->sub = mqtt_ctl_sub;
     handler->unsub = mqtt_ctl_unsub;
     handler->pubex = mqtt_ctl_pubex;
+    handler->pubtel = mqtt_ctl_pubtel;
 
     mqtt_urc_init();
 
@@ -115,6 +373,11 @@ error:
 
 void mqtt_ctl_delete(mqtt_ctl_t handler)
 {
+    if (handler == NULL)
+    {
+        return;
+    }
+
     if (handler->buf)
     {
         rt_free(handler->buf);
@@ -125,6 +388,26 @@ void mqtt_ctl_delete(mqtt_ctl_t handler)
         at_delete_resp(handler->mqtt_resp);
     }
 
+    if (handler->recv_resp)
+    {
+        at_delete_resp(handler->recv_resp);
+    }
+
+    if (handler->recv_rbb)
+    {
+        rt_rbb_destroy(handler->recv_rbb);
+    }
+
+    if (handler->fetch_sem)
+    {
+        rt_sem_delete(handler->fetch_sem);
+    }
+
+    if (handler->cmd_lock)
+    {
+        rt_mutex_delete(handler->cmd_lock);
+    }
+
     rt_free(handler);
 }
 
@@ -143,7 +426,7 @@ int mqtt_ctl_init(mqtt_ctl_t handler)
     }
 
     const char *uart_name = "uart2";
-    if (at_client_init(uart_name, MQTT_BUFFER_SIZE) != 0)
+    if (at_client_init(uart_name, MQTT_RECV_LINE_SIZE) != 0)
     {
         LOG_E("AT client initialization failed.");
         goto error;
@@ -209,32 +492,68 @@ void mqtt_ctl_deinit(mqtt_ctl_t handler)
     }
 }
 
+/**
+ * mqtt_ctl_wait_rdy - Wait until the modem is ready
+ * @handler: mqtt_ctl_t handler instance
+ *
+ * The modem reports RDY when it has booted. When the RDY came before the AT
+ * client started, the modem is up already and one answered AT is enough.
+ */
 void mqtt_ctl_wait_rdy(mqtt_ctl_t handler)
 {
-    int count = 0;
     while (!handler->is_rdy)
     {
-        int res = at_exec_cmd(handler->mqtt_resp, "AT");
-        if (res == 0)
+        if (rt_sem_take(&rdy_sem, rt_tick_from_millisecond(MQTT_RDY_PROBE_MS)) == RT_EOK)
         {
-            const char *resp_line = at_resp_get_line(handler->mqtt_resp, 2);
-            if (!rt_strncmp(resp_line, "OK", rt_strlen("OK")))
-            {
-                count++;
-            }
+            handler->is_rdy = 1;
+            handler->is_fresh = 1;
+            break;
         }
-        if (count == 5)
+
+        if (at_exec_cmd(handler->mqtt_resp, "AT") == 0 && at_resp_get_line_by_kw(handler->mqtt_resp, "OK"))
         {
             handler->is_rdy = 1;
         }
-        rt_thread_delay(500);
+    }
+
+    mqtt_ctl_stamp(handler, MQTT_BOOT_RDY);
+    LOG_I("Modem ready%s.", handler->is_fresh ? " after boot" : "");
+}
+
+/* The modem keeps the messages in its buffers and reports the buffer only, then AT+QMTRECV reads them all */
+static void mqtt_ctl_recv_mode(mqtt_ctl_t handler)
+{
+    const char *mqtt_recv_mode_set = "AT+QMTCFG=\"recv/mode\",0,1,1";
+
+    handler->recv_buffered = 0;
+    if (at_exec_cmd(handler->mqtt_resp, mqtt_recv_mode_set) == 0 && at_resp_get_line_by_kw(handler->mqtt_resp, "OK"))
+    {
+        handler->recv_buffered = 1;
+    }
+    else
+    {
+        LOG_W("No buffered receive mode, the messages come with the URC.");
     }
 }
 
 static int mqtt_ctl_cfg(mqtt_ctl_t handler)
 {
     const char *mqtt_cfg_query = "AT+QMTCFG=\"aliauth\",0";
-    const char *mqtt_cfg_set = "a1mRa3t2xvm,dev_1,92664c8f6a77a8e52d35866dcf4d6737";
+    const char *mqtt_cfg_set = MQTT_CFG_ALIAUTH;
+    rt_uint32_t hash = mqtt_cfg_hash();
+
+    /* Not kept by the modem over a reset, set before AT+QMTOPEN */
+    mqtt_ctl_recv_mode(handler);
+
+    /* The modem keeps the configuration, it is the same as the last applied one */
+    if (mqtt_cfg_hash_load() == hash)
+    {
+        handler->is_cfg = 1;
+        handler->cfg_skipped = 1;
+        mqtt_ctl_stamp(handler, MQTT_BOOT_CFG);
+        return 0;
+    }
+    handler->cfg_skipped = 0;
 
     rt_snprintf(handler->buf, handler->buf_size, "%s", mqtt_cfg_query);
 
@@ -251,6 +570,8 @@ static int mqtt_ctl_cfg(mqtt_ctl_t handler)
 
     if (handler->is_cfg == 1)
     {
+        mqtt_cfg_hash_store(hash);
+        mqtt_ctl_stamp(handler, MQTT_BOOT_CFG);
         return 0;
     }
 
@@ -262,6 +583,9 @@ static int mqtt_ctl_cfg(mqtt_ctl_t handler)
         rt_kprintf("resp_line: %s\r\n", resp_line);
         if (!rt_strncmp(resp_line, "OK", rt_strlen("OK")))
         {
+            handler->is_cfg = 1;
+            mqtt_cfg_hash_store(hash);
+            mqtt_ctl_stamp(handler, MQTT_BOOT_CFG);
             return 0;
         }
     }
@@ -273,10 +597,17 @@ static int mqtt_ctl_open(mqtt_ctl_t handler)
 {
     const char *mqtt_open_query = "AT+QMTOPEN";
     const char *mqtt_open_set = "0,a1mRa3t2xvm.iot-as-mqtt.cn-shanghai.aliyuncs.com,1883";
+    int res;
+
+    /* A modem just booted has no network open */
+    if (handler->is_fresh)
+    {
+        goto __open;
+    }
 
     rt_snprintf(handler->buf, handler->buf_size, "%s?", mqtt_open_query);
 
-    int res = at_exec_cmd(handler->mqtt_resp, handler->buf);
+    res = at_exec_cmd(handler->mqtt_resp, handler->buf);
     if (res == 0)
     {
         const char *resp_line = at_resp_get_line(handler->mqtt_resp, 2);
@@ -294,9 +625,11 @@ static int mqtt_ctl_open(mqtt_ctl_t handler)
 
     if (handler->is_open)
     {
+        mqtt_ctl_stamp(handler, MQTT_BOOT_OPEN);
         return 0;
     }
 
+__open:
     rt_snprintf(handler->buf, handler->buf_size, "%s=%s", mqtt_open_query, mqtt_open_set);
     res = at_exec_cmd(handler->mqtt_resp, handler->buf);
     if (res == 0)
@@ -329,10 +662,18 @@ static int mqtt_ctl_conn(mqtt_ctl_t handler)
     const char *mqtt_conn_set =
         "0,a1mRa3t2xvm.dev_1,dev_1&a1mRa3t2xvm,2917e1b3dc0311553579238cb78840fbb53f4bfbf188b713558a98f18f271556";
 
+    int res, wait;
+
+    /* A modem just booted has no connection */
+    if (handler->is_fresh)
+    {
+        goto __conn;
+    }
+
     rt_snprintf(handler->buf, handler->buf_size, "%s?", mqtt_conn_query);
 
     handler->waiting_conn_urc = 1;
-    int res = at_exec_cmd(handler->mqtt_resp, handler->buf);
+    res = at_exec_cmd(handler->mqtt_resp, handler->buf);
     if (res != 0)
     {
         handler->waiting_conn_urc = 0;
@@ -345,19 +686,47 @@ static int mqtt_ctl_conn(mqtt_ctl_t handler)
 
     if (handler->is_conn)
     {
+        mqtt_ctl_stamp(handler, MQTT_BOOT_CONN);
         return 0;
     }
 
+__conn:
     rt_snprintf(handler->buf, handler->buf_size, "%s=%s", mqtt_conn_query, mqtt_conn_set);
 
+    handler->conn_failed = 0;
     res = at_exec_cmd(handler->mqtt_resp, handler->buf);
-    if (res == 0)
+    if (res != 0 || rt_strncmp(at_resp_get_line(handler->mqtt_resp, 2), "OK", rt_strlen("OK")) != 0)
     {
-        const char *resp_line = at_resp_get_line(handler->mqtt_resp, 2);
-        return rt_strncmp(resp_line, "OK", rt_strlen("OK")) == 0 ? 0 : -1;
+        return -1;
     }
 
-    return -1;
+    /* The result comes with the +QMTCONN URC */
+    for (wait = 0; !handler->is_conn && !handler->conn_failed && wait < MQTT_CONN_TIMEOUT; wait += MQTT_URC_POLL_MS)
+    {
+        rt_thread_mdelay(MQTT_URC_POLL_MS);
+    }
+
+    if (handler->conn_failed)
+    {
+        if (!handler->cfg_skipped)
+        {
+            return -1;
+        }
+
+        /* The modem lost the cached configuration, apply it and try once more */
+        LOG_W("Connection refused with the cached configuration, apply it again.");
+        mqtt_cfg_hash_store(0);
+        handler->is_cfg = 0;
+        handler->boot_tick[MQTT_BOOT_CFG] = 0;
+        if (mqtt_ctl_cfg(handler) != 0)
+        {
+            return -1;
+        }
+        return mqtt_ctl_conn(handler);
+    }
+
+    /* No result yet, the caller goes on waiting for is_conn */
+    return 0;
 }
 
 static int mqtt_ctl_disconn(mqtt_ctl_t handler)
@@ -383,7 +752,11 @@ static int mqtt_ctl_sub(mqtt_ctl_t handler)
     if (res == 0)
     {
         const char *resp_line = at_resp_get_line(handler->mqtt_resp, 2);
-        return rt_strncmp(resp_line, "OK", rt_strlen("OK")) == 0 ? 0 : -1;
+        if (rt_strncmp(resp_line, "OK", rt_strlen("OK")) == 0)
+        {
+            mqtt_ctl_stamp(handler, MQTT_BOOT_SUB);
+            return 0;
+        }
     }
     return -1;
 }
@@ -402,11 +775,15 @@ static int mqtt_ctl_unsub(mqtt_ctl_t handler)
     return -1;
 }
 
-static int mqtt_ctl_pubex(mqtt_ctl_t handler, const char *buf, int buf_size)
+/* QoS 1 for a nonzero msgid, the +QMTPUBEX of it comes with the PUBACK */
+static int mqtt_ctl_publish(mqtt_ctl_t handler, const char *topic, uint16_t msgid, int retain,
+                            const char *buf, int buf_size)
 {
-    const char *mqtt_pub_cmd = "AT+QMTPUBEX=0,0,0,1,/a1mRa3t2xvm/dev_1/user/update,";
+    rt_snprintf(handler->buf, handler->buf_size, "AT+QMTPUBEX=0,%d,%d,%d,%s,%d",
+                msgid, msgid ? 1 : 0, retain, topic, buf_size);
 
-    rt_snprintf(handler->buf, handler->buf_size, "%s%d", mqtt_pub_cmd, buf_size);
+    /* the payload must follow the '>' prompt, no other command in between */
+    rt_mutex_take(handler->cmd_lock, RT_WAITING_FOREVER);
 
     at_resp_set_info(handler->mqtt_resp, MQTT_RESP_SIZE, 1, MQTT_RESP_TIMEOUT);
     int res = at_exec_cmd(handler->mqtt_resp, handler->buf);
@@ -417,14 +794,44 @@ static int mqtt_ctl_pubex(mqtt_ctl_t handler, const char *buf, int buf_size)
         if (res == 0)
         {
             const char *resp_line = at_resp_get_line(handler->mqtt_resp, 2);
-            return rt_strncmp(resp_line, "OK", rt_strlen("OK")) == 0 ? 0 : -1;
+            if (resp_line == NULL || rt_strncmp(resp_line, "OK", rt_strlen("OK")) != 0)
+            {
+                res = -1;
+            }
         }
         else
         {
-            return -1;
+            res = -1;
         }
     }
-    return -1;
+    else
+    {
+        res = -1;
+    }
+
+    rt_mutex_release(handler->cmd_lock);
+
+    if (res == 0 && handler->boot_tick[MQTT_BOOT_PUB] == 0)
+    {
+        mqtt_ctl_stamp(handler, MQTT_BOOT_PUB);
+        LOG_I("First publish %d ms after boot.", mqtt_ctl_boot_time(handler));
+    }
+    return res;
+}
+
+/* Each reply has a msgid of its own, the +QMTPUBEX carrying it is the ack of the request */
+static int mqtt_ctl_pubex(mqtt_ctl_t handler, const char *buf, int buf_size)
+{
+    handler->pub_msgid = handler->pub_msgid == 0xFFFF ? 1 : handler->pub_msgid + 1;
+    /* set before the publish, the URC may come before the command returns */
+    req_trace_msgid(handler->pub_msgid);
+    return mqtt_ctl_publish(handler, MQTT_TOPIC_UPDATE, handler->pub_msgid, 1, buf, buf_size);
+}
+
+/* The telemetry goes with QoS 0 and msgid 0, no request trace has that msgid */
+static int mqtt_ctl_pubtel(mqtt_ctl_t handler, const char *buf, int buf_size)
+{
+    return mqtt_ctl_publish(handler, MQTT_TOPIC_TELEMETRY, 0, 0, buf, buf_size);
 }
 
 static int mqtt_urc_init(void)
@@ -436,7 +843,12 @@ static int mqtt_urc_init(void)
 static void ready_func(struct at_client *client, const char *data, rt_size_t size)
 {
     LOG_D("ready_func");
-    my_handler->is_rdy = 1;
+    if (my_handler)
+    {
+        my_handler->is_rdy = 1;
+        my_handler->is_fresh = 1;
+    }
+    rt_sem_release(&rdy_sem);
 }
 
 static void urc_stat_func(struct at_client *client, const char *data, rt_size_t size)
@@ -448,6 +860,7 @@ static void urc_open_func(struct at_client *client, const char *data, rt_size_t
 {
     LOG_D("urc_open_func");
     my_handler->is_open = 1;
+    mqtt_ctl_stamp(my_handler, MQTT_BOOT_OPEN);
 }
 
 static void urc_close_func(struct at_client *client, const char *data, rt_size_t size)
@@ -472,7 +885,20 @@ static void urc_conn_func(struct at_client *client, const char *data, rt_size_t
     }
     else
     {
-        my_handler->is_conn = 1;
+        int result = 0, ret_code = 0;
+
+        /* +QMTCONN: <client_idx>,<result>[,<ret_code>] */
+        sscanf(data, "+QMTCONN: %*d,%d,%d", &result, &ret_code);
+        if (result == 0 && ret_code == 0)
+        {
+            my_handler->is_conn = 1;
+            mqtt_ctl_stamp(my_handler, MQTT_BOOT_CONN);
+        }
+        else
+        {
+            LOG_W("conn refused: result %d, ret_code %d", result, ret_code);
+            my_handler->conn_failed = 1;
+        }
     }
 }
 
@@ -493,25 +919,217 @@ static void urc_uns_func(struct at_client *client, const char *data, rt_size_t s
     my_handler->is_conn = 1;
 }
 
+/* +QMTPUBEX: <client_idx>,<msgid>,<result>, on the parser thread to stamp the ack as it comes */
 static void urc_pubex_func(struct at_client *client, const char *data, rt_size_t size)
 {
-    LOG_D("urc_pubex_func");
+    int msgid = 0;
+    int result = 0;
+
+    if (sscanf(data, "+QMTPUBEX: %*d,%d,%d", &msgid, &result) != 2)
+    {
+        return;
+    }
+    /* 1 is a retransmission, the final result of the msgid is still to come */
+    if (result != 1)
+    {
+        req_trace_ack((rt_uint16_t)msgid, result);
+    }
 }
 
+/*
+ * The messages of the URC and the lines read by AT+QMTRECV, which the AT
+ * client also hands here, carry the payload. In the buffered receive mode
+ * the URC names only the buffer holding the message.
+ */
 static void urc_recv_func(struct at_client *client, const char *data, rt_size_t size)
 {
+    const char *payload;
+    int len, recv_id;
+    rt_base_t level;
+
     LOG_D("urc_recv_func");
     LOG_D("recv data: %s", data);
-    const char *msg_start = strchr(data, '{');
-    const char *msg_end = strrchr(data, '}');
-    if (msg_start && msg_end)
+    if (my_handler == NULL)
+    {
+        return;
+    }
+
+    len = mqtt_recv_payload(data, &payload);
+    if (len >= 0)
+    {
+        mqtt_recv_push(my_handler, payload, len);
+        return;
+    }
+
+    /* +QMTRECV: <client_idx>,<recv_id> */
+    if (sscanf(data, "+QMTRECV: %*d,%d", &recv_id) == 1 && recv_id >= 0 && recv_id < 8)
     {
-        rt_strncpy(msg_buf, msg_start, msg_end - msg_start + 1);
-        rt_kprintf("recv msg: %s\r\n", msg_buf);
-        rt_sem_release(recv_sem);
+        level = rt_hw_interrupt_disable();
+        my_handler->recv_pending |= 1 << recv_id;
+        rt_hw_interrupt_enable(level);
+        rt_sem_release(my_handler->fetch_sem);
     }
 }
 
 static int min(int a, int b) {
     return a < b ? a : b;
 }
+
+/**
+ * mqtt_ctl_recv_fetch - Read the messages waiting in the modem buffers
+ * @handler: mqtt_ctl_t handler instance
+ * @timeout: ticks to wait for a message
+ *
+ * The buffers filled by a burst are read with one AT+QMTRECV. A failed read
+ * is tried again at the next call.
+ *
+ * Return: the messages queued, -1 on a failed read
+ */
+int mqtt_ctl_recv_fetch(mqtt_ctl_t handler, rt_int32_t timeout)
+{
+    rt_uint32_t count = handler->recv_count;
+    rt_uint8_t pending;
+    rt_base_t level;
+    int res;
+
+    if (rt_sem_take(handler->fetch_sem, timeout) == RT_EOK)
+    {
+        rt_thread_mdelay(MQTT_RECV_BATCH_MS);
+        while (rt_sem_trytake(handler->fetch_sem) == RT_EOK)
+        {
+        }
+    }
+
+    level = rt_hw_interrupt_disable();
+    pending = handler->recv_pending;
+    handler->recv_pending = 0;
+    rt_hw_interrupt_enable(level);
+    if (pending == 0)
+    {
+        return 0;
+    }
+
+    handler->recv_fetches++;
+    rt_mutex_take(handler->cmd_lock, RT_WAITING_FOREVER);
+    res = at_exec_cmd(handler->recv_resp, "AT+QMTRECV=0");
+    rt_mutex_release(handler->cmd_lock);
+    if (res != 0)
+    {
+        level = rt_hw_interrupt_disable();
+        handler->recv_pending |= pending;
+        rt_hw_interrupt_enable(level);
+        return -1;
+    }
+
+    return handler->recv_count - count;
+}
+
+/**
+ * mqtt_ctl_recv_get - Take the oldest downlink message
+ * @handler: mqtt_ctl_t handler instance
+ * @len: the payload length, may be NULL
+ * @recv_time: req_trace_now when the message was queued, may be NULL
+ *
+ * The message stays in the queue, ended with '\0', until mqtt_ctl_recv_free.
+ *
+ * Return: the payload, NULL with the queue empty
+ */
+const char *mqtt_ctl_recv_get(mqtt_ctl_t handler, rt_size_t *len, rt_uint32_t *recv_time)
+{
+    mqtt_ctl_recv_free(handler);
+
+    handler->recv_blk = rt_rbb_blk_get(handler->recv_rbb);
+    if (handler->recv_blk == RT_NULL)
+    {
+        return NULL;
+    }
+
+    if (len)
+    {
+        *len = handler->recv_blk->size - sizeof(rt_uint32_t) - 1;
+    }
+    if (recv_time)
+    {
+        rt_memcpy(recv_time, handler->recv_blk->buf, sizeof(rt_uint32_t));
+    }
+    return (const char *)handler->recv_blk->buf + sizeof(rt_uint32_t);
+}
+
+/**
+ * mqtt_ctl_recv_free - Give back the message of mqtt_ctl_recv_get
+ * @handler: mqtt_ctl_t handler instance
+ */
+void mqtt_ctl_recv_free(mqtt_ctl_t handler)
+{
+    rt_base_t level;
+
+    if (handler->recv_blk == RT_NULL)
+    {
+        return;
+    }
+
+    rt_rbb_blk_free(handler->recv_rbb, handler->recv_blk);
+    handler->recv_blk = RT_NULL;
+
+    level = rt_hw_interrupt_disable();
+    handler->recv_depth--;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * mqtt_ctl_boot_time - Get the time from boot to the first publish
+ * @handler: mqtt_ctl_t handler instance
+ *
+ * Return: the milliseconds, -1 before the first publish
+ */
+int mqtt_ctl_boot_time(mqtt_ctl_t handler)
+{
+    if (handler == NULL || handler->boot_tick[MQTT_BOOT_PUB] == 0)
+    {
+        return -1;
+    }
+    return handler->boot_tick[MQTT_BOOT_PUB] * 1000 / RT_TICK_PER_SECOND;
+}
+
+static int mqtt_boot(int argc, char **argv)
+{
+    static const char *const stage_name[MQTT_BOOT_STAGE_NUM] = {"rdy", "cfg", "open", "conn", "sub", "pub"};
+    int stage;
+
+    if (my_handler == NULL)
+    {
+        rt_kprintf("mqtt_ctl is not running.\r\n");
+        return -1;
+    }
+
+    rt_kprintf("fresh modem: %d, cfg cached: %d\r\n", my_handler->is_fresh, my_handler->cfg_skipped);
+    for (stage = 0; stage < MQTT_BOOT_STAGE_NUM; stage++)
+    {
+        if (my_handler->boot_tick[stage])
+        {
+            rt_kprintf("%-5s %8d ms\r\n", stage_name[stage], my_handler->boot_tick[stage] * 1000 / RT_TICK_PER_SECOND);
+        }
+        else
+        {
+            rt_kprintf("%-5s %8s\r\n", stage_name[stage], "-");
+        }
+    }
+    return 0;
+}
+MSH_CMD_EXPORT(mqtt_boot, show the boot stages of mqtt_ctl);
+
+static int mqtt_recv(int argc, char **argv)
+{
+    if (my_handler == NULL)
+    {
+        rt_kprintf("mqtt_ctl is not running.\r\n");
+        return -1;
+    }
+
+    rt_kprintf("buffered mode: %d, reads: %d, pending buffers: 0x%02x\r\n", my_handler->recv_buffered,
+               my_handler->recv_fetches, my_handler->recv_pending);
+    rt_kprintf("queued: %d, dropped: %d, depth: %d, max depth: %d\r\n", my_handler->recv_count,
+               my_handler->recv_dropped, my_handler->recv_depth, my_handler->recv_depth_max);
+    return 0;
+}
+MSH_CMD_EXPORT(mqtt_recv, show the downlink queue of mqtt_ctl);
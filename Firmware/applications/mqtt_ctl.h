@@ -6,15 +6,32 @@
  * Change Logs:
  * Date           Author       Notes
  * 2023-04-29     David       the first version
+ * 2026-10-19     RT-Thread    fast boot with the RDY URC and the cached configuration
+ * 2026-10-19     RT-Thread    queue the downlink messages, read the modem buffers in one batch
+ * 2026-10-19     RT-Thread    stamp the downlink messages for the request trace
+ * 2026-10-19     RT-Thread    publish the telemetry on its own topic
  */
 #ifndef APPLICATIONS_MQTT_CTL_H_
 #define APPLICATIONS_MQTT_CTL_H_
 
 #include "at.h"
+#include <rtdevice.h>
 #include <stdint.h>
 
 typedef struct mqtt_ctl *mqtt_ctl_t;
 
+/* the boot stages, stamped with the tick when first reached */
+enum mqtt_boot_stage
+{
+    MQTT_BOOT_RDY = 0,
+    MQTT_BOOT_CFG,
+    MQTT_BOOT_OPEN,
+    MQTT_BOOT_CONN,
+    MQTT_BOOT_SUB,
+    MQTT_BOOT_PUB,
+    MQTT_BOOT_STAGE_NUM
+};
+
 struct mqtt_ctl
 {
     at_response_t mqtt_resp;               // MQTT response object
@@ -26,6 +43,23 @@ struct mqtt_ctl
     uint8_t is_open;
     uint8_t waiting_conn_urc;
     uint8_t is_conn;
+    uint8_t is_fresh;                      // The modem reported RDY, it has no connection yet
+    uint8_t cfg_skipped;                   // The configuration was applied before, not sent again
+    uint8_t conn_failed;                   // The broker refused the connection
+    rt_tick_t boot_tick[MQTT_BOOT_STAGE_NUM];
+    rt_rbb_t recv_rbb;                     // Downlink messages, a block each
+    rt_rbb_blk_t recv_blk;                 // The message taken by mqtt_ctl_recv_get
+    at_response_t recv_resp;               // Response of AT+QMTRECV, read by the fetching thread
+    rt_sem_t fetch_sem;                    // Released when a message waits in the modem
+    uint8_t recv_buffered;                 // The modem keeps the messages until they are read
+    uint8_t recv_pending;                  // Bits of the modem buffers holding a message
+    uint16_t recv_depth;                   // Messages in the queue
+    uint16_t recv_depth_max;
+    uint32_t recv_count;                   // Messages queued
+    uint32_t recv_dropped;                 // Messages lost with the queue full
+    uint32_t recv_fetches;                 // AT+QMTRECV reads
+    rt_mutex_t cmd_lock;                   // Held by the AT command sequences sharing the modem
+    uint16_t pub_msgid;                    // msgid of the last reply, 1 to 65535
     int (*cfg)(mqtt_ctl_t handler);        // Function pointer for MQTT configuration
     int (*open)(mqtt_ctl_t handler);       // Function pointer for opening MQTT connection
     int (*close)(mqtt_ctl_t handler);
@@ -33,7 +67,8 @@ struct mqtt_ctl
     int (*disconn)(mqtt_ctl_t handler);
     int (*sub)(mqtt_ctl_t handler);
     int (*unsub)(mqtt_ctl_t handler);
-    int (*pubex)(mqtt_ctl_t handler, const char *buf, int buf_size);
+    int (*pubex)(mqtt_ctl_t handler, const char *buf, int buf_size);    // Publish a reply
+    int (*pubtel)(mqtt_ctl_t handler, const char *buf, int buf_size);   // Publish the telemetry
 };
 
 
@@ -42,5 +77,9 @@ void mqtt_ctl_deinit(mqtt_ctl_t handler);
 mqtt_ctl_t mqtt_ctl_create(void);
 void mqtt_ctl_delete(mqtt_ctl_t handler);
 void mqtt_ctl_wait_rdy(mqtt_ctl_t handler);
+int mqtt_ctl_boot_time(mqtt_ctl_t handler);
+int mqtt_ctl_recv_fetch(mqtt_ctl_t handler, rt_int32_t timeout);
+const char *mqtt_ctl_recv_get(mqtt_ctl_t handler, rt_size_t *len, rt_uint32_t *recv_time);
+void mqtt_ctl_recv_free(mqtt_ctl_t handler);
 
 #endif /* APPLICATIONS_MQTT_CTL_H_ */
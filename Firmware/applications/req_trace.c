@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+#include "req_trace.h"
+#include <stdarg.h>
+#include <string.h>
+
+#define DBG_TAG "req_trace"
+#define DBG_LVL DBG_LOG
+#include <rtdbg.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#define REQ_TRACE_BUCKETS 16        // log2 buckets, below 64 us up to 1 s and more
+#define REQ_TRACE_BUCKET_SHIFT 6
+#define REQ_TRACE_SLAVES 8          // the slaves with a histogram of their own
+
+enum req_trace_state
+{
+    REQ_TRACE_IDLE = 0,
+    REQ_TRACE_RUNNING,              // between req_trace_begin and req_trace_end
+    REQ_TRACE_WAIT_ACK,             // published, the +QMTPUBEX is not in yet
+};
+
+struct req_trace_hist
+{
+    rt_uint16_t bucket[REQ_TRACE_BUCKETS];
+    rt_uint32_t count;
+    rt_uint32_t sum_us;
+    rt_uint32_t max_us;
+};
+
+struct req_trace_slave_hist
+{
+    rt_uint8_t addr;
+    rt_uint16_t errors;
+    struct req_trace_hist bus;
+};
+
+struct req_trace_ctx
+{
+    rt_uint32_t stamp[REQ_TRACE_POINT_NUM];  // clock counts, see req_trace_now
+    rt_uint8_t valid;                        // bits of the stamped points
+    rt_uint8_t slave;
+    rt_uint8_t func;
+    rt_int8_t result;
+    rt_int8_t bus_result;
+    rt_uint16_t msgid;                       // msgid of the reply, 0 before the publish
+};
+
+static const char *const stage_name[REQ_TRACE_STAGE_NUM] = {
+    "queue", "parse", "modbus", "build", "publish", "puback", "total"
+};
+
+/* the requests of the current window, cleared by each telemetry publish */
+static struct req_trace_hist stage_hist[REQ_TRACE_STAGE_NUM];
+static struct req_trace_slave_hist slave_hist[REQ_TRACE_SLAVES];
+static rt_uint32_t win_requests;
+static rt_uint32_t win_failed;              // no publish, or the publish failed
+static rt_uint32_t win_noack;               // published but no +QMTPUBEX before the next request
+static rt_tick_t win_start;
+
+static struct req_trace_ctx cur;
+static struct req_trace_ctx last;
+static rt_uint8_t state = REQ_TRACE_IDLE;
+
+/**
+ * req_trace_now - Get the time stamp of a point
+ *
+ * Return: the cpu time counts, the ticks without RT_USING_CPUTIME
+ */
+rt_uint32_t req_trace_now(void)
+{
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static rt_uint32_t req_trace_us(rt_uint32_t counts)
+{
+#ifdef RT_USING_CPUTIME
+    float res = clock_cpu_getres();
+
+    if (res > 0)
+    {
+        return (rt_uint32_t)(counts * res / 1000.0f);
+    }
+#endif
+    return counts * (1000000UL / RT_TICK_PER_SECOND);
+}
+
+static void hist_add(struct req_trace_hist *hist, rt_uint32_t us)
+{
+    int index = 0;
+    rt_uint32_t bound = 1UL << REQ_TRACE_BUCKET_SHIFT;
+
+    while (us >= bound && index < REQ_TRACE_BUCKETS - 1)
+    {
+        bound <<= 1;
+        index++;
+    }
+
+    if (hist->bucket[index] != 0xFFFF)
+    {
+        hist->bucket[index]++;
+    }
+    hist->count++;
+    hist->sum_us += us;
+    if (us > hist->max_us)
+    {
+        hist->max_us = us;
+    }
+}
+
+/* The upper bound of the bucket holding the percentile, no more than the maximum */
+static rt_uint32_t hist_percentile(const struct req_trace_hist *hist, int percent)
+{
+    rt_uint32_t total = 0, need, seen = 0;
+    int index;
+
+    for (index = 0; index < REQ_TRACE_BUCKETS; index++)
+    {
+        total += hist->bucket[index];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    need = (total * percent + 99) / 100;
+    for (index = 0; index < REQ_TRACE_BUCKETS - 1; index++)
+    {
+        seen += hist->bucket[index];
+        if (seen >= need)
+        {
+            break;
+        }
+    }
+
+    if (index == REQ_TRACE_BUCKETS - 1 || (1UL << (index + REQ_TRACE_BUCKET_SHIFT)) > hist->max_us)
+    {
+        return hist->max_us;
+    }
+    return 1UL << (index + REQ_TRACE_BUCKET_SHIFT);
+}
+
+static struct req_trace_slave_hist *slave_find(rt_uint8_t addr)
+{
+    int index;
+
+    for (index = 0; index < REQ_TRACE_SLAVES; index++)
+    {
+        if (slave_hist[index].addr == addr)
+        {
+            return &slave_hist[index];
+        }
+        if (slave_hist[index].addr == 0)
+        {
+            slave_hist[index].addr = addr;
+            return &slave_hist[index];
+        }
+    }
+    return RT_NULL;
+}
+
+/* Add the request to the histograms, called with the scheduler locked */
+static void req_trace_finish(void)
+{
+    struct req_trace_slave_hist *slave;
+    int point, first = -1, end = -1;
+
+    for (point = 0; point < REQ_TRACE_POINT_NUM; point++)
+    {
+        if (!(cur.valid & (1 << point)))
+        {
+            continue;
+        }
+        if (point > 0 && (cur.valid & (1 << (point - 1))))
+        {
+            hist_add(&stage_hist[point - 1], req_trace_us(cur.stamp[point] - cur.stamp[point - 1]));
+        }
+        if (first < 0)
+        {
+            first = point;
+        }
+        end = point;
+    }
+    if (first >= 0 && end > first)
+    {
+        hist_add(&stage_hist[REQ_TRACE_TOTAL], req_trace_us(cur.stamp[end] - cur.stamp[first]));
+    }
+
+    if (cur.slave != 0 && (cur.valid & (1 << REQ_TRACE_BUS)) && (cur.valid & (1 << REQ_TRACE_PARSE)))
+    {
+        slave = slave_find(cur.slave);
+        if (slave)
+        {
+            hist_add(&slave->bus, req_trace_us(cur.stamp[REQ_TRACE_BUS] - cur.stamp[REQ_TRACE_PARSE]));
+            if (cur.bus_result != 0)
+            {
+                slave->errors++;
+            }
+        }
+    }
+
+    win_requests++;
+    if (cur.result != 0)
+    {
+        win_failed++;
+    }
+
+    last = cur;
+    state = REQ_TRACE_IDLE;
+}
+
+/**
+ * req_trace_begin - Start the trace of a request taken from the queue
+ * @recv_time: req_trace_now when the message was queued
+ */
+void req_trace_begin(rt_uint32_t recv_time)
+{
+    rt_uint32_t now = req_trace_now();
+
+    rt_enter_critical();
+    if (state == REQ_TRACE_WAIT_ACK)
+    {
+        win_noack++;
+        req_trace_finish();
+    }
+    else if (state == REQ_TRACE_RUNNING)
+    {
+        /* the request was given up without req_trace_end */
+        cur.result = -1;
+        req_trace_finish();
+    }
+
+    rt_memset(&cur, 0, sizeof(cur));
+    cur.stamp[REQ_TRACE_RECV] = recv_time;
+    cur.stamp[REQ_TRACE_TAKE] = now;
+    cur.valid = (1 << REQ_TRACE_RECV) | (1 << REQ_TRACE_TAKE);
+    state = REQ_TRACE_RUNNING;
+    rt_exit_critical();
+}
+
+/**
+ * req_trace_point - Stamp a point of the running request
+ * @point: enum req_trace_point
+ */
+void req_trace_point(int point)
+{
+    rt_uint32_t now = req_trace_now();
+
+    if (state == REQ_TRACE_RUNNING && point > REQ_TRACE_TAKE && point < REQ_TRACE_PUB)
+    {
+        cur.stamp[point] = now;
+        cur.valid |= 1 << point;
+    }
+}
+
+/**
+ * req_trace_slave - Note the bus transaction of the running request
+ * @slave: the slave address
+ * @func: the modbus function of the request
+ * @result: the eMBMasterReqErrCode
+ */
+void req_trace_slave(rt_uint8_t slave, rt_uint8_t func, int result)
+{
+    if (state == REQ_TRACE_RUNNING)
+    {
+        cur.slave = slave;
+        cur.func = func;
+        cur.bus_result = (rt_int8_t)result;
+    }
+}
+
+/**
+ * req_trace_msgid - Note the msgid the reply of the running request goes with
+ * @msgid: the nonzero msgid of AT+QMTPUBEX
+ *
+ * Called before the publish, only the +QMTPUBEX with this msgid is its ack.
+ */
+void req_trace_msgid(rt_uint16_t msgid)
+{
+    rt_enter_critical();
+    if (state == REQ_TRACE_RUNNING)
+    {
+        cur.msgid = msgid;
+    }
+    rt_exit_critical();
+}
+
+/**
+ * req_trace_end - Stamp the publish of the reply
+ * @result: the pubex result, 0 when published
+ *
+ * A published request is added to the histograms when +QMTPUBEX comes.
+ */
+void req_trace_end(int result)
+{
+    rt_uint32_t now = req_trace_now();
+
+    rt_enter_critical();
+    if (state == REQ_TRACE_RUNNING)
+    {
+        cur.result = result ? -1 : 0;
+        if (result == 0)
+        {
+            /* the +QMTPUBEX came before pubex returned, the publish was over then */
+            cur.stamp[REQ_TRACE_PUB] = (cur.valid & (1 << REQ_TRACE_ACK)) ? cur.stamp[REQ_TRACE_ACK] : now;
+            cur.valid |= 1 << REQ_TRACE_PUB;
+        }
+
+        if (result != 0 || (cur.valid & (1 << REQ_TRACE_ACK)))
+        {
+            req_trace_finish();
+        }
+        else
+        {
+            state = REQ_TRACE_WAIT_ACK;
+        }
+    }
+    rt_exit_critical();
+}
+
+/**
+ * req_trace_ack - Stamp the +QMTPUBEX of the reply
+ * @msgid: the <msgid> of the URC
+ * @result: the <result> of the URC, 0 when sent
+ *
+ * Called on the AT parser thread. The URC may come before req_trace_end,
+ * one with another msgid is not for the traced reply and left out.
+ */
+void req_trace_ack(rt_uint16_t msgid, int result)
+{
+    rt_uint32_t now = req_trace_now();
+
+    rt_enter_critical();
+    if (state != REQ_TRACE_IDLE && msgid != 0 && msgid == cur.msgid &&
+        !(cur.valid & (1 << REQ_TRACE_ACK)))
+    {
+        cur.stamp[REQ_TRACE_ACK] = now;
+        cur.valid |= 1 << REQ_TRACE_ACK;
+        if (result != 0)
+        {
+            cur.result = -1;
+        }
+
+        if (state == REQ_TRACE_WAIT_ACK)
+        {
+            req_trace_finish();
+        }
+    }
+    rt_exit_critical();
+}
+
+static void req_trace_reset(void)
+{
+    rt_enter_critical();
+    rt_memset(stage_hist, 0, sizeof(stage_hist));
+    rt_memset(slave_hist, 0, sizeof(slave_hist));
+    win_requests = 0;
+    win_failed = 0;
+    win_noack = 0;
+    win_start = rt_tick_get();
+    rt_exit_critical();
+}
+
+/* Append to the buffer, the length stays at the size or more once it is full */
+static int json_append(char *buf, int size, int len, const char *fmt, ...)
+{
+    va_list args;
+
+    if (len < size)
+    {
+        va_start(args, fmt);
+        len += rt_vsnprintf(buf + len, size - len, fmt, args);
+        va_end(args);
+    }
+    return len;
+}
+
+static int json_ms_array(char *buf, int size, int len, const char *key, int percent)
+{
+    rt_uint32_t us;
+    int stage;
+
+    len = json_append(buf, size, len, ",\"%s\":[", key);
+    for (stage = 0; stage < REQ_TRACE_STAGE_NUM; stage++)
+    {
+        us = percent ? hist_percentile(&stage_hist[stage], percent) : stage_hist[stage].max_us;
+        len = json_append(buf, size, len, stage ? ",%u" : "%u", (us + 999) / 1000);
+    }
+    return json_append(buf, size, len, "]");
+}
+
+/**
+ * req_trace_telemetry - Print the window in compact JSON and start a new one
+ * @buf: the buffer of the publish
+ * @size: the buffer size
+ *
+ * {"trace":{"s":<window seconds>,"n":<requests>,"fail":<n>,"noack":<n>,
+ *  "p50":[<ms of each stage>],"p99":[...],"max":[...],
+ *  "slave":[[<addr>,<n>,<errors>,<p50 ms>,<p99 ms>],...]}}
+ * The stages are queue, parse, modbus, build, publish, puback and total.
+ * The slaves not fitting the buffer are left out.
+ *
+ * Return: the length, 0 with no request in the window or no room
+ */
+int req_trace_telemetry(char *buf, int size)
+{
+    const struct req_trace_slave_hist *slave;
+    int len, index, item;
+    char one[48];
+
+    if (win_requests == 0)
+    {
+        return 0;
+    }
+
+    rt_enter_critical();
+    len = json_append(buf, size, 0, "{\"trace\":{\"s\":%u,\"n\":%u,\"fail\":%u,\"noack\":%u",
+                      (rt_tick_get() - win_start) / RT_TICK_PER_SECOND, win_requests, win_failed, win_noack);
+    len = json_ms_array(buf, size, len, "p50", 50);
+    len = json_ms_array(buf, size, len, "p99", 99);
+    len = json_ms_array(buf, size, len, "max", 0);
+    len = json_append(buf, size, len, ",\"slave\":[");
+    for (index = 0, item = 0; index < REQ_TRACE_SLAVES && slave_hist[index].addr; index++)
+    {
+        slave = &slave_hist[index];
+        rt_snprintf(one, sizeof(one), "%s[%u,%u,%u,%u,%u]", item ? "," : "", slave->addr, slave->bus.count,
+                    slave->errors, (hist_percentile(&slave->bus, 50) + 999) / 1000,
+                    (hist_percentile(&slave->bus, 99) + 999) / 1000);
+        /* keep the room of "]}}" */
+        if (len + (int)rt_strlen(one) + 3 >= size)
+        {
+            break;
+        }
+        len = json_append(buf, size, len, "%s", one);
+        item++;
+    }
+    len = json_append(buf, size, len, "]}}");
+    rt_exit_critical();
+
+    if (len >= size)
+    {
+        LOG_W("Telemetry does not fit the buffer of %d bytes.", size);
+        return 0;
+    }
+
+    req_trace_reset();
+    return len;
+}
+
+static int req_trace(int argc, char **argv)
+{
+    const struct req_trace_hist *hist;
+    int index;
+
+    if (argc > 1)
+    {
+        if (rt_strcmp(argv[1], "-r") != 0)
+        {
+            rt_kprintf("Usage: req_trace [-r]\r\n");
+            rt_kprintf("       show the request latency of the window, -r starts a new window\r\n");
+            return -1;
+        }
+        req_trace_reset();
+        return 0;
+    }
+
+    rt_kprintf("window %d s: %d requests, %d failed, %d without ack\r\n",
+               (rt_tick_get() - win_start) / RT_TICK_PER_SECOND, win_requests, win_failed, win_noack);
+    rt_kprintf("%-8s %6s %10s %10s %10s %10s\r\n", "stage", "n", "p50_us", "p99_us", "max_us", "avg_us");
+    for (index = 0; index < REQ_TRACE_STAGE_NUM; index++)
+    {
+        hist = &stage_hist[index];
+        rt_kprintf("%-8s %6d %10d %10d %10d %10d\r\n", stage_name[index], hist->count,
+                   hist_percentile(hist, 50), hist_percentile(hist, 99), hist->max_us,
+                   hist->count ? hist->sum_us / hist->count : 0);
+    }
+
+    rt_kprintf("\r\n%-8s %6s %6s %10s %10s %10s\r\n", "slave", "n", "errors", "p50_us", "p99_us", "max_us");
+    for (index = 0; index < REQ_TRACE_SLAVES && slave_hist[index].addr; index++)
+    {
+        hist = &slave_hist[index].bus;
+        rt_kprintf("%-8d %6d %6d %10d %10d %10d\r\n", slave_hist[index].addr, hist->count,
+                   slave_hist[index].errors, hist_percentile(hist, 50), hist_percentile(hist, 99), hist->max_us);
+    }
+
+    if (last.valid)
+    {
+        rt_kprintf("\r\nlast request: slave %d, func %d, result %d\r\n", last.slave, last.func, last.result);
+        for (index = REQ_TRACE_TAKE; index < REQ_TRACE_POINT_NUM; index++)
+        {
+            if ((last.valid & (1 << index)) && (last.valid & (1 << (index - 1))))
+            {
+                rt_kprintf("  %-8s %10d us\r\n", stage_name[index - 1],
+                           req_trace_us(last.stamp[index] - last.stamp[index - 1]));
+            }
+        }
+    }
+    return 0;
+}
+MSH_CMD_EXPORT(req_trace, show the latency of the cloud requests);
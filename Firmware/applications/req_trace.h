@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+#ifndef APPLICATIONS_REQ_TRACE_H_
+#define APPLICATIONS_REQ_TRACE_H_
+
+#include <rtthread.h>
+
+#define REQ_TRACE_PUB_PERIOD_MS 60000   // The telemetry publish of the latency window
+
+/* the points of a cloud request, stamped in this order */
+enum req_trace_point
+{
+    REQ_TRACE_RECV = 0,     // +QMTRECV queued the message
+    REQ_TRACE_TAKE,         // the send thread took it from the queue
+    REQ_TRACE_PARSE,        // the JSON is parsed
+    REQ_TRACE_BUS,          // the eMBMasterReq* transaction is over
+    REQ_TRACE_BUILD,        // the reply JSON is printed
+    REQ_TRACE_PUB,          // AT+QMTPUBEX returned OK
+    REQ_TRACE_ACK,          // +QMTPUBEX reported the msgid of the reply
+    REQ_TRACE_POINT_NUM
+};
+
+/* the stage between a point and the one before it, and the whole request */
+enum req_trace_stage
+{
+    REQ_TRACE_QUEUE = 0,
+    REQ_TRACE_JSON_PARSE,
+    REQ_TRACE_MODBUS,
+    REQ_TRACE_JSON_BUILD,
+    REQ_TRACE_PUBLISH,
+    REQ_TRACE_PUBACK,
+    REQ_TRACE_TOTAL,
+    REQ_TRACE_STAGE_NUM
+};
+
+rt_uint32_t req_trace_now(void);
+void req_trace_begin(rt_uint32_t recv_time);
+void req_trace_point(int point);
+void req_trace_slave(rt_uint8_t slave, rt_uint8_t func, int result);
+void req_trace_msgid(rt_uint16_t msgid);
+void req_trace_end(int result);
+void req_trace_ack(rt_uint16_t msgid, int result);
+int req_trace_telemetry(char *buf, int size);
+
+#endif /* APPLICATIONS_REQ_TRACE_H_ */
@@ -6,6 +6,14 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-06-21     flybreak     first version
+ * 2026-10-19     RT-Thread    take the JSON nodes and the scratch from the object cache
+ * 2026-10-19     RT-Thread    take the messages from the downlink queue of mqtt_ctl
+ * 2026-10-19     RT-Thread    trace the requests and publish the latency telemetry
+ * 2026-10-19     RT-Thread    read the replies from the sparse register store
+ * 2026-10-19     RT-Thread    take the bus by the transaction class
+ * 2026-10-19     RT-Thread    publish the latency telemetry on its own topic
+ * 2026-10-19     RT-Thread    parse the queued messages ahead and run them by class
+ * 2026-10-19     RT-Thread    keep the registers of the slaves on the bus only
  */
 
 #include <rtthread.h>
@@ -14,6 +22,10 @@
 #include "mb_m.h"
 #include "cJSON.h"
 #include "mqtt_ctl.h"
+#include "req_trace.h"
+#include "mb_regstore.h"
+#include "mb_health.h"
+#include "mb_sched.h"
 #include "user_mb_app.h"
 
 #define DBG_TAG "sample_mb_master"
@@ -37,183 +49,385 @@
 #define MB_SEND_REG_START  2
 #define MB_SEND_REG_NUM    2
 
-#define MB_POLL_CYCLE_MS   500
+#define MB_PUB_BUF_SIZE    256
+#define MB_REQ_NUM_MAX     16
+#define MB_REQ_TAKE_MS     1000    // The wait for the bus and the master, the respond timeout is per slave
+#define MB_REQ_QUEUE_MAX   8       // The messages parsed ahead, as many as the downlink queue holds
 
-extern UCHAR    ucMDiscInBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_DISCRETE_INPUT_NDISCRETES/8];
-extern UCHAR    ucMCoilBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_COIL_NCOILS/8];
-extern USHORT   usMRegInBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_REG_INPUT_NREGS];
-extern USHORT   usMRegHoldBuf[MB_MASTER_TOTAL_SLAVE_NUM][M_REG_HOLDING_NREGS];
+/* the JSON tree and the register scratch of a message are short lived, keep them out of the heap */
+#ifdef RT_USING_OBJCACHE
+#include <objcache.h>
+#define mb_malloc   rt_objcache_alloc
+#define mb_free     rt_objcache_free
+
+static void *json_malloc(size_t size)
+{
+    return rt_objcache_alloc(size);
+}
+
+static void json_free(void *ptr)
+{
+    rt_objcache_free(ptr);
+}
+#else
+#define mb_malloc   rt_malloc
+#define mb_free     rt_free
+#endif /* RT_USING_OBJCACHE */
+
+/* the slaves on the bus, the package port kept the registers of all MB_MASTER_TOTAL_SLAVE_NUM addresses */
+static const rt_uint8_t mb_slaves[] = {SLAVE_ADDR};
+
+/* the ranges of each slave on the bus, those of the dense arrays of the package port */
+static const struct mb_regstore_point mb_slave_points[] =
+{
+    {0, MB_STORE_COIL,     M_COIL_START,           M_COIL_NCOILS},
+    {0, MB_STORE_DISCRETE, M_DISCRETE_INPUT_START, M_DISCRETE_INPUT_NDISCRETES},
+    {0, MB_STORE_HOLDING,  M_REG_HOLDING_START,    M_REG_HOLDING_NREGS},
+    {0, MB_STORE_INPUT,    M_REG_INPUT_START,      M_REG_INPUT_NREGS},
+};
+
+/* the ranges of the slaves with more registers, any address up to 247, merged with the ones above */
+static const struct mb_regstore_point mb_points[] =
+{
+    {SLAVE_ADDR, MB_STORE_HOLDING,  0, 100},
+    {SLAVE_ADDR, MB_STORE_INPUT,    0, 100},
+};
+
+/* the register table of the function codes 1 to 4 */
+static const rt_uint8_t mb_func_type[] = {MB_STORE_COIL, MB_STORE_DISCRETE, MB_STORE_HOLDING, MB_STORE_INPUT};
+
+/* a cloud request parsed and waiting for the turn of its class */
+struct mb_req
+{
+    struct mb_sched_req sched;
+    cJSON *json;                // RT_NULL when the entry is free
+    rt_uint32_t recv_time;
+};
 
 extern rt_sem_t recv_sem;
-extern char msg_buf[256];
 extern mqtt_ctl_t my_handler;
 
-static void send_thread_entry(void *parameter)
+static char pub_buf[MB_PUB_BUF_SIZE];
+static struct mb_req mb_reqs[MB_REQ_QUEUE_MAX];
+static rt_uint8_t mb_req_queued;
+static rt_uint16_t error_count;
+
+/**
+ * mb_points_init - Build the register store of the slaves
+ *
+ * Every slave of mb_slaves gets mb_slave_points, mb_points adds to them.
+ *
+ * Return: 0 on success, -1 without memory
+ */
+static int mb_points_init(void)
 {
-    eMBMasterReqErrCode error_code = MB_MRE_NO_ERR;
-    rt_uint16_t error_count = 0;
+    rt_size_t slave_num = sizeof(mb_slave_points) / sizeof(mb_slave_points[0]);
+    rt_size_t extra_num = sizeof(mb_points) / sizeof(mb_points[0]);
+    rt_size_t num = sizeof(mb_slaves) * slave_num + extra_num;
+    struct mb_regstore_point *points;
+    rt_size_t index = 0;
+    int result;
+
+    points = rt_malloc(num * sizeof(struct mb_regstore_point));
+    if (points == RT_NULL)
+    {
+        return -1;
+    }
 
-    while (1)
+    for (rt_size_t n = 0; n < sizeof(mb_slaves); n++)
     {
-        rt_sem_take(recv_sem, RT_WAITING_FOREVER);
-        LOG_D("modbus msg: %s", msg_buf);
+        for (rt_size_t i = 0; i < slave_num; i++)
+        {
+            points[index] = mb_slave_points[i];
+            points[index++].slave = mb_slaves[n];
+        }
+    }
+    rt_memcpy(&points[index], mb_points, sizeof(mb_points));
 
-        cJSON *json = cJSON_Parse(msg_buf);
-        int slaveAddr = cJSON_GetObjectItem(json, "slaveAddr")->valueint;
-        int func = cJSON_GetObjectItem(json, "func")->valueint;
-        int regStart = cJSON_GetObjectItem(json, "regStart")->valueint;
-        int regNum = cJSON_GetObjectItem(json, "regNum")->valueint;
-        int rw = cJSON_GetObjectItem(json, "rw")->valueint;
+    result = mb_regstore_init(points, num);
+    rt_free(points);
+    return result;
+}
 
-        LOG_D("json data: slaveAddr: %d, func: %d, regStart: %d, regNum: %d, rw: %d.", slaveAddr, func, regStart, regNum, rw);
+/**
+ * mb_read_back - Take the values a read left in the register store
+ * @slave: the slave address
+ * @func: the function code, 1 to 4
+ * @start: the first address
+ * @num: the number of registers or bits, MB_REQ_NUM_MAX at most
+ * @data: the values
+ *
+ * Return: 0 on success, -1 outside the register store
+ */
+static int mb_read_back(int slave, int func, int start, int num, int *data)
+{
+    rt_uint16_t regs[MB_REQ_NUM_MAX];
+    int type = mb_func_type[func - 1];
+    int result;
+
+    if (type == MB_STORE_COIL || type == MB_STORE_DISCRETE)
+    {
+        rt_uint8_t *bits = (rt_uint8_t *)regs;
 
-        switch (func)
+        result = mb_regstore_get_bits(slave, type, start, bits, num);
+        for (int i = 0; result == 0 && i < num; i++)
+            data[i] = bits[i];
+    }
+    else
+    {
+        result = mb_regstore_get_regs(slave, type, start, regs, num);
+        for (int i = 0; result == 0 && i < num; i++)
+            data[i] = regs[i];
+    }
+
+    return result;
+}
+
+/**
+ * mb_req_queue - Parse the oldest downlink message and queue it by class
+ *
+ * The writes go before the reads, an optional "class" picks another.
+ */
+static void mb_req_queue(void)
+{
+    struct mb_req *req = RT_NULL;
+    rt_uint32_t recv_time;
+    cJSON *item;
+    int cls;
+
+    const char *msg = mqtt_ctl_recv_get(my_handler, RT_NULL, &recv_time);
+    if (msg == RT_NULL)
+        return;
+    LOG_D("modbus msg: %s", msg);
+
+    cJSON *json = cJSON_Parse(msg);
+    mqtt_ctl_recv_free(my_handler);
+    if (json == RT_NULL)
+    {
+        req_trace_begin(recv_time);
+        req_trace_end(-1);
+        return;
+    }
+
+    for (int i = 0; i < MB_REQ_QUEUE_MAX; i++)
+    {
+        if (mb_reqs[i].json == RT_NULL)
         {
-        case 1:
-            if (rw == 0)
-            {
-                cJSON *array = cJSON_GetObjectItem(json, "data");
-                uint8_t *data = rt_malloc(16 * sizeof(uint8_t));
-                rt_memset(data, 0, 16 * sizeof(uint8_t));
-                if (!data)
-                    continue;
-
-                for (int i = 0; i < regNum; i++)
-                {
-                    uint8_t temp = (uint8_t)cJSON_GetArrayItem(array, i)->valueint;
-                    xMBUtilSetBits(data, i, 1, temp);
-                }
-                error_code = eMBMasterReqWriteMultipleCoils(slaveAddr, regStart, regNum, data, RT_WAITING_FOREVER);
-                rt_free(data);
-            }
-            else
-            {
-                error_code = eMBMasterReqReadCoils(slaveAddr, regStart, regNum, RT_WAITING_FOREVER);
-            }
-            break;
-        case 2:
-            if (rw == 1)
-            {
-                error_code = eMBMasterReqReadDiscreteInputs(slaveAddr, regStart, regNum, RT_WAITING_FOREVER);
-            }
-            else
-            {
-                error_code = MB_MRE_ILL_ARG;
-            }
+            req = &mb_reqs[i];
             break;
-        case 3:
-            if (rw == 0)
+        }
+    }
+    RT_ASSERT(req != RT_NULL);
+
+    item = cJSON_GetObjectItem(json, "rw");
+    cls = item != RT_NULL && item->valueint == 0 ? MB_SCHED_CONTROL : MB_SCHED_POLL;
+    item = cJSON_GetObjectItem(json, "class");
+    if (item != RT_NULL && item->valueint >= 0 && item->valueint < MB_SCHED_CLASS_NUM)
+        cls = item->valueint;
+
+    req->json = json;
+    req->recv_time = recv_time;
+    mb_req_queued++;
+    mb_sched_submit(&req->sched, cls);
+}
+
+/**
+ * mb_req_run - Run a queued request on the bus and publish the reply
+ * @req: the request given by mb_sched_next, free after the call
+ */
+static void mb_req_run(struct mb_req *req)
+{
+    eMBMasterReqErrCode error_code = MB_MRE_NO_ERR;
+    cJSON *json = req->json;
+
+    /* the time in the queue, waiting for the better classes, is the queue stage */
+    req_trace_begin(req->recv_time);
+
+    int slaveAddr = cJSON_GetObjectItem(json, "slaveAddr")->valueint;
+    int func = cJSON_GetObjectItem(json, "func")->valueint;
+    int regStart = cJSON_GetObjectItem(json, "regStart")->valueint;
+    int regNum = cJSON_GetObjectItem(json, "regNum")->valueint;
+    int rw = cJSON_GetObjectItem(json, "rw")->valueint;
+
+    LOG_D("json data: slaveAddr: %d, func: %d, regStart: %d, regNum: %d, rw: %d.", slaveAddr, func, regStart, regNum, rw);
+    req_trace_point(REQ_TRACE_PARSE);
+
+    /* the store holds the configured ranges only, refuse the others before the bus */
+    if (func < 1 || func > 4 || regNum < 1 || regNum > MB_REQ_NUM_MAX ||
+        !mb_regstore_contains(slaveAddr, mb_func_type[func - 1], regStart, regNum))
+    {
+        LOG_W("slave %d func %d registers %d + %d are not configured.", slaveAddr, func, regStart, regNum);
+        func = 0;
+    }
+    else
+    {
+        if (mb_sched_acquire_req(&req->sched, rt_tick_from_millisecond(MB_REQ_TAKE_MS)) != RT_EOK)
+        {
+            error_code = MB_MRE_MASTER_BUSY;
+            goto __bus_done;
+        }
+        if (!mb_health_allow(slaveAddr))
+        {
+            /* the breaker of the slave is open, do not spend a respond timeout on it */
+            mb_sched_release();
+            error_code = MB_MRE_TIMEDOUT;
+            goto __bus_done;
+        }
+    }
+
+    switch (func)
+    {
+    case 1:
+        if (rw == 0)
+        {
+            cJSON *array = cJSON_GetObjectItem(json, "data");
+            uint8_t *data = mb_malloc(16 * sizeof(uint8_t));
+            if (!data)
             {
-                cJSON *array = cJSON_GetObjectItem(json, "data");
-                uint16_t *data = rt_malloc(16 * sizeof(uint16_t));
-                if (!data)
-                    continue;
-
-                for (int i = 0; i < regNum; i++)
-                {
-                    data[i] = (uint16_t)cJSON_GetArrayItem(array, i)->valueint;
-                    LOG_D("data[%d]: %d", i, data[i]);
-                }
-                error_code = eMBMasterReqWriteMultipleHoldingRegister(slaveAddr, regStart, regNum, data, RT_WAITING_FOREVER);
-                rt_free(data);
+                error_code = MB_MRE_MASTER_BUSY;
+                break;
             }
-            else
+            rt_memset(data, 0, 16 * sizeof(uint8_t));
+
+            for (int i = 0; i < regNum; i++)
             {
-                error_code = eMBMasterReqReadHoldingRegister(slaveAddr, regStart, regNum, RT_WAITING_FOREVER);
+                uint8_t temp = (uint8_t)cJSON_GetArrayItem(array, i)->valueint;
+                xMBUtilSetBits(data, i, 1, temp);
             }
-            break;
-        case 4:
-            if (rw == 1)
+            error_code = eMBMasterReqWriteMultipleCoils(slaveAddr, regStart, regNum, data, rt_tick_from_millisecond(MB_REQ_TAKE_MS));
+            mb_free(data);
+        }
+        else
+        {
+            error_code = eMBMasterReqReadCoils(slaveAddr, regStart, regNum, rt_tick_from_millisecond(MB_REQ_TAKE_MS));
+        }
+        break;
+    case 2:
+        if (rw == 1)
+        {
+            error_code = eMBMasterReqReadDiscreteInputs(slaveAddr, regStart, regNum, rt_tick_from_millisecond(MB_REQ_TAKE_MS));
+        }
+        else
+        {
+            error_code = MB_MRE_ILL_ARG;
+        }
+        break;
+    case 3:
+        if (rw == 0)
+        {
+            cJSON *array = cJSON_GetObjectItem(json, "data");
+            uint16_t *data = mb_malloc(16 * sizeof(uint16_t));
+            if (!data)
             {
-                error_code = eMBMasterReqReadInputRegister(slaveAddr, regStart, regNum, RT_WAITING_FOREVER);
+                error_code = MB_MRE_MASTER_BUSY;
+                break;
             }
-            else
+
+            for (int i = 0; i < regNum; i++)
             {
-                error_code = MB_MRE_ILL_ARG;
+                data[i] = (uint16_t)cJSON_GetArrayItem(array, i)->valueint;
+                LOG_D("data[%d]: %d", i, data[i]);
             }
-            break;
-        default:
-            break;
+            error_code = eMBMasterReqWriteMultipleHoldingRegister(slaveAddr, regStart, regNum, data, rt_tick_from_millisecond(MB_REQ_TAKE_MS));
+            mb_free(data);
+        }
+        else
+        {
+            error_code = eMBMasterReqReadHoldingRegister(slaveAddr, regStart, regNum, rt_tick_from_millisecond(MB_REQ_TAKE_MS));
         }
+        break;
+    case 4:
+        if (rw == 1)
+        {
+            error_code = eMBMasterReqReadInputRegister(slaveAddr, regStart, regNum, rt_tick_from_millisecond(MB_REQ_TAKE_MS));
+        }
+        else
+        {
+            error_code = MB_MRE_ILL_ARG;
+        }
+        break;
+    default:
+        error_code = MB_MRE_ILL_ARG;
+        break;
+    }
+    if (func != 0)
+    {
+        mb_sched_release();
+        /* the breaker learns from the frames sent only, no reply is a timeout */
+        if (error_code == MB_MRE_NO_ERR || error_code == MB_MRE_REV_DATA ||
+            error_code == MB_MRE_EXE_FUN || error_code == MB_MRE_TIMEDOUT)
+            mb_health_done(slaveAddr, error_code != MB_MRE_TIMEDOUT);
+        else
+            mb_health_cancel(slaveAddr);
+    }
 
-        LOG_D("error code: %d", error_code);
+__bus_done:
+    req_trace_point(REQ_TRACE_BUS);
+    req_trace_slave(slaveAddr, func, error_code);
+    LOG_D("error code: %d", error_code);
 
+    if (error_code == MB_MRE_NO_ERR && rw == 1)
+    {
+        int *data = mb_malloc(MB_REQ_NUM_MAX * sizeof(int));
 
+        if (data != RT_NULL && mb_read_back(slaveAddr, func, regStart, regNum, data) == 0)
+        {
+            cJSON_AddItemToObject(json, "data", cJSON_CreateIntArray(data, regNum));
+        }
+        mb_free(data);
+    }
+
+    cJSON_AddNumberToObject(json, "result", error_code);
+    cJSON_PrintPreallocated(json, pub_buf, sizeof(pub_buf), 0);
+    req_trace_point(REQ_TRACE_BUILD);
+    req_trace_end(my_handler->pubex(my_handler, pub_buf, rt_strlen(pub_buf)));
+
+    /* Record the number of errors */
+    if (error_code != MB_MRE_NO_ERR)
+    {
+        error_count++;
+    }
+
+    cJSON_Delete(json);
+    req->json = RT_NULL;
+    mb_req_queued--;
+}
 
-        if (error_code == MB_MRE_NO_ERR && rw == 1)
+static void send_thread_entry(void *parameter)
+{
+    rt_tick_t telemetry_tick = rt_tick_get() + rt_tick_from_millisecond(REQ_TRACE_PUB_PERIOD_MS);
+    struct mb_sched_req *next;
+    rt_int32_t wait;
+
+    while (1)
+    {
+        /* the latency telemetry goes out between the requests */
+        if ((rt_int32_t)(telemetry_tick - rt_tick_get()) <= 0)
         {
-            int *data = NULL;
-            cJSON *array = NULL;
-            switch (func)
-            {
-            case 1:
-                data = rt_malloc(16 * sizeof(int));
-                rt_memset(data, 0, 16 * sizeof(int));
-                if (!data)
-                    continue;
-                for (int i = 0; i < regNum; i++)
-                {
-                    data[i] = (int)xMBUtilGetBits(ucMCoilBuf[slaveAddr - 1], i + regStart, 1);
-                }
-                array = cJSON_CreateIntArray(data, regNum);
-                cJSON_AddItemToObject(json, "data", array);
-                rt_free(data);
-                break;
-            case 2:
-                data = rt_malloc(16 * sizeof(int));
-                rt_memset(data, 0, 16 * sizeof(int));
-                if (!data)
-                    continue;
-                for (int i = 0; i < regNum; i++)
-                {
-                    data[i] = (int)xMBUtilGetBits(ucMDiscInBuf[slaveAddr - 1], i + regStart, 1);
-                }
-                array = cJSON_CreateIntArray(data, regNum);
-                cJSON_AddItemToObject(json, "data", array);
-                rt_free(data);
-                break;
-            case 3:
-                data = rt_malloc(16 * sizeof(int));
-                rt_memset(data, 0, 16 * sizeof(int));
-                if (!data)
-                    continue;
-                for (int i = 0; i < regNum; i++)
-                {
-                    data[i] = (int)usMRegHoldBuf[slaveAddr - 1][regStart + i];
-                }
-                array = cJSON_CreateIntArray(data, regNum);
-                cJSON_AddItemToObject(json, "data", array);
-                rt_free(data);
-                break;
-            case 4:
-                data = rt_malloc(16 * sizeof(int));
-                rt_memset(data, 0, 16 * sizeof(int));
-                if (!data)
-                    continue;
-                for (int i = 0; i < regNum; i++)
-                {
-                    data[i] = (int)usMRegInBuf[slaveAddr - 1][regStart + i];
-                }
-                array = cJSON_CreateIntArray(data, regNum);
-                cJSON_AddItemToObject(json, "data", array);
-                rt_free(data);
-                break;
-            default:
-                break;
-            }
+            int len = req_trace_telemetry(pub_buf, sizeof(pub_buf));
+            if (len > 0 && my_handler != RT_NULL)
+                my_handler->pubtel(my_handler, pub_buf, len);
+            telemetry_tick = rt_tick_get() + rt_tick_from_millisecond(REQ_TRACE_PUB_PERIOD_MS);
         }
 
-        cJSON_AddNumberToObject(json, "result", error_code);
-        cJSON_PrintPreallocated(json, msg_buf, 256, 0);
-        my_handler->pubex(my_handler, msg_buf, rt_strlen(msg_buf));
+        /* parse all the messages that came, one a release of recv_sem, then run the best class of them */
+        while (mb_req_queued < MB_REQ_QUEUE_MAX && rt_sem_take(recv_sem, 0) == RT_EOK)
+        {
+            mb_req_queue();
+        }
 
-        /* Record the number of errors */
-        if (error_code != MB_MRE_NO_ERR)
+        next = mb_sched_next();
+        if (next != RT_NULL)
         {
-            error_count++;
+            mb_req_run(rt_container_of(next, struct mb_req, sched));
+            continue;
         }
 
-        cJSON_Delete(json);
+        wait = (rt_int32_t)(telemetry_tick - rt_tick_get());
+        if (wait > 0 && rt_sem_take(recv_sem, wait) == RT_EOK)
+        {
+            mb_req_queue();
+        }
     }
 }
 
@@ -225,10 +439,10 @@ static void mb_master_poll(void *parameter)
 
     eMBMasterEnable();
 
+    /* eMBMasterPoll waits for the port events, a delay here would sit between the frames */
     while (1)
     {
         eMBMasterPoll();
-        rt_thread_mdelay(MB_POLL_CYCLE_MS);
     }
 }
 
@@ -242,6 +456,21 @@ int mb_master_sample(int argc, char **argv)
         rt_kprintf("sample is running\n");
         return -RT_ERROR;
     }
+
+    if (mb_points_init() != 0)
+    {
+        return -RT_ENOMEM;
+    }
+
+#ifdef RT_USING_OBJCACHE
+    {
+        cJSON_Hooks hooks = {json_malloc, json_free};
+
+        /* before the send thread parses the first message */
+        cJSON_InitHooks(&hooks);
+    }
+#endif
+
     tid1 = rt_thread_create("md_m_poll", mb_master_poll, RT_NULL, 512, MB_POLL_THREAD_PRIORITY, 10);
     if (tid1 != RT_NULL)
     {
@@ -238,6 +238,23 @@ extern "C"
 
 /*-------------------------- HAREWARE TIMER CONFIG END --------------------------*/
 
+/*-------------------------- PM CONFIG BEGIN --------------------------*/
+
+/** if you want to use tickless idle you can use the following instructions.
+ *
+ * STEP 1, open pm driver framework support in the RT-Thread Settings file,
+ *         the idle thread stack shall be larger than 256 bytes
+ *
+ * STEP 2, release the none sleep mode in the application when the system may sleep
+ *                 such as     rt_pm_release(PM_SLEEP_MODE_NONE)
+ *
+ * STEP 3, check the wake-ups and the sleep time with the msh command pm_stat,
+ *         open PM_ENABLE_STATISTICS in the RT-Thread Settings file
+ *
+ */
+
+/*-------------------------- PM CONFIG END --------------------------*/
+
 /*-------------------------- RTC CONFIG BEGIN --------------------------*/
 
 /** if you want to use rtc(hardware) you can use the following instructions.
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#include <board.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef RT_USING_PM
+
+/*
+ * The STM32F1 has no low power timer running in STOP mode, so the tickless
+ * sleep is done in SLEEP mode: the SysTick reload is stretched to the next
+ * timer deadline and any other interrupt (UART, EXTI...) ends the sleep early.
+ */
+
+/* SysTick counts of one OS tick */
+static rt_uint32_t _tick_cycles;
+/* OS ticks and SysTick counts programmed for the current sleep, 0 if the tick is not suppressed */
+static rt_uint32_t _sleep_ticks;
+static rt_uint32_t _sleep_cycles;
+/* SysTick counts left in the tick in progress when the sleep starts */
+static rt_uint32_t _sleep_first;
+
+static void sleep(struct rt_pm *pm, rt_uint8_t mode)
+{
+    switch (mode)
+    {
+    case PM_SLEEP_MODE_NONE:
+        break;
+
+    case PM_SLEEP_MODE_IDLE:
+        __WFI();
+        break;
+
+    case PM_SLEEP_MODE_LIGHT:
+    case PM_SLEEP_MODE_DEEP:
+    case PM_SLEEP_MODE_STANDBY:
+    case PM_SLEEP_MODE_SHUTDOWN:
+        /* the deeper modes would stop the tick source, stay in SLEEP mode */
+        HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+        break;
+
+    default:
+        RT_ASSERT(0);
+        break;
+    }
+}
+
+static void pm_timer_start(struct rt_pm *pm, rt_uint32_t timeout)
+{
+    rt_uint32_t max_ticks, ctrl;
+
+    _sleep_ticks = 0;
+
+    max_ticks = SysTick_LOAD_RELOAD_Msk / _tick_cycles;
+    if (timeout > max_ticks)
+        timeout = max_ticks;
+    if (timeout < 2)
+        return;
+
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    if (((ctrl | SysTick->CTRL) & SysTick_CTRL_COUNTFLAG_Msk) ||
+        (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        /* a tick is just pending, do not stretch it */
+        SysTick->CTRL = ctrl;
+        return;
+    }
+
+    /* the tick in progress ends the first period */
+    _sleep_first  = SysTick->VAL;
+    _sleep_cycles = _sleep_first + (timeout - 1) * _tick_cycles;
+    _sleep_ticks  = timeout;
+
+    SysTick->LOAD = _sleep_cycles - 1;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = ctrl;
+}
+
+static rt_tick_t pm_timer_get_tick(struct rt_pm *pm)
+{
+    rt_uint32_t ctrl, val, counted;
+
+    if (_sleep_ticks == 0)
+        return 0;
+
+    /* COUNTFLAG is cleared by reading CTRL, read it only once */
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+    if (ctrl & SysTick_CTRL_COUNTFLAG_Msk)
+    {
+        /* the deadline is reached, the pending SysTick interrupt counts the last tick */
+        return _sleep_ticks - 1;
+    }
+
+    /* VAL is 0 until the first count after the reload */
+    val = SysTick->VAL;
+    counted = val ? (_sleep_cycles - 1) - val : 0;
+    if (counted < _sleep_first)
+        return 0;
+
+    return 1 + (counted - _sleep_first) / _tick_cycles;
+}
+
+static void pm_timer_stop(struct rt_pm *pm)
+{
+    if (_sleep_ticks == 0)
+        return;
+
+    /* the part of the tick in progress is lost */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = _tick_cycles - 1;
+    SysTick->VAL  = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    _sleep_ticks = 0;
+}
+
+static void run(struct rt_pm *pm, rt_uint8_t mode)
+{
+    /* the system clock is fixed by hw_board_init */
+}
+
+static const struct rt_pm_ops _ops =
+{
+    sleep,
+    run,
+    pm_timer_start,
+    pm_timer_stop,
+    pm_timer_get_tick
+};
+
+int drv_pm_hw_init(void)
+{
+    _tick_cycles = SysTick->LOAD + 1;
+
+    /* the tick can only be suppressed in light sleep, no deeper mode on this board */
+    rt_system_pm_init(&_ops, 1 << PM_SLEEP_MODE_LIGHT, RT_NULL);
+    rt_pm_request(PM_SLEEP_MODE_LIGHT);
+
+    return 0;
+}
+INIT_BOARD_EXPORT(drv_pm_hw_init);
+
+#endif /* RT_USING_PM */
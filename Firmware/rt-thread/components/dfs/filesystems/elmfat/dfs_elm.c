@@ -15,6 +15,7 @@
  * 2017-02-13     Hichard      Update Fatfs version to 0.12b, support exFAT.
  * 2017-04-11     Bernard      fix the st_blksize issue.
  * 2017-05-26     Urey         fix f_mount error when mount more fats
+ * 2026-10-19     RT-Thread    add the sector cache
  */
 
 #include <rtthread.h>
@@ -28,6 +29,7 @@
 
 #include <dfs_fs.h>
 #include <dfs_file.h>
+#include "dfs_elm.h"
 
 static rt_device_t disk[FF_VOLUMES] = {0};
 
@@ -153,6 +155,10 @@ int dfs_elm_mount(struct dfs_filesystem *fs, unsigned long rwflag, const void *d
         /* mount succeed! */
         fs->data = fat;
         rt_free(dir);
+#ifdef RT_DFS_ELM_USING_CACHE
+        if (elm_cache_attach(index, fs->dev_id) != RT_EOK)
+            rt_kprintf("no sector cache for %s\n", fs->dev_id->parent.name);
+#endif /* RT_DFS_ELM_USING_CACHE */
         return 0;
     }
 
@@ -184,6 +190,11 @@ int dfs_elm_unmount(struct dfs_filesystem *fs)
     if (result != FR_OK)
         return elm_result_to_dfs(result);
 
+#ifdef RT_DFS_ELM_USING_CACHE
+    /* the last sync point of the drive */
+    elm_cache_detach(index);
+#endif /* RT_DFS_ELM_USING_CACHE */
+
     fs->data = RT_NULL;
     disk[index] = RT_NULL;
     rt_free(fat);
@@ -868,6 +879,12 @@ DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
     rt_size_t result;
     rt_device_t device = disk[drv];
 
+#ifdef RT_DFS_ELM_USING_CACHE
+    result = elm_cache_read(drv, buff, sector, count);
+    if (result != (rt_size_t)-1)
+        return (DRESULT)result;
+#endif /* RT_DFS_ELM_USING_CACHE */
+
     result = rt_device_read(device, sector, buff, count);
     if (result == count)
     {
@@ -883,6 +900,12 @@ DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
     rt_size_t result;
     rt_device_t device = disk[drv];
 
+#ifdef RT_DFS_ELM_USING_CACHE
+    result = elm_cache_write(drv, buff, sector, count);
+    if (result != (rt_size_t)-1)
+        return (DRESULT)result;
+#endif /* RT_DFS_ELM_USING_CACHE */
+
     result = rt_device_write(device, sector, buff, count);
     if (result == count)
     {
@@ -931,10 +954,17 @@ DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff)
     }
     else if (ctrl == CTRL_SYNC)
     {
+#ifdef RT_DFS_ELM_USING_CACHE
+        if (elm_cache_sync(drv) != RES_OK)
+            return RES_ERROR;
+#endif /* RT_DFS_ELM_USING_CACHE */
         rt_device_control(device, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
     }
     else if (ctrl == CTRL_TRIM)
     {
+#ifdef RT_DFS_ELM_USING_CACHE
+        elm_cache_trim(drv, ((DWORD *)buff)[0], ((DWORD *)buff)[1]);
+#endif /* RT_DFS_ELM_USING_CACHE */
         rt_device_control(device, RT_DEVICE_CTRL_BLK_ERASE, buff);
     }
 
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2010-02-06     Bernard      Add elm_init function declaration
+ * 2026-10-19     RT-Thread    add the sector cache interface
  */
 
 #ifndef __DFS_ELM_H__
@@ -17,6 +18,33 @@ extern "C" {
 
 int elm_init(void);
 
+#ifdef RT_DFS_ELM_USING_CACHE
+#include <rtthread.h>
+
+struct elm_cache_stat
+{
+    rt_uint32_t hits;                   /* sectors read from the cache */
+    rt_uint32_t misses;                 /* sectors read from the device */
+    rt_uint32_t write_hits;             /* sectors written to the cache */
+    rt_uint32_t dev_reads;              /* read requests to the device */
+    rt_uint32_t dev_writes;             /* write requests to the device */
+    rt_uint32_t dev_read_sectors;
+    rt_uint32_t dev_write_sectors;
+    rt_uint32_t syncs;                  /* sync points */
+};
+
+/* called by dfs_elm.c, the read, write and sync ones return a DRESULT */
+int elm_cache_attach(int drv, rt_device_t dev);
+void elm_cache_detach(int drv);
+int elm_cache_read(int drv, unsigned char *buff, rt_uint32_t sector, unsigned int count);
+int elm_cache_write(int drv, const unsigned char *buff, rt_uint32_t sector, unsigned int count);
+int elm_cache_sync(int drv);
+void elm_cache_trim(int drv, rt_uint32_t start, rt_uint32_t end);
+
+int elm_cache_enable(int drv, rt_bool_t enable);
+int elm_cache_stat(int drv, struct elm_cache_stat *stat);
+#endif /* RT_DFS_ELM_USING_CACHE */
+
 #ifdef __cplusplus
 }
 #endif
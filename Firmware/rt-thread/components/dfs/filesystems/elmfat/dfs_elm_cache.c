@@ -0,0 +1,891 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+/*
+ * Sector cache between ELM FatFs and the block device.
+ *
+ * The cache holds RT_DFS_ELM_CACHE_BLOCKS blocks of RT_DFS_ELM_CACHE_BLOCK_SECTORS
+ * consecutive sectors, each block with a valid and a dirty bit per sector.
+ * Writes stay in the cache until the block is evicted (least recently used)
+ * or until a sync point: CTRL_SYNC from f_sync and f_close, unmount, or the
+ * "elm_cache sync" command. The dirty sectors of a block go to the device in
+ * as few multi-sector writes as possible. A read miss on a sequential stream
+ * reads the rest of the block ahead. Requests larger than a block bypass the
+ * cache, with the cached copies of their sectors kept up to date.
+ */
+
+#include <rtthread.h>
+#include "ffconf.h"
+#include "ff.h"
+#include "diskio.h"
+#include "dfs_elm.h"
+
+#ifdef RT_DFS_ELM_USING_CACHE
+
+#ifndef RT_DFS_ELM_CACHE_BLOCKS
+#define RT_DFS_ELM_CACHE_BLOCKS         4
+#endif
+#ifndef RT_DFS_ELM_CACHE_BLOCK_SECTORS
+#define RT_DFS_ELM_CACHE_BLOCK_SECTORS  4
+#endif
+
+#if RT_DFS_ELM_CACHE_BLOCK_SECTORS > 32
+#error "RT_DFS_ELM_CACHE_BLOCK_SECTORS must not be larger than 32"
+#endif
+
+#define BLOCK_SECTORS                   RT_DFS_ELM_CACHE_BLOCK_SECTORS
+#define SECTOR_MASK(first, num)         ((((num) >= 32) ? 0xFFFFFFFFUL : ((1UL << (num)) - 1)) << (first))
+
+struct elm_cache_block
+{
+    DWORD       block;                  /* sector / BLOCK_SECTORS */
+    rt_uint32_t valid;                  /* a bit per sector */
+    rt_uint32_t dirty;                  /* a bit per sector, always a part of valid */
+    rt_uint32_t stamp;                  /* time of the last use */
+    BYTE       *data;
+};
+
+struct elm_cache
+{
+    rt_device_t dev;                    /* RT_NULL when the drive has no cache */
+    struct rt_mutex lock;
+    rt_bool_t   enabled;
+    rt_size_t   sector_size;
+    DWORD       sector_count;
+    DWORD       next_sector;            /* the sector after the last read, to find a sequential stream */
+    rt_uint32_t clock;
+    struct elm_cache_block blocks[RT_DFS_ELM_CACHE_BLOCKS];
+    struct elm_cache_stat stat;
+};
+
+static struct elm_cache _caches[FF_VOLUMES];
+
+static DRESULT _dev_read(struct elm_cache *cache, BYTE *buff, DWORD sector, UINT count)
+{
+    cache->stat.dev_reads ++;
+    cache->stat.dev_read_sectors += count;
+
+    return rt_device_read(cache->dev, sector, buff, count) == count ? RES_OK : RES_ERROR;
+}
+
+static DRESULT _dev_write(struct elm_cache *cache, const BYTE *buff, DWORD sector, UINT count)
+{
+    cache->stat.dev_writes ++;
+    cache->stat.dev_write_sectors += count;
+
+    return rt_device_write(cache->dev, sector, buff, count) == count ? RES_OK : RES_ERROR;
+}
+
+static struct elm_cache_block *_block_find(struct elm_cache *cache, DWORD block)
+{
+    int index;
+
+    for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+    {
+        if (cache->blocks[index].valid && cache->blocks[index].block == block)
+            return &cache->blocks[index];
+    }
+
+    return RT_NULL;
+}
+
+/* write the runs of dirty sectors in the given mask, one device write a run */
+static DRESULT _block_write_back(struct elm_cache *cache, struct elm_cache_block *blk, rt_uint32_t mask)
+{
+    rt_uint32_t dirty = blk->dirty & mask;
+    int first, num;
+
+    for (first = 0; first < BLOCK_SECTORS; first += num)
+    {
+        num = 1;
+        if (!(dirty & (1UL << first)))
+            continue;
+
+        while (first + num < BLOCK_SECTORS && (dirty & (1UL << (first + num))))
+            num ++;
+
+        if (_dev_write(cache, blk->data + first * cache->sector_size,
+                       blk->block * BLOCK_SECTORS + first, num) != RES_OK)
+            return RES_ERROR;
+        blk->dirty &= ~SECTOR_MASK(first, num);
+    }
+
+    return RES_OK;
+}
+
+/* read the sectors of the mask which are not valid yet, one device read a run */
+static DRESULT _block_fill(struct elm_cache *cache, struct elm_cache_block *blk, rt_uint32_t mask)
+{
+    rt_uint32_t missing = mask & ~blk->valid;
+    int first, num;
+
+    for (first = 0; first < BLOCK_SECTORS; first += num)
+    {
+        num = 1;
+        if (!(missing & (1UL << first)))
+            continue;
+
+        while (first + num < BLOCK_SECTORS && (missing & (1UL << (first + num))))
+            num ++;
+
+        if (_dev_read(cache, blk->data + first * cache->sector_size,
+                      blk->block * BLOCK_SECTORS + first, num) != RES_OK)
+            return RES_ERROR;
+        blk->valid |= SECTOR_MASK(first, num);
+    }
+
+    return RES_OK;
+}
+
+/* get the cache block of a block number, the least recently used one is evicted for it */
+static struct elm_cache_block *_block_get(struct elm_cache *cache, DWORD block)
+{
+    struct elm_cache_block *blk, *victim = RT_NULL;
+    int index;
+
+    blk = _block_find(cache, block);
+    if (blk == RT_NULL)
+    {
+        for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+        {
+            blk = &cache->blocks[index];
+            if (blk->valid == 0)
+            {
+                victim = blk;
+                break;
+            }
+            if (victim == RT_NULL || (rt_int32_t)(blk->stamp - victim->stamp) < 0)
+                victim = blk;
+        }
+
+        if (victim->dirty && _block_write_back(cache, victim, victim->dirty) != RES_OK)
+            return RT_NULL;
+
+        blk = victim;
+        blk->block = block;
+        blk->valid = 0;
+        blk->dirty = 0;
+    }
+
+    blk->stamp = ++ cache->clock;
+
+    return blk;
+}
+
+/* the valid sectors of a block, the last block of the device may be short */
+static rt_uint32_t _block_range(struct elm_cache *cache, DWORD block)
+{
+    DWORD first = block * BLOCK_SECTORS;
+
+    if (cache->sector_count && first + BLOCK_SECTORS > cache->sector_count)
+        return SECTOR_MASK(0, cache->sector_count - first);
+
+    return SECTOR_MASK(0, BLOCK_SECTORS);
+}
+
+static DRESULT _cache_flush(struct elm_cache *cache)
+{
+    struct elm_cache_block *blk;
+    int index;
+
+    /* in the order of the sectors, the device sees one ascending stream */
+    while (1)
+    {
+        blk = RT_NULL;
+        for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+        {
+            if (cache->blocks[index].dirty && (blk == RT_NULL || cache->blocks[index].block < blk->block))
+                blk = &cache->blocks[index];
+        }
+        if (blk == RT_NULL)
+            break;
+
+        if (_block_write_back(cache, blk, blk->dirty) != RES_OK)
+            return RES_ERROR;
+    }
+
+    return RES_OK;
+}
+
+/* a request larger than a block goes to the device in one piece */
+static DRESULT _bypass_read(struct elm_cache *cache, BYTE *buff, DWORD sector, UINT count)
+{
+    struct elm_cache_block *blk;
+    DWORD offset;
+    int index, bit;
+
+    if (_dev_read(cache, buff, sector, count) != RES_OK)
+        return RES_ERROR;
+
+    /* the device does not have the dirty sectors yet */
+    for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+    {
+        blk = &cache->blocks[index];
+        for (bit = 0; blk->dirty && bit < BLOCK_SECTORS; bit ++)
+        {
+            offset = blk->block * BLOCK_SECTORS + bit - sector;
+            if ((blk->dirty & (1UL << bit)) && offset < count)
+            {
+                rt_memcpy(buff + offset * cache->sector_size, blk->data + bit * cache->sector_size,
+                          cache->sector_size);
+            }
+        }
+    }
+
+    return RES_OK;
+}
+
+static DRESULT _bypass_write(struct elm_cache *cache, const BYTE *buff, DWORD sector, UINT count)
+{
+    struct elm_cache_block *blk;
+    DWORD offset;
+    int index, bit;
+
+    if (_dev_write(cache, buff, sector, count) != RES_OK)
+        return RES_ERROR;
+
+    /* keep the cached copies, they are clean now */
+    for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+    {
+        blk = &cache->blocks[index];
+        for (bit = 0; blk->valid && bit < BLOCK_SECTORS; bit ++)
+        {
+            offset = blk->block * BLOCK_SECTORS + bit - sector;
+            if ((blk->valid & (1UL << bit)) && offset < count)
+            {
+                rt_memcpy(blk->data + bit * cache->sector_size, buff + offset * cache->sector_size,
+                          cache->sector_size);
+                blk->dirty &= ~(1UL << bit);
+            }
+        }
+    }
+
+    return RES_OK;
+}
+
+static DRESULT _cache_read(struct elm_cache *cache, BYTE *buff, DWORD sector, UINT count)
+{
+    struct elm_cache_block *blk;
+    rt_uint32_t mask, fill;
+    rt_bool_t sequential = (sector == cache->next_sector);
+    int first, num;
+
+    cache->next_sector = sector + count;
+
+    if (count > BLOCK_SECTORS)
+        return _bypass_read(cache, buff, sector, count);
+
+    while (count)
+    {
+        first = sector % BLOCK_SECTORS;
+        num = BLOCK_SECTORS - first;
+        if (num > count)
+            num = count;
+        mask = SECTOR_MASK(first, num);
+
+        blk = _block_find(cache, sector / BLOCK_SECTORS);
+        if (blk && (blk->valid & mask) == mask)
+        {
+            blk->stamp = ++ cache->clock;
+            cache->stat.hits += num;
+        }
+        else
+        {
+            blk = _block_get(cache, sector / BLOCK_SECTORS);
+            if (blk == RT_NULL)
+                return RES_ERROR;
+
+            /* a sequential stream reads the rest of the block ahead */
+            fill = mask;
+            if (sequential)
+                fill |= SECTOR_MASK(first, BLOCK_SECTORS - first);
+            fill &= _block_range(cache, blk->block);
+
+            cache->stat.misses += num;
+            if (_block_fill(cache, blk, fill) != RES_OK)
+                return RES_ERROR;
+        }
+
+        rt_memcpy(buff, blk->data + first * cache->sector_size, num * cache->sector_size);
+        buff += num * cache->sector_size;
+        sector += num;
+        count -= num;
+    }
+
+    return RES_OK;
+}
+
+static DRESULT _cache_write(struct elm_cache *cache, const BYTE *buff, DWORD sector, UINT count)
+{
+    struct elm_cache_block *blk;
+    rt_uint32_t mask;
+    int first, num;
+
+    if (count > BLOCK_SECTORS)
+        return _bypass_write(cache, buff, sector, count);
+
+    while (count)
+    {
+        first = sector % BLOCK_SECTORS;
+        num = BLOCK_SECTORS - first;
+        if (num > count)
+            num = count;
+        mask = SECTOR_MASK(first, num);
+
+        blk = _block_get(cache, sector / BLOCK_SECTORS);
+        if (blk == RT_NULL)
+            return RES_ERROR;
+
+        rt_memcpy(blk->data + first * cache->sector_size, buff, num * cache->sector_size);
+        blk->valid |= mask;
+        blk->dirty |= mask;
+        cache->stat.write_hits += num;
+
+        buff += num * cache->sector_size;
+        sector += num;
+        count -= num;
+    }
+
+    return RES_OK;
+}
+
+/**
+ * This function creates the cache of a drive, called when it is mounted.
+ *
+ * @param drv is the drive number.
+ *
+ * @param dev is the block device of the drive.
+ *
+ * @return RT_EOK on success, -RT_ENOMEM if there is no memory, the drive
+ *         works without the cache then.
+ */
+int elm_cache_attach(int drv, rt_device_t dev)
+{
+    struct elm_cache *cache = &_caches[drv];
+    struct rt_device_blk_geometry geometry;
+    char name[RT_NAME_MAX];
+    BYTE *data;
+    int index;
+
+    RT_ASSERT(drv >= 0 && drv < FF_VOLUMES);
+    RT_ASSERT(cache->dev == RT_NULL);
+
+    rt_memset(&geometry, 0, sizeof(geometry));
+    if (rt_device_control(dev, RT_DEVICE_CTRL_BLK_GETGEOME, &geometry) != RT_EOK ||
+        geometry.bytes_per_sector == 0)
+        return -RT_ERROR;
+
+    data = (BYTE *)rt_malloc(RT_DFS_ELM_CACHE_BLOCKS * BLOCK_SECTORS * geometry.bytes_per_sector);
+    if (data == RT_NULL)
+        return -RT_ENOMEM;
+
+    rt_memset(cache, 0, sizeof(*cache));
+    for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+        cache->blocks[index].data = data + index * BLOCK_SECTORS * geometry.bytes_per_sector;
+
+    rt_snprintf(name, sizeof(name), "elmc%d", drv);
+    rt_mutex_init(&cache->lock, name, RT_IPC_FLAG_PRIO);
+    cache->sector_size = geometry.bytes_per_sector;
+    cache->sector_count = geometry.sector_count;
+    cache->next_sector = (DWORD)-1;
+    cache->enabled = RT_TRUE;
+    cache->dev = dev;
+
+    return RT_EOK;
+}
+
+/**
+ * This function writes back and releases the cache of a drive, called when it
+ * is unmounted.
+ *
+ * @param drv is the drive number.
+ */
+void elm_cache_detach(int drv)
+{
+    struct elm_cache *cache = &_caches[drv];
+
+    RT_ASSERT(drv >= 0 && drv < FF_VOLUMES);
+
+    if (cache->dev == RT_NULL)
+        return;
+
+    rt_mutex_take(&cache->lock, RT_WAITING_FOREVER);
+    if (_cache_flush(cache) != RES_OK)
+        rt_kprintf("elm cache: write back of drive %d failed, data lost\n", drv);
+    rt_device_control(cache->dev, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+    cache->dev = RT_NULL;
+    rt_mutex_release(&cache->lock);
+
+    rt_mutex_detach(&cache->lock);
+    rt_free(cache->blocks[0].data);
+}
+
+/* the disk_read of a drive with a cache, -1 if the drive has no cache */
+int elm_cache_read(int drv, unsigned char *buff, rt_uint32_t sector, unsigned int count)
+{
+    struct elm_cache *cache = &_caches[drv];
+    DRESULT result;
+
+    if (cache->dev == RT_NULL)
+        return -1;
+
+    rt_mutex_take(&cache->lock, RT_WAITING_FOREVER);
+    if (cache->enabled)
+        result = _cache_read(cache, buff, sector, count);
+    else
+        result = _dev_read(cache, buff, sector, count);
+    rt_mutex_release(&cache->lock);
+
+    return result;
+}
+
+/* the disk_write of a drive with a cache, -1 if the drive has no cache */
+int elm_cache_write(int drv, const unsigned char *buff, rt_uint32_t sector, unsigned int count)
+{
+    struct elm_cache *cache = &_caches[drv];
+    DRESULT result;
+
+    if (cache->dev == RT_NULL)
+        return -1;
+
+    rt_mutex_take(&cache->lock, RT_WAITING_FOREVER);
+    if (cache->enabled)
+        result = _cache_write(cache, buff, sector, count);
+    else
+        result = _dev_write(cache, buff, sector, count);
+    rt_mutex_release(&cache->lock);
+
+    return result;
+}
+
+/**
+ * This function writes the dirty sectors of a drive back to the device.
+ *
+ * @param drv is the drive number.
+ *
+ * @return RES_OK on success, RES_ERROR if the device failed.
+ */
+int elm_cache_sync(int drv)
+{
+    struct elm_cache *cache = &_caches[drv];
+    DRESULT result;
+
+    if (cache->dev == RT_NULL)
+        return RES_OK;
+
+    rt_mutex_take(&cache->lock, RT_WAITING_FOREVER);
+    cache->stat.syncs ++;
+    result = _cache_flush(cache);
+    rt_mutex_release(&cache->lock);
+
+    return result;
+}
+
+/* drop the cached sectors from start to end, they are erased on the device */
+void elm_cache_trim(int drv, rt_uint32_t start, rt_uint32_t end)
+{
+    struct elm_cache *cache = &_caches[drv];
+    struct elm_cache_block *blk;
+    DWORD sector;
+    int index, bit;
+
+    if (cache->dev == RT_NULL)
+        return;
+
+    rt_mutex_take(&cache->lock, RT_WAITING_FOREVER);
+    for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+    {
+        blk = &cache->blocks[index];
+        for (bit = 0; blk->valid && bit < BLOCK_SECTORS; bit ++)
+        {
+            sector = blk->block * BLOCK_SECTORS + bit;
+            if (sector >= start && sector <= end)
+            {
+                blk->valid &= ~(1UL << bit);
+                blk->dirty &= ~(1UL << bit);
+            }
+        }
+    }
+    rt_mutex_release(&cache->lock);
+}
+
+/**
+ * This function turns the cache of a drive on or off, the dirty sectors are
+ * written back before it is turned off.
+ *
+ * @param drv is the drive number.
+ *
+ * @param enable is RT_TRUE to use the cache.
+ *
+ * @return RT_EOK on success, -RT_EINVAL if the drive has no cache, -RT_EIO
+ *         if the write back failed.
+ */
+int elm_cache_enable(int drv, rt_bool_t enable)
+{
+    struct elm_cache *cache;
+    int result = RT_EOK;
+    int index;
+
+    if (drv < 0 || drv >= FF_VOLUMES || _caches[drv].dev == RT_NULL)
+        return -RT_EINVAL;
+
+    cache = &_caches[drv];
+    rt_mutex_take(&cache->lock, RT_WAITING_FOREVER);
+    if (!enable && cache->enabled)
+    {
+        if (_cache_flush(cache) != RES_OK)
+            result = -RT_EIO;
+        for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+        {
+            if (cache->blocks[index].dirty == 0)
+                cache->blocks[index].valid = 0;
+        }
+    }
+    if (result == RT_EOK)
+        cache->enabled = enable;
+    rt_mutex_release(&cache->lock);
+
+    return result;
+}
+
+/**
+ * This function gets the statistics of the cache of a drive.
+ *
+ * @param drv is the drive number.
+ *
+ * @param stat is the buffer of the statistics.
+ *
+ * @return RT_EOK on success, -RT_EINVAL if the drive has no cache.
+ */
+int elm_cache_stat(int drv, struct elm_cache_stat *stat)
+{
+    if (drv < 0 || drv >= FF_VOLUMES || _caches[drv].dev == RT_NULL)
+        return -RT_EINVAL;
+
+    rt_mutex_take(&_caches[drv].lock, RT_WAITING_FOREVER);
+    *stat = _caches[drv].stat;
+    rt_mutex_release(&_caches[drv].lock);
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+
+static int elm_cache_show(int argc, char **argv)
+{
+    struct elm_cache_stat stat;
+    struct elm_cache *cache;
+    int drv, index, dirty;
+
+    rt_kprintf("drive device   state hits     misses   writes   dev reads dev writes syncs    dirty\n");
+    rt_kprintf("----- -------- ----- -------- -------- -------- --------- ---------- -------- -----\n");
+    for (drv = 0; drv < FF_VOLUMES; drv ++)
+    {
+        cache = &_caches[drv];
+        if (elm_cache_stat(drv, &stat) != RT_EOK)
+            continue;
+
+        dirty = 0;
+        for (index = 0; index < RT_DFS_ELM_CACHE_BLOCKS; index ++)
+        {
+            rt_uint32_t bits = cache->blocks[index].dirty;
+
+            for (; bits; bits &= bits - 1)
+                dirty ++;
+        }
+
+        rt_kprintf("%-5d %-8s %-5s %-8d %-8d %-8d %-9d %-10d %-8d %-5d\n", drv,
+                   cache->dev->parent.name, cache->enabled ? "on" : "off", stat.hits, stat.misses,
+                   stat.write_hits, stat.dev_reads, stat.dev_writes, stat.syncs, dirty);
+    }
+    rt_kprintf("%d blocks of %d sectors a drive\n", RT_DFS_ELM_CACHE_BLOCKS, BLOCK_SECTORS);
+
+    return 0;
+}
+
+static int elm_cache_cmd_sync(int argc, char **argv)
+{
+    int drv;
+
+    for (drv = 0; drv < FF_VOLUMES; drv ++)
+    {
+        if (_caches[drv].dev && elm_cache_sync(drv) != RES_OK)
+            rt_kprintf("sync of drive %d failed\n", drv);
+        else if (_caches[drv].dev)
+            rt_device_control(_caches[drv].dev, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+    }
+
+    return 0;
+}
+
+static int elm_cache_cmd_enable(int argc, char **argv)
+{
+    rt_bool_t enable = (rt_strcmp(argv[1], "on") == 0);
+    int drv;
+
+    for (drv = 0; drv < FF_VOLUMES; drv ++)
+    {
+        if (_caches[drv].dev && elm_cache_enable(drv, enable) != RT_EOK)
+            rt_kprintf("drive %d: failed\n", drv);
+    }
+
+    return 0;
+}
+
+#ifdef RT_DFS_ELM_CACHE_USING_BENCH
+#include <unistd.h>
+#include <fcntl.h>
+
+#define _BENCH_LINES_PER_SYNC   32
+
+/* a block device in RAM, to run the bench on the posix simulator or without a card */
+struct _ram_disk
+{
+    struct rt_device parent;
+    rt_uint8_t *data;
+    rt_size_t sectors;
+};
+
+static struct _ram_disk _ram_disk;
+
+static rt_size_t _ram_disk_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct _ram_disk *disk = (struct _ram_disk *)dev;
+
+    if (pos + size > disk->sectors)
+        return 0;
+    rt_memcpy(buffer, disk->data + pos * 512, size * 512);
+
+    return size;
+}
+
+static rt_size_t _ram_disk_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct _ram_disk *disk = (struct _ram_disk *)dev;
+
+    if (pos + size > disk->sectors)
+        return 0;
+    rt_memcpy(disk->data + pos * 512, buffer, size * 512);
+
+    return size;
+}
+
+static rt_err_t _ram_disk_control(rt_device_t dev, int cmd, void *args)
+{
+    struct _ram_disk *disk = (struct _ram_disk *)dev;
+    struct rt_device_blk_geometry *geometry;
+
+    if (cmd == RT_DEVICE_CTRL_BLK_GETGEOME)
+    {
+        geometry = (struct rt_device_blk_geometry *)args;
+        geometry->bytes_per_sector = 512;
+        geometry->block_size = 512;
+        geometry->sector_count = disk->sectors;
+    }
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+static const struct rt_device_ops _ram_disk_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    _ram_disk_read,
+    _ram_disk_write,
+    _ram_disk_control
+};
+#endif
+
+static int elm_cache_ramdisk(int argc, char **argv)
+{
+    int kbytes = 256;
+
+    if (argc > 2)
+        kbytes = atoi(argv[2]);
+    if (_ram_disk.data)
+    {
+        rt_kprintf("ramdisk is already there\n");
+        return -RT_EBUSY;
+    }
+    if (kbytes < 64)
+    {
+        rt_kprintf("a FAT volume needs 64 KB at least\n");
+        return -RT_EINVAL;
+    }
+
+    _ram_disk.data = rt_malloc(kbytes * 1024);
+    if (_ram_disk.data == RT_NULL)
+    {
+        rt_kprintf("no memory for %d KB\n", kbytes);
+        return -RT_ENOMEM;
+    }
+    rt_memset(_ram_disk.data, 0, kbytes * 1024);
+    _ram_disk.sectors = kbytes * 2;
+
+    _ram_disk.parent.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    _ram_disk.parent.ops = &_ram_disk_ops;
+#else
+    _ram_disk.parent.read = _ram_disk_read;
+    _ram_disk.parent.write = _ram_disk_write;
+    _ram_disk.parent.control = _ram_disk_control;
+#endif
+    rt_device_register(&_ram_disk.parent, "ramdisk", RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_STANDALONE);
+    rt_kprintf("ramdisk: %d KB, mkfs -t elm ramdisk and mount it to run the bench\n", kbytes);
+
+    return 0;
+}
+
+/* append CSV telemetry lines to a file with a sync every few lines, like a data logger */
+static int _bench_append(const char *path, int kbytes, rt_tick_t *ticks)
+{
+    char line[48];
+    int fd, len, total = 0, seq = 0;
+    rt_tick_t start;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd < 0)
+        return -RT_ERROR;
+
+    start = rt_tick_get();
+    while (total < kbytes * 1024)
+    {
+        len = rt_snprintf(line, sizeof(line), "%u,%d,%d.%02d,%d\n", start + seq, seq,
+                          20 + seq % 10, seq * 7 % 100, seq % 3);
+        if (write(fd, line, len) != len)
+        {
+            close(fd);
+            return -RT_EIO;
+        }
+        total += len;
+        seq ++;
+        if (seq % _BENCH_LINES_PER_SYNC == 0)
+            fsync(fd);
+    }
+    close(fd);
+    *ticks = rt_tick_get() - start;
+
+    return total;
+}
+
+static int elm_cache_bench(int argc, char **argv)
+{
+    struct elm_cache_stat before, after;
+    rt_uint32_t reads, writes, read_sectors, write_sectors;
+    rt_tick_t ticks;
+    int kbytes = 64, pass, drv, bytes;
+
+    if (argc < 3)
+    {
+        rt_kprintf("elm_cache bench <file on a FAT volume> [kbytes]\n");
+        return -RT_EINVAL;
+    }
+    if (argc > 3)
+        kbytes = atoi(argv[3]);
+
+    rt_kprintf("append %d KB of CSV lines, fsync every %d lines\n", kbytes, _BENCH_LINES_PER_SYNC);
+    rt_kprintf("cache KB/s     dev reads read sectors dev writes write sectors\n");
+    rt_kprintf("----- -------- --------- ------------ ---------- -------------\n");
+
+    for (pass = 0; pass < 2; pass ++)
+    {
+        for (drv = 0; drv < FF_VOLUMES; drv ++)
+            elm_cache_enable(drv, pass == 1);
+
+        reads = writes = read_sectors = write_sectors = 0;
+        for (drv = 0; drv < FF_VOLUMES; drv ++)
+        {
+            if (elm_cache_stat(drv, &before) != RT_EOK)
+                continue;
+            reads -= before.dev_reads;
+            writes -= before.dev_writes;
+            read_sectors -= before.dev_read_sectors;
+            write_sectors -= before.dev_write_sectors;
+        }
+
+        bytes = _bench_append(argv[2], kbytes, &ticks);
+        if (bytes < 0)
+        {
+            rt_kprintf("write to %s failed\n", argv[2]);
+            break;
+        }
+
+        for (drv = 0; drv < FF_VOLUMES; drv ++)
+        {
+            if (elm_cache_stat(drv, &after) != RT_EOK)
+                continue;
+            reads += after.dev_reads;
+            writes += after.dev_writes;
+            read_sectors += after.dev_read_sectors;
+            write_sectors += after.dev_write_sectors;
+        }
+
+        if (ticks == 0)
+            ticks = 1;
+        rt_kprintf("%-5s %-8d %-9d %-12d %-10d %-13d\n", pass ? "on" : "off",
+                   (rt_uint32_t)((rt_uint64_t)bytes * RT_TICK_PER_SECOND / 1024 / ticks),
+                   reads, read_sectors, writes, write_sectors);
+    }
+    unlink(argv[2]);
+
+    return 0;
+}
+#endif /* RT_DFS_ELM_CACHE_USING_BENCH */
+
+struct elm_cache_cmd_des
+{
+    const char *cmd;
+    int (*fun)(int argc, char **argv);
+};
+
+static const struct elm_cache_cmd_des cmd_tab[] =
+{
+    {"show", elm_cache_show},
+    {"sync", elm_cache_cmd_sync},
+    {"on", elm_cache_cmd_enable},
+    {"off", elm_cache_cmd_enable},
+#ifdef RT_DFS_ELM_CACHE_USING_BENCH
+    {"ramdisk", elm_cache_ramdisk},
+    {"bench", elm_cache_bench},
+#endif
+};
+
+static int elm_cache(int argc, char **argv)
+{
+    int index;
+
+    if (argc < 2)
+        return elm_cache_show(argc, argv);
+
+    for (index = 0; index < sizeof(cmd_tab) / sizeof(cmd_tab[0]); index ++)
+    {
+        if (rt_strcmp(cmd_tab[index].cmd, argv[1]) == 0)
+            return cmd_tab[index].fun(argc, argv);
+    }
+
+    rt_kprintf("Usage:\n");
+    rt_kprintf("elm_cache [show]              - show the cache statistics of the FAT drives\n");
+    rt_kprintf("elm_cache sync                - write the dirty sectors back\n");
+    rt_kprintf("elm_cache on|off              - use or bypass the cache\n");
+#ifdef RT_DFS_ELM_CACHE_USING_BENCH
+    rt_kprintf("elm_cache ramdisk [kbytes]    - register a RAM block device named ramdisk\n");
+    rt_kprintf("elm_cache bench file [kbytes] - append CSV lines with and without the cache\n");
+#endif
+
+    return 0;
+}
+MSH_CMD_EXPORT(elm_cache, FAT sector cache: elm_cache [show|sync|on|off|bench]);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_DFS_ELM_USING_CACHE */
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     RT-Thread    add the RT_FIOMMAP ioctl and dfs_romfs_map
  */
 
 #include <rtthread.h>
@@ -34,7 +35,24 @@ int dfs_romfs_unmount(struct dfs_filesystem *fs)
 
 int dfs_romfs_ioctl(struct dfs_fd *file, int cmd, void *args)
 {
-    return -EIO;
+    struct romfs_dirent *dirent;
+    struct dfs_mmap_region *region;
+
+    if (cmd != RT_FIOMMAP)
+        return -EIO;
+
+    dirent = (struct romfs_dirent *)file->data;
+    region = (struct dfs_mmap_region *)args;
+    if (dirent == NULL || region == NULL)
+        return -EINVAL;
+    if (dirent->type != ROMFS_DIRENT_FILE)
+        return -EISDIR;
+
+    /* the data is in the rom image, it stays valid after close */
+    region->addr = &(dirent->data[file->pos]);
+    region->length = file->size - file->pos;
+
+    return RT_EOK;
 }
 
 rt_inline int check_dirent(struct romfs_dirent *dirent)
@@ -312,6 +330,39 @@ static const struct dfs_filesystem_ops _romfs =
     NULL,
 };
 
+/**
+ * This function gets the address of a romfs file, so that the file can be
+ * used in place without reading it into RAM.
+ *
+ * @param path the path of the file.
+ * @param size the file size returned.
+ *
+ * @return the address of the file data, or RT_NULL if the file is not found
+ *         or is not on a romfs.
+ */
+const void *dfs_romfs_map(const char *path, rt_size_t *size)
+{
+    struct dfs_fd fd;
+    struct dfs_mmap_region region;
+    int result;
+
+    if (dfs_file_open(&fd, path, O_RDONLY) < 0)
+        return RT_NULL;
+
+    result = -EIO;
+    /* other file systems may use the same ioctl number for their own */
+    if (fd.fops->ioctl == dfs_romfs_ioctl)
+        result = dfs_file_ioctl(&fd, RT_FIOMMAP, &region);
+    dfs_file_close(&fd);
+
+    if (result != RT_EOK)
+        return RT_NULL;
+
+    if (size)
+        *size = region.length;
+    return region.addr;
+}
+
 int dfs_romfs_init(void)
 {
     /* register rom file system */
@@ -320,3 +371,177 @@ int dfs_romfs_init(void)
 }
 INIT_COMPONENT_EXPORT(dfs_romfs_init);
 
+
+#if defined(RT_USING_FINSH) && defined(RT_DFS_ROMFS_USING_BENCH)
+#include <stdlib.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()    ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT     "cycles"
+#else
+#define _BENCH_NOW()    ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT     "ticks"
+#endif
+
+#define ROMFS_BENCH_FILE    "/regmap.csv"
+
+/* parse the "address,name,type,access,default" lines of a register map */
+static rt_uint32_t romfs_regmap_parse(const char *text, rt_size_t length, rt_uint32_t *sum)
+{
+    rt_uint32_t count = 0, field = 0, value = 0, address = 0;
+    rt_bool_t numeric = RT_TRUE;
+    rt_size_t index;
+
+    *sum = 0;
+    for (index = 0; index < length; index ++)
+    {
+        char ch = text[index];
+
+        if (ch == '\n')
+        {
+            /* skip the header and the broken lines */
+            if (field == 4 && numeric)
+            {
+                *sum += address + value;
+                count ++;
+            }
+            field = 0;
+            value = 0;
+            numeric = RT_TRUE;
+        }
+        else if (ch == ',')
+        {
+            if (field == 0)
+                address = value;
+            field ++;
+            value = 0;
+        }
+        else if (field == 0 || field == 4)
+        {
+            if (ch >= '0' && ch <= '9')
+                value = value * 10 + (ch - '0');
+            else
+                numeric = RT_FALSE;
+        }
+    }
+
+    return count;
+}
+
+static int romfs_map_show(int argc, char **argv)
+{
+    const char *path = argc > 2 ? argv[2] : ROMFS_BENCH_FILE;
+    const char *data;
+    rt_size_t size, line;
+
+    data = (const char *)dfs_romfs_map(path, &size);
+    if (data == RT_NULL)
+    {
+        rt_kprintf("%s is not a file on romfs\n", path);
+        return -RT_ERROR;
+    }
+
+    for (line = 0; line < size && data[line] != '\n' && line < 64; line ++);
+    rt_kprintf("%s: %d bytes at 0x%08x\n", path, size, data);
+    if (line > 0)
+        rt_kprintf("%.*s\n", line, data);
+
+    return 0;
+}
+
+static int romfs_map_bench(int argc, char **argv)
+{
+    const char *path = argc > 2 ? argv[2] : ROMFS_BENCH_FILE;
+    int loops = argc > 3 ? atoi(argv[3]) : 100;
+    rt_uint32_t begin, copy_time, map_time, count, sum, map_sum = 0;
+    struct dfs_fd fd;
+    const char *data;
+    char *buf;
+    rt_size_t size;
+    int index;
+
+    data = (const char *)dfs_romfs_map(path, &size);
+    if (data == RT_NULL)
+    {
+        rt_kprintf("%s is not a file on romfs\n", path);
+        return -RT_ERROR;
+    }
+    if (loops <= 0)
+        loops = 1;
+
+    /* the way of the config loaders today: read the file into a heap buffer */
+    count = 0;
+    begin = _BENCH_NOW();
+    for (index = 0; index < loops; index ++)
+    {
+        buf = (char *)rt_malloc(size);
+        if (buf == RT_NULL)
+        {
+            rt_kprintf("no memory for a %d bytes copy\n", size);
+            return -RT_ENOMEM;
+        }
+        if (dfs_file_open(&fd, path, O_RDONLY) < 0)
+        {
+            rt_free(buf);
+            return -RT_ERROR;
+        }
+        dfs_file_read(&fd, buf, size);
+        dfs_file_close(&fd);
+
+        count = romfs_regmap_parse(buf, size, &sum);
+        rt_free(buf);
+    }
+    copy_time = _BENCH_NOW() - begin;
+
+    begin = _BENCH_NOW();
+    for (index = 0; index < loops; index ++)
+    {
+        data = (const char *)dfs_romfs_map(path, &size);
+        romfs_regmap_parse(data, size, &map_sum);
+    }
+    map_time = _BENCH_NOW() - begin;
+
+    rt_kprintf("%s: %d bytes, %d registers, %d loops\n", path, size, count, loops);
+    rt_kprintf("read + parse: %10u %s, %d bytes of RAM\n", copy_time, _BENCH_UNIT, size);
+    rt_kprintf("map  + parse: %10u %s, 0 bytes of RAM\n", map_time, _BENCH_UNIT);
+    if (sum != map_sum)
+        rt_kprintf("the parsed results differ!\n");
+
+    return 0;
+}
+
+struct romfs_map_cmd_des
+{
+    const char *cmd;
+    int (*fun)(int argc, char **argv);
+};
+
+static const struct romfs_map_cmd_des cmd_tab[] =
+{
+    {"show", romfs_map_show},
+    {"bench", romfs_map_bench},
+};
+
+static int romfs_map(int argc, char **argv)
+{
+    int index;
+
+    if (argc >= 2)
+    {
+        for (index = 0; index < sizeof(cmd_tab) / sizeof(cmd_tab[0]); index ++)
+        {
+            if (rt_strcmp(cmd_tab[index].cmd, argv[1]) == 0)
+                return cmd_tab[index].fun(argc, argv);
+        }
+    }
+
+    rt_kprintf("Usage:\n");
+    rt_kprintf("romfs_map show [file]          - show the address of a romfs file\n");
+    rt_kprintf("romfs_map bench [file] [loops] - load a register map by read and by map\n");
+    rt_kprintf("the default file is %s\n", ROMFS_BENCH_FILE);
+
+    return 0;
+}
+MSH_CMD_EXPORT(romfs_map, romfs in place access: romfs_map [show|bench]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_DFS_ROMFS_USING_BENCH) */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019/01/13     Bernard      code cleanup
+ * 2026-10-19     RT-Thread    add dfs_romfs_map
  */
 
 #ifndef __DFS_ROMFS_H__
@@ -26,6 +27,7 @@ struct romfs_dirent
 };
 
 int dfs_romfs_init(void);
+const void *dfs_romfs_map(const char *path, rt_size_t *size);
 extern const struct romfs_dirent romfs_root;
 
 #endif
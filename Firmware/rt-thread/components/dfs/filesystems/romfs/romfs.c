@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     RT-Thread    add the register map of the romfs_map bench
  */
 
 #include <rtthread.h>
@@ -25,10 +26,26 @@ const static unsigned char _dummy_txt[] =
     0x74, 0x68, 0x69, 0x73, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x66, 0x69, 0x6c, 0x65, 0x21, 0x0d, 0x0a,
 };
 
+#ifdef RT_DFS_ROMFS_USING_BENCH
+/* 400 holding registers, "address,name,type,access,default" a line */
+#define _REG(n)         #n ",holding_" #n ",u16,rw," #n "\n"
+#define _REG_10(n)      _REG(n##0) _REG(n##1) _REG(n##2) _REG(n##3) _REG(n##4) \
+                        _REG(n##5) _REG(n##6) _REG(n##7) _REG(n##8) _REG(n##9)
+#define _REG_100(n)     _REG_10(n##0) _REG_10(n##1) _REG_10(n##2) _REG_10(n##3) _REG_10(n##4) \
+                        _REG_10(n##5) _REG_10(n##6) _REG_10(n##7) _REG_10(n##8) _REG_10(n##9)
+
+const static char _regmap_csv[] =
+    "address,name,type,access,default\n"
+    _REG_100(40) _REG_100(41) _REG_100(42) _REG_100(43);
+#endif /* RT_DFS_ROMFS_USING_BENCH */
+
 RT_WEAK const struct romfs_dirent _root_dirent[] =
 {
     {ROMFS_DIRENT_DIR, "dummy", (rt_uint8_t *)_dummy, sizeof(_dummy) / sizeof(_dummy[0])},
     {ROMFS_DIRENT_FILE, "dummy.txt", _dummy_txt, sizeof(_dummy_txt)},
+#ifdef RT_DFS_ROMFS_USING_BENCH
+    {ROMFS_DIRENT_FILE, "regmap.csv", (rt_uint8_t *)_regmap_csv, sizeof(_regmap_csv) - 1},
+#endif /* RT_DFS_ROMFS_USING_BENCH */
 };
 
 RT_WEAK const struct romfs_dirent romfs_root =
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2005-01-26     Bernard      The first version.
+ * 2026-10-19     RT-Thread    add RT_FIOMMAP
  */
 
 #ifndef __DFS_FILE_H__
@@ -70,6 +71,16 @@ int dfs_file_ftruncate(struct dfs_fd *fd, off_t length);
 
 /* 0x5254 is just a magic number to make these relatively unique ("RT") */
 #define RT_FIOFTRUNCATE 0x52540000U
+/* get the address of the file data from the current position, the args is a
+ * struct dfs_mmap_region. Only for the file systems keeping the data in the
+ * memory mapped storage, such as romfs. */
+#define RT_FIOMMAP      0x52540001U
+
+struct dfs_mmap_region
+{
+    const void *addr;   /* the file data at the current position */
+    size_t      length; /* the bytes from the current position to the end */
+};
 
 #ifdef __cplusplus
 }
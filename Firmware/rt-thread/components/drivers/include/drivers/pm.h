@@ -10,6 +10,7 @@
  * 2019-04-28     Zero-Free    improve PM mode and device ops interface
  * 2020-11-23     zhangsz      update pm mode select
  * 2020-11-27     zhangsz      update pm 2.0
+ * 2026-10-19     RT-Thread    add sleep statistics
  */
 
 #ifndef __PM_H__
@@ -226,4 +227,18 @@ void rt_pm_sleep_idle_release(rt_uint16_t module_id);
 void rt_pm_sleep_light_request(rt_uint16_t module_id);
 void rt_pm_sleep_light_release(rt_uint16_t module_id);
 
+#ifdef PM_ENABLE_STATISTICS
+/* sleep statistics, the time is counted in ticks */
+struct rt_pm_stat
+{
+    rt_uint32_t sleep_count[PM_SLEEP_MODE_MAX];     /* times of entering each mode */
+    rt_tick_t   sleep_ticks[PM_SLEEP_MODE_MAX];     /* time spent in each mode */
+    rt_uint32_t wakeups;                            /* times of waking up */
+    rt_tick_t   start_tick;                         /* tick of the last reset */
+};
+
+void rt_pm_stat_get(struct rt_pm_stat *stat);
+void rt_pm_stat_reset(void);
+#endif
+
 #endif /* __PM_H__ */
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2021-08-01     Meco Man     remove rt_delayed_work_init() and rt_delayed_work structure
  * 2021-08-14     Jackistang   add comments for rt_work_init()
+ * 2026-10-19     RT-Thread    add the worker pool mode
  */
 #ifndef WORKQUEUE_H__
 #define WORKQUEUE_H__
@@ -27,6 +28,30 @@ enum
     RT_WORK_TYPE_DELAYED     = 0x0001,
 };
 
+#ifdef RT_WORKQUEUE_USING_POOL
+#define RT_WORK_PRIORITY_DEFAULT    128     /* the lower value is executed first */
+
+struct rt_workqueue_worker
+{
+    struct rt_workqueue *queue;
+    rt_thread_t    thread;
+    struct rt_work *work_current;           /* the work of this worker */
+    rt_list_t      wait_list;               /* cancel_work_sync callers waiting for it */
+};
+
+struct rt_workqueue_stat
+{
+    rt_uint32_t    done;                    /* works executed */
+    rt_uint16_t    depth;                   /* works waiting for a worker now */
+    rt_uint16_t    max_depth;               /* the most works waiting */
+    rt_uint16_t    busy;                    /* workers executing a work now */
+    rt_uint16_t    max_busy;                /* the most workers executing */
+    rt_tick_t      exec_total;              /* ticks of executing the works */
+    rt_tick_t      exec_max;                /* the longest work */
+    rt_tick_t      wait_max;                /* the longest time from queued to executed */
+};
+#endif /* RT_WORKQUEUE_USING_POOL */
+
 /* workqueue implementation */
 struct rt_workqueue
 {
@@ -36,6 +61,11 @@ struct rt_workqueue
 
     struct rt_semaphore sem;
     rt_thread_t    work_thread;
+#ifdef RT_WORKQUEUE_USING_POOL
+    rt_uint8_t     worker_num;
+    struct rt_workqueue_worker *workers;
+    struct rt_workqueue_stat stat;
+#endif /* RT_WORKQUEUE_USING_POOL */
 };
 
 struct rt_work
@@ -48,6 +78,10 @@ struct rt_work
     rt_uint16_t type;
     struct rt_timer timer;
     struct rt_workqueue *workqueue;
+#ifdef RT_WORKQUEUE_USING_POOL
+    rt_uint8_t priority;
+    rt_tick_t queued_tick;
+#endif /* RT_WORKQUEUE_USING_POOL */
 };
 
 #ifdef RT_USING_HEAP
@@ -64,6 +98,14 @@ rt_err_t rt_workqueue_cancel_work_sync(struct rt_workqueue *queue, struct rt_wor
 rt_err_t rt_workqueue_cancel_all_work(struct rt_workqueue *queue);
 rt_err_t rt_workqueue_urgent_work(struct rt_workqueue *queue, struct rt_work *work);
 
+#ifdef RT_WORKQUEUE_USING_POOL
+struct rt_workqueue *rt_workqueue_create_pool(const char *name, rt_uint16_t stack_size,
+                                              rt_uint8_t priority, rt_uint8_t workers);
+void rt_work_set_priority(struct rt_work *work, rt_uint8_t priority);
+rt_err_t rt_workqueue_get_stat(struct rt_workqueue *queue, struct rt_workqueue_stat *stat);
+void rt_workqueue_reset_stat(struct rt_workqueue *queue);
+#endif /* RT_WORKQUEUE_USING_POOL */
+
 #ifdef RT_USING_SYSTEM_WORKQUEUE
 rt_err_t rt_work_submit(struct rt_work *work, rt_tick_t ticks);
 rt_err_t rt_work_urgent(struct rt_work *work);
@@ -9,6 +9,7 @@
  * 2021-08-01     Meco Man     remove rt_delayed_work_init()
  * 2021-08-14     Jackistang   add comments for function interface
  * 2022-01-16     Meco Man     add rt_work_urgent()
+ * 2026-10-19     RT-Thread    add the worker pool mode with priorities and statistics
  */
 
 #include <rthw.h>
@@ -50,13 +51,127 @@ rt_inline rt_err_t _workqueue_work_completion(struct rt_workqueue *queue)
     return result;
 }
 
+#ifdef RT_WORKQUEUE_USING_POOL
+/* a cancel_work_sync caller, on its own stack until the worker completes it */
+struct _workqueue_waiter
+{
+    rt_list_t list;
+    struct rt_completion done;
+};
+
+static struct rt_workqueue_worker *_workqueue_find_worker(struct rt_workqueue *queue, struct rt_work *work)
+{
+    int index;
+
+    for (index = 0; index < queue->worker_num; index ++)
+    {
+        if (queue->workers[index].work_current == work)
+            return &(queue->workers[index]);
+    }
+
+    return RT_NULL;
+}
+
+rt_inline rt_bool_t _workqueue_is_current(struct rt_workqueue *queue, struct rt_work *work)
+{
+    return _workqueue_find_worker(queue, work) != RT_NULL;
+}
+
+/* insert the work after the works of the same or a higher priority */
+static void _workqueue_insert_work(struct rt_workqueue *queue, struct rt_work *work)
+{
+    rt_list_t *node;
+
+    for (node = queue->work_list.prev; node != &(queue->work_list); node = node->prev)
+    {
+        if (rt_list_entry(node, struct rt_work, list)->priority <= work->priority)
+            break;
+    }
+    rt_list_insert_after(node, &(work->list));
+
+    work->queued_tick = rt_tick_get();
+    if (++ queue->stat.depth > queue->stat.max_depth)
+        queue->stat.max_depth = queue->stat.depth;
+}
+
+/* resume an idle worker, the interrupt is disabled by the caller */
+static void _workqueue_kick(struct rt_workqueue *queue, rt_base_t level)
+{
+    struct rt_workqueue_worker *worker;
+    int index;
+
+    for (index = 0; index < queue->worker_num; index ++)
+    {
+        worker = &(queue->workers[index]);
+        if (worker->work_current == RT_NULL &&
+            ((worker->thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_SUSPEND))
+        {
+            rt_thread_resume(worker->thread);
+            rt_hw_interrupt_enable(level);
+            rt_schedule();
+            return;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+}
+#else
+rt_inline rt_bool_t _workqueue_is_current(struct rt_workqueue *queue, struct rt_work *work)
+{
+    return queue->work_current == work;
+}
+
+rt_inline void _workqueue_insert_work(struct rt_workqueue *queue, struct rt_work *work)
+{
+    rt_list_insert_after(queue->work_list.prev, &(work->list));
+}
+
+/* resume the work thread, the interrupt is disabled by the caller */
+static void _workqueue_kick(struct rt_workqueue *queue, rt_base_t level)
+{
+    /* whether the workqueue is doing work */
+    if (queue->work_current == RT_NULL &&
+        ((queue->work_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_SUSPEND))
+    {
+        /* resume work thread */
+        rt_thread_resume(queue->work_thread);
+        rt_hw_interrupt_enable(level);
+        rt_schedule();
+    }
+    else
+    {
+        rt_hw_interrupt_enable(level);
+    }
+}
+#endif /* RT_WORKQUEUE_USING_POOL */
+
+/* take the work out of its list, the interrupt is disabled by the caller */
+rt_inline void _workqueue_unlink_work(struct rt_work *work)
+{
+    rt_list_remove(&(work->list));
+#ifdef RT_WORKQUEUE_USING_POOL
+    if ((work->flags & RT_WORK_STATE_PENDING) && work->workqueue != RT_NULL)
+        work->workqueue->stat.depth --;
+#endif /* RT_WORKQUEUE_USING_POOL */
+    work->flags &= ~RT_WORK_STATE_PENDING;
+}
+
 static void _workqueue_thread_entry(void *parameter)
 {
     rt_base_t level;
     struct rt_work *work;
     struct rt_workqueue *queue;
-
+    struct rt_work **current;
+#ifdef RT_WORKQUEUE_USING_POOL
+    struct rt_workqueue_worker *worker;
+    rt_tick_t tick;
+
+    worker = (struct rt_workqueue_worker *) parameter;
+    queue = worker->queue;
+    current = &(worker->work_current);
+#else
     queue = (struct rt_workqueue *) parameter;
+    current = &(queue->work_current);
+#endif /* RT_WORKQUEUE_USING_POOL */
     RT_ASSERT(queue != RT_NULL);
 
     while (1)
@@ -73,19 +188,48 @@ static void _workqueue_thread_entry(void *parameter)
 
         /* we have work to do with. */
         work = rt_list_entry(queue->work_list.next, struct rt_work, list);
-        rt_list_remove(&(work->list));
-        queue->work_current = work;
-        work->flags &= ~RT_WORK_STATE_PENDING;
+        _workqueue_unlink_work(work);
+        *current = work;
         work->workqueue = RT_NULL;
+#ifdef RT_WORKQUEUE_USING_POOL
+        tick = rt_tick_get();
+        if (tick - work->queued_tick > queue->stat.wait_max)
+            queue->stat.wait_max = tick - work->queued_tick;
+        if (++ queue->stat.busy > queue->stat.max_busy)
+            queue->stat.max_busy = queue->stat.busy;
+#endif /* RT_WORKQUEUE_USING_POOL */
         rt_hw_interrupt_enable(level);
 
         /* do work */
         work->work_func(work, work->work_data);
+
+#ifdef RT_WORKQUEUE_USING_POOL
+        /* the work may be freed by itself, only the tick is used */
+        level = rt_hw_interrupt_disable();
+        tick = rt_tick_get() - tick;
+        queue->stat.done ++;
+        queue->stat.exec_total += tick;
+        if (tick > queue->stat.exec_max)
+            queue->stat.exec_max = tick;
+        queue->stat.busy --;
+        *current = RT_NULL;
+        /* wake the waiters up, each one returns after its node is removed */
+        while (!rt_list_isempty(&(worker->wait_list)))
+        {
+            struct _workqueue_waiter *waiter;
+
+            waiter = rt_list_first_entry(&(worker->wait_list), struct _workqueue_waiter, list);
+            rt_list_remove(&(waiter->list));
+            rt_completion_done(&(waiter->done));
+        }
+        rt_hw_interrupt_enable(level);
+#else
         /* clean current work */
-        queue->work_current = RT_NULL;
+        *current = RT_NULL;
 
         /* ack work completion */
         _workqueue_work_completion(queue);
+#endif /* RT_WORKQUEUE_USING_POOL */
     }
 }
 
@@ -97,14 +241,13 @@ static rt_err_t _workqueue_submit_work(struct rt_workqueue *queue,
 
     level = rt_hw_interrupt_disable();
     /* remove list */
-    rt_list_remove(&(work->list));
-    work->flags &= ~RT_WORK_STATE_PENDING;
+    _workqueue_unlink_work(work);
 
     if (ticks == 0)
     {
-        if (queue->work_current != work)
+        if (!_workqueue_is_current(queue, work))
         {
-            rt_list_insert_after(queue->work_list.prev, &(work->list));
+            _workqueue_insert_work(queue, work);
             work->flags |= RT_WORK_STATE_PENDING;
             work->workqueue = queue;
             err = RT_EOK;
@@ -114,19 +257,7 @@ static rt_err_t _workqueue_submit_work(struct rt_workqueue *queue,
             err = -RT_EBUSY;
         }
 
-        /* whether the workqueue is doing work */
-        if (queue->work_current == RT_NULL &&
-            ((queue->work_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_SUSPEND))
-        {
-            /* resume work thread */
-            rt_thread_resume(queue->work_thread);
-            rt_hw_interrupt_enable(level);
-            rt_schedule();
-        }
-        else
-        {
-            rt_hw_interrupt_enable(level);
-        }
+        _workqueue_kick(queue, level);
         return err;
     }
     else if (ticks < RT_TICK_MAX / 2)
@@ -160,8 +291,7 @@ static rt_err_t _workqueue_cancel_work(struct rt_workqueue *queue, struct rt_wor
     rt_err_t err;
 
     level = rt_hw_interrupt_disable();
-    rt_list_remove(&(work->list));
-    work->flags &= ~RT_WORK_STATE_PENDING;
+    _workqueue_unlink_work(work);
     /* Timer started */
     if (work->flags & RT_WORK_STATE_SUBMITTING)
     {
@@ -169,7 +299,7 @@ static rt_err_t _workqueue_cancel_work(struct rt_workqueue *queue, struct rt_wor
         rt_timer_detach(&(work->timer));
         work->flags &= ~RT_WORK_STATE_SUBMITTING;
     }
-    err = queue->work_current != work ? RT_EOK : -RT_EBUSY;
+    err = !_workqueue_is_current(queue, work) ? RT_EOK : -RT_EBUSY;
     work->workqueue = RT_NULL;
     rt_hw_interrupt_enable(level);
     return err;
@@ -191,24 +321,12 @@ static void _delayed_work_timeout_handler(void *parameter)
     /* remove delay list */
     rt_list_remove(&(work->list));
     /* insert work queue */
-    if (queue->work_current != work)
+    if (!_workqueue_is_current(queue, work))
     {
-        rt_list_insert_after(queue->work_list.prev, &(work->list));
+        _workqueue_insert_work(queue, work);
         work->flags |= RT_WORK_STATE_PENDING;
     }
-    /* whether the workqueue is doing work */
-    if (queue->work_current == RT_NULL &&
-        ((queue->work_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_SUSPEND))
-    {
-        /* resume work thread */
-        rt_thread_resume(queue->work_thread);
-        rt_hw_interrupt_enable(level);
-        rt_schedule();
-    }
-    else
-    {
-        rt_hw_interrupt_enable(level);
-    }
+    _workqueue_kick(queue, level);
 }
 
 /**
@@ -233,7 +351,151 @@ void rt_work_init(struct rt_work *work,
     work->workqueue = RT_NULL;
     work->flags = 0;
     work->type = 0;
+#ifdef RT_WORKQUEUE_USING_POOL
+    work->priority = RT_WORK_PRIORITY_DEFAULT;
+    work->queued_tick = 0;
+#endif /* RT_WORKQUEUE_USING_POOL */
+}
+
+#ifdef RT_WORKQUEUE_USING_POOL
+/**
+ * @brief Set the priority of a work item in a pool mode work queue.
+ *        It takes effect on the next submission of the work item.
+ *
+ * @param work is a pointer to the work item object.
+ *
+ * @param priority is the priority, the work items of a lower value are executed first
+ *        and the ones of the same priority in the order of submission.
+ */
+void rt_work_set_priority(struct rt_work *work, rt_uint8_t priority)
+{
+    RT_ASSERT(work != RT_NULL);
+
+    work->priority = priority;
+}
+
+/**
+ * @brief Create a work queue with a pool of worker threads sharing the work list,
+ *        so that a slow work item only holds one of the workers.
+ *
+ * @param name is a name of the work queue threads, the index is appended when there is
+ *        more than one worker.
+ *
+ * @param stack_size is stack size of each worker thread.
+ *
+ * @param priority is a priority of the worker threads.
+ *
+ * @param workers is the number of the worker threads.
+ *
+ * @return Return a pointer to the workqueue object. It will return RT_NULL if failed.
+ */
+struct rt_workqueue *rt_workqueue_create_pool(const char *name, rt_uint16_t stack_size,
+                                              rt_uint8_t priority, rt_uint8_t workers)
+{
+    struct rt_workqueue *queue;
+    char thread_name[RT_NAME_MAX];
+    rt_size_t length;
+    int index;
+
+    if (workers == 0)
+        workers = 1;
+
+    queue = (struct rt_workqueue *)RT_KERNEL_MALLOC(sizeof(struct rt_workqueue));
+    if (queue == RT_NULL)
+        return RT_NULL;
+
+    queue->workers = (struct rt_workqueue_worker *)RT_KERNEL_MALLOC(sizeof(struct rt_workqueue_worker) * workers);
+    if (queue->workers == RT_NULL)
+    {
+        RT_KERNEL_FREE(queue);
+        return RT_NULL;
+    }
+
+    /* initialize work list */
+    rt_list_init(&(queue->work_list));
+    rt_list_init(&(queue->delayed_list));
+    queue->work_current = RT_NULL;
+    rt_memset(&(queue->stat), 0, sizeof(queue->stat));
+    rt_sem_init(&(queue->sem), "wqueue", 0, RT_IPC_FLAG_FIFO);
+
+    /* create the worker threads */
+    length = rt_strlen(name);
+    if (length > RT_NAME_MAX - 4)
+        length = RT_NAME_MAX - 4;
+    for (index = 0; index < workers; index ++)
+    {
+        rt_memcpy(thread_name, name, length);
+        rt_snprintf(&thread_name[length], sizeof(thread_name) - length, "%d", index);
+
+        queue->workers[index].queue = queue;
+        queue->workers[index].work_current = RT_NULL;
+        rt_list_init(&(queue->workers[index].wait_list));
+        queue->workers[index].thread = rt_thread_create(workers > 1 ? thread_name : name,
+                                                        _workqueue_thread_entry, &(queue->workers[index]),
+                                                        stack_size, priority, 10);
+        if (queue->workers[index].thread == RT_NULL)
+        {
+            while (index --)
+                rt_thread_delete(queue->workers[index].thread);
+            rt_sem_detach(&(queue->sem));
+            RT_KERNEL_FREE(queue->workers);
+            RT_KERNEL_FREE(queue);
+            return RT_NULL;
+        }
+    }
+    queue->worker_num = workers;
+    queue->work_thread = queue->workers[0].thread;
+
+    for (index = 0; index < workers; index ++)
+        rt_thread_startup(queue->workers[index].thread);
+
+    return queue;
+}
+
+/**
+ * @brief Get the statistics of a work queue.
+ *
+ * @param queue is a pointer to the workqueue object.
+ *
+ * @param stat is the statistics returned, the times are in OS ticks.
+ *
+ * @return RT_EOK       Success.
+ */
+rt_err_t rt_workqueue_get_stat(struct rt_workqueue *queue, struct rt_workqueue_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(queue != RT_NULL);
+    RT_ASSERT(stat != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    *stat = queue->stat;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief Clear the counters and the maximums of the statistics of a work queue.
+ *
+ * @param queue is a pointer to the workqueue object.
+ */
+void rt_workqueue_reset_stat(struct rt_workqueue *queue)
+{
+    rt_base_t level;
+
+    RT_ASSERT(queue != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    queue->stat.done = 0;
+    queue->stat.max_depth = queue->stat.depth;
+    queue->stat.max_busy = queue->stat.busy;
+    queue->stat.exec_total = 0;
+    queue->stat.exec_max = 0;
+    queue->stat.wait_max = 0;
+    rt_hw_interrupt_enable(level);
 }
+#endif /* RT_WORKQUEUE_USING_POOL */
 
 /**
  * @brief Create a work queue with a thread inside.
@@ -248,6 +510,9 @@ void rt_work_init(struct rt_work *work,
  */
 struct rt_workqueue *rt_workqueue_create(const char *name, rt_uint16_t stack_size, rt_uint8_t priority)
 {
+#ifdef RT_WORKQUEUE_USING_POOL
+    return rt_workqueue_create_pool(name, stack_size, priority, 1);
+#else
     struct rt_workqueue *queue = RT_NULL;
 
     queue = (struct rt_workqueue *)RT_KERNEL_MALLOC(sizeof(struct rt_workqueue));
@@ -271,6 +536,7 @@ struct rt_workqueue *rt_workqueue_create(const char *name, rt_uint16_t stack_siz
     }
 
     return queue;
+#endif /* RT_WORKQUEUE_USING_POOL */
 }
 
 /**
@@ -285,7 +551,17 @@ rt_err_t rt_workqueue_destroy(struct rt_workqueue *queue)
     RT_ASSERT(queue != RT_NULL);
 
     rt_workqueue_cancel_all_work(queue);
+#ifdef RT_WORKQUEUE_USING_POOL
+    {
+        int index;
+
+        for (index = 0; index < queue->worker_num; index ++)
+            rt_thread_delete(queue->workers[index].thread);
+        RT_KERNEL_FREE(queue->workers);
+    }
+#else
     rt_thread_delete(queue->work_thread);
+#endif /* RT_WORKQUEUE_USING_POOL */
     rt_sem_detach(&(queue->sem));
     RT_KERNEL_FREE(queue);
 
@@ -341,7 +617,8 @@ rt_err_t rt_workqueue_submit_work(struct rt_workqueue *queue, struct rt_work *wo
  *
  * @param work is a pointer to the work item object.
  *
- * @return RT_EOK   Success.
+ * @return RT_EOK       Success.
+ *         -RT_EBUSY    This work item is executing, in the pool mode only.
  */
 rt_err_t rt_workqueue_urgent_work(struct rt_workqueue *queue, struct rt_work *work)
 {
@@ -352,21 +629,24 @@ rt_err_t rt_workqueue_urgent_work(struct rt_workqueue *queue, struct rt_work *wo
 
     level = rt_hw_interrupt_disable();
     /* NOTE: the work MUST be initialized firstly */
-    rt_list_remove(&(work->list));
-    rt_list_insert_after(&queue->work_list, &(work->list));
-    /* whether the workqueue is doing work */
-    if (queue->work_current == RT_NULL &&
-        ((queue->work_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_SUSPEND))
-    {
-        /* resume work thread */
-        rt_thread_resume(queue->work_thread);
-        rt_hw_interrupt_enable(level);
-        rt_schedule();
-    }
-    else
+    _workqueue_unlink_work(work);
+#ifdef RT_WORKQUEUE_USING_POOL
+    /* another worker would run it again while it is executing */
+    if (_workqueue_is_current(queue, work))
     {
         rt_hw_interrupt_enable(level);
+        return -RT_EBUSY;
     }
+#endif /* RT_WORKQUEUE_USING_POOL */
+    rt_list_insert_after(&queue->work_list, &(work->list));
+    work->flags |= RT_WORK_STATE_PENDING;
+    work->workqueue = queue;
+#ifdef RT_WORKQUEUE_USING_POOL
+    work->queued_tick = rt_tick_get();
+    if (++ queue->stat.depth > queue->stat.max_depth)
+        queue->stat.max_depth = queue->stat.depth;
+#endif /* RT_WORKQUEUE_USING_POOL */
+    _workqueue_kick(queue, level);
 
     return RT_EOK;
 }
@@ -403,6 +683,30 @@ rt_err_t rt_workqueue_cancel_work_sync(struct rt_workqueue *queue, struct rt_wor
     RT_ASSERT(queue != RT_NULL);
     RT_ASSERT(work != RT_NULL);
 
+#ifdef RT_WORKQUEUE_USING_POOL
+    {
+        struct rt_workqueue_worker *worker;
+        struct _workqueue_waiter waiter;
+        rt_base_t level;
+
+        rt_completion_init(&(waiter.done));
+        _workqueue_cancel_work(queue, work);
+
+        level = rt_hw_interrupt_disable();
+        worker = _workqueue_find_worker(queue, work);
+        /* the work calling it for itself would never complete */
+        if (worker == RT_NULL || worker->thread == rt_thread_self())
+        {
+            rt_hw_interrupt_enable(level);
+            return RT_EOK;
+        }
+        rt_list_insert_before(&(worker->wait_list), &(waiter.list));
+        rt_hw_interrupt_enable(level);
+
+        /* wait for the worker executing it to finish */
+        rt_completion_wait(&(waiter.done), RT_WAITING_FOREVER);
+    }
+#else
     if (queue->work_current == work) /* it's current work in the queue */
     {
         /* wait for work completion */
@@ -412,6 +716,7 @@ rt_err_t rt_workqueue_cancel_work_sync(struct rt_workqueue *queue, struct rt_wor
     {
         _workqueue_cancel_work(queue, work);
     }
+#endif /* RT_WORKQUEUE_USING_POOL */
 
     return RT_EOK;
 }
@@ -474,7 +779,8 @@ rt_err_t rt_work_submit(struct rt_work *work, rt_tick_t ticks)
  *
  * @param work is a pointer to the work item object.
  *
- * @return RT_EOK   Success.
+ * @return RT_EOK       Success.
+ *         -RT_EBUSY    This work item is executing, in the pool mode only.
  */
 rt_err_t rt_work_urgent(struct rt_work *work)
 {
@@ -499,12 +805,162 @@ static int rt_work_sys_workqueue_init(void)
     if (sys_workq != RT_NULL)
         return RT_EOK;
 
+#if defined(RT_WORKQUEUE_USING_POOL) && defined(RT_SYSTEM_WORKQUEUE_WORKERS)
+    sys_workq = rt_workqueue_create_pool("sys workq", RT_SYSTEM_WORKQUEUE_STACKSIZE,
+                                         RT_SYSTEM_WORKQUEUE_PRIORITY, RT_SYSTEM_WORKQUEUE_WORKERS);
+#else
     sys_workq = rt_workqueue_create("sys workq", RT_SYSTEM_WORKQUEUE_STACKSIZE,
                                     RT_SYSTEM_WORKQUEUE_PRIORITY);
+#endif
     RT_ASSERT(sys_workq != RT_NULL);
 
     return RT_EOK;
 }
 INIT_PREV_EXPORT(rt_work_sys_workqueue_init);
 #endif /* RT_USING_SYSTEM_WORKQUEUE */
+
+#if defined(RT_USING_FINSH) && defined(RT_WORKQUEUE_USING_BENCH)
+#include <stdlib.h>
+
+#define WQ_BENCH_SLOW_MS        20  /* a flash write */
+#define WQ_BENCH_PERIOD_MS      2   /* a work is submitted every period */
+
+struct wq_bench_work
+{
+    struct rt_work work;
+    rt_tick_t submit;
+    rt_tick_t start;
+    rt_tick_t end;
+    rt_bool_t slow;
+};
+
+static volatile int wq_bench_done;
+
+static void wq_bench_func(struct rt_work *work, void *work_data)
+{
+    struct wq_bench_work *bench = (struct wq_bench_work *)work_data;
+    rt_base_t level;
+
+    bench->start = rt_tick_get();
+    if (bench->slow)
+        rt_thread_mdelay(WQ_BENCH_SLOW_MS);
+    bench->end = rt_tick_get();
+
+    level = rt_hw_interrupt_disable();
+    wq_bench_done ++;
+    rt_hw_interrupt_enable(level);
+}
+
+static void wq_bench_run(int workers, struct wq_bench_work *works, rt_tick_t *latency, int count)
+{
+    struct rt_workqueue *queue;
+    struct rt_workqueue_stat stat;
+    rt_uint8_t priority;
+    rt_tick_t begin, end, value;
+    int index, fast, pos, wait;
+
+    /* the workers run before the submitting thread */
+    priority = rt_thread_self()->current_priority;
+    if (priority > 0)
+        priority --;
+
+    queue = rt_workqueue_create_pool("wqb", 512, priority, workers);
+    if (queue == RT_NULL)
+    {
+        rt_kprintf("no memory for %d workers\n", workers);
+        return;
+    }
+
+    wq_bench_done = 0;
+    for (index = 0; index < count; index ++)
+    {
+        works[index].slow = (index % 8 == 7);
+        works[index].start = works[index].end = 0;
+        rt_work_init(&(works[index].work), wq_bench_func, &works[index]);
+        rt_work_set_priority(&(works[index].work), works[index].slow ? 192 : 64);
+    }
+
+    begin = rt_tick_get();
+    for (index = 0; index < count; index ++)
+    {
+        works[index].submit = rt_tick_get();
+        rt_workqueue_dowork(queue, &(works[index].work));
+        rt_thread_mdelay(WQ_BENCH_PERIOD_MS);
+    }
+    for (wait = 0; wq_bench_done < count && wait < count * WQ_BENCH_SLOW_MS; wait += 10)
+        rt_thread_mdelay(10);
+    if (wq_bench_done < count)
+    {
+        /* the works are reused by the next run and freed after it, none may stay in the queue */
+        rt_kprintf("%d worker(s): %d of %d works not done in time, cancelled\n", workers, count - wq_bench_done, count);
+        for (index = 0; index < count; index ++)
+            rt_workqueue_cancel_work_sync(queue, &(works[index].work));
+    }
+
+    end = begin;
+    fast = 0;
+    for (index = 0; index < count; index ++)
+    {
+        if (works[index].end == 0)
+            continue;
+        if (works[index].end - begin > end - begin)
+            end = works[index].end;
+        if (works[index].slow)
+            continue;
+
+        /* insertion sort of the latencies of the fast works */
+        value = works[index].start - works[index].submit;
+        for (pos = fast; pos > 0 && latency[pos - 1] > value; pos --)
+            latency[pos] = latency[pos - 1];
+        latency[pos] = value;
+        fast ++;
+    }
+    rt_workqueue_get_stat(queue, &stat);
+
+    if (fast > 0)
+    {
+        rt_kprintf("%d worker(s): %d works in %d ms, fast work latency p50 %d p99 %d max %d ms\n",
+                   workers, wq_bench_done, (end - begin) * 1000 / RT_TICK_PER_SECOND,
+                   latency[fast / 2] * 1000 / RT_TICK_PER_SECOND,
+                   latency[fast * 99 / 100] * 1000 / RT_TICK_PER_SECOND,
+                   latency[fast - 1] * 1000 / RT_TICK_PER_SECOND);
+    }
+    rt_kprintf("    depth max %d, busy max %d, exec max %d, wait max %d ticks\n",
+               stat.max_depth, stat.max_busy, stat.exec_max, stat.wait_max);
+
+    rt_workqueue_destroy(queue);
+}
+
+/* one slow work in eight, compare one worker and a pool */
+static int workqueue_bench(int argc, char **argv)
+{
+    int workers = argc > 1 ? atoi(argv[1]) : 4;
+    int count = argc > 2 ? atoi(argv[2]) : 64;
+    struct wq_bench_work *works;
+    rt_tick_t *latency;
+
+    if (workers <= 0 || workers > 255 || count < 8)
+    {
+        rt_kprintf("Usage: workqueue_bench [workers] [works]\n");
+        return -RT_EINVAL;
+    }
+
+    works = (struct wq_bench_work *)rt_calloc(count, sizeof(struct wq_bench_work));
+    latency = (rt_tick_t *)rt_calloc(count, sizeof(rt_tick_t));
+    if (works && latency)
+    {
+        wq_bench_run(1, works, latency, count);
+        wq_bench_run(workers, works, latency, count);
+    }
+    else
+    {
+        rt_kprintf("no memory for %d works\n", count);
+    }
+    rt_free(works);
+    rt_free(latency);
+
+    return 0;
+}
+MSH_CMD_EXPORT(workqueue_bench, workqueue pool benchmark: workqueue_bench [workers] [works]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_WORKQUEUE_USING_BENCH) */
 #endif /* RT_USING_HEAP */
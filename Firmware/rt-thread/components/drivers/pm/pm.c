@@ -10,6 +10,7 @@
  * 2019-04-28     Zero-Free    improve PM mode and device ops interface
  * 2020-11-23     zhangsz      update pm mode select
  * 2020-11-27     zhangsz      update pm 2.0
+ * 2026-10-19     RT-Thread    fix tickless timeout, add sleep statistics
  */
 
 #include <rthw.h>
@@ -64,6 +65,10 @@ static rt_uint8_t _pm_default_deepsleep = RT_PM_DEFAULT_DEEPSLEEP_MODE;
 static struct rt_pm_notify _pm_notify;
 static rt_uint8_t _pm_init_flag = 0;
 
+#ifdef PM_ENABLE_STATISTICS
+static struct rt_pm_stat _pm_stat;
+#endif
+
 RT_WEAK rt_uint32_t rt_pm_enter_critical(rt_uint8_t sleep_mode)
 {
     return rt_hw_interrupt_disable();
@@ -290,10 +295,23 @@ static rt_bool_t _pm_device_check_idle(void)
 
 RT_WEAK rt_tick_t pm_timer_next_timeout_tick(rt_uint8_t mode)
 {
+    rt_tick_t timer_tick, lptimer_tick, cur_tick;
+
     switch (mode)
     {
         case PM_SLEEP_MODE_LIGHT:
-            return rt_timer_next_timeout_tick();
+            /* the system timers keep running, the first of both lists wakes up */
+            timer_tick = rt_timer_next_timeout_tick();
+            lptimer_tick = rt_lptimer_next_timeout_tick();
+            if (timer_tick == RT_TICK_MAX)
+                return lptimer_tick;
+            if (lptimer_tick == RT_TICK_MAX)
+                return timer_tick;
+
+            cur_tick = rt_tick_get();
+            if ((lptimer_tick - cur_tick) < (timer_tick - cur_tick))
+                return lptimer_tick;
+            return timer_tick;
         case PM_SLEEP_MODE_DEEP:
         case PM_SLEEP_MODE_STANDBY:
             return rt_lptimer_next_timeout_tick();
@@ -347,11 +365,11 @@ RT_WEAK rt_uint8_t pm_get_sleep_threshold_mode(rt_uint8_t cur_mode, rt_tick_t ti
 #else
     if (timeout_tick < PM_TICKLESS_THRESHOLD_TIME)
     {
-        cur_mode = PM_SLEEP_MODE_IDLE;
+        sleep_mode = PM_SLEEP_MODE_IDLE;
     }
 #endif
 
-    return cur_mode;
+    return sleep_mode;
 }
 
 /**
@@ -362,6 +380,9 @@ static void _pm_change_sleep_mode(struct rt_pm *pm)
     rt_tick_t timeout_tick, delta_tick;
     rt_base_t level;
     uint8_t sleep_mode = PM_SLEEP_MODE_DEEP;
+#ifdef PM_ENABLE_STATISTICS
+    rt_tick_t sleep_tick;
+#endif
 
     level = rt_pm_enter_critical(pm->sleep_mode);
 
@@ -412,7 +433,13 @@ static void _pm_change_sleep_mode(struct rt_pm *pm)
         if (pm->timer_mask & (0x01 << pm->sleep_mode))
         {
             timeout_tick = pm_timer_next_timeout_tick(pm->sleep_mode);
-            timeout_tick = timeout_tick - rt_tick_get();
+            if (timeout_tick != RT_TICK_MAX)
+            {
+                timeout_tick = timeout_tick - rt_tick_get();
+                /* the timer is already timeout, do not suppress the tick */
+                if (timeout_tick >= RT_TICK_MAX / 2)
+                    timeout_tick = 0;
+            }
 
             /* Judge sleep_mode from threshold time */
             pm->sleep_mode = pm_get_sleep_threshold_mode(pm->sleep_mode, timeout_tick);
@@ -430,6 +457,9 @@ static void _pm_change_sleep_mode(struct rt_pm *pm)
             }
         }
 
+#ifdef PM_ENABLE_STATISTICS
+        sleep_tick = rt_tick_get();
+#endif
         /* enter lower power state */
         pm_sleep(pm, pm->sleep_mode);
 
@@ -452,6 +482,13 @@ static void _pm_change_sleep_mode(struct rt_pm *pm)
 
         rt_pm_exit_critical(level, pm->sleep_mode);
 
+#ifdef PM_ENABLE_STATISTICS
+        /* the wake up interrupt has run, its tick is counted too */
+        _pm_stat.wakeups ++;
+        _pm_stat.sleep_count[pm->sleep_mode] ++;
+        _pm_stat.sleep_ticks[pm->sleep_mode] += rt_tick_get() - sleep_tick;
+#endif
+
         if (pm->timer_mask & (0x01 << pm->sleep_mode))
         {
             if (delta_tick)
@@ -1010,9 +1047,44 @@ void rt_system_pm_init(const struct rt_pm_ops *ops,
     #error "[pm.c ERR] IDLE Stack Size Too Small!"
 #endif
 
+#ifdef PM_ENABLE_STATISTICS
+    rt_pm_stat_reset();
+#endif
+
     _pm_init_flag = 1;
 }
 
+#ifdef PM_ENABLE_STATISTICS
+/**
+ * This function will get the sleep statistics since the last reset.
+ *
+ * @param stat the buffer of the statistics
+ */
+void rt_pm_stat_get(struct rt_pm_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(stat != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rt_memcpy(stat, &_pm_stat, sizeof(struct rt_pm_stat));
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will clear the sleep statistics.
+ */
+void rt_pm_stat_reset(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_memset(&_pm_stat, 0, sizeof(struct rt_pm_stat));
+    _pm_stat.start_tick = rt_tick_get();
+    rt_hw_interrupt_enable(level);
+}
+#endif
+
 #ifdef RT_USING_FINSH
 #include <finsh.h>
 
@@ -1254,6 +1326,46 @@ static void rt_pm_dump_status(void)
 }
 FINSH_FUNCTION_EXPORT_ALIAS(rt_pm_dump_status, pm_dump, dump power management status);
 MSH_CMD_EXPORT_ALIAS(rt_pm_dump_status, pm_dump, dump power management status);
+
+#ifdef PM_ENABLE_STATISTICS
+static void rt_pm_dump_stat(int argc, char **argv)
+{
+    struct rt_pm_stat stat;
+    rt_tick_t elapsed, asleep = 0;
+    rt_uint32_t index;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        rt_pm_stat_reset();
+        return;
+    }
+
+    rt_pm_stat_get(&stat);
+    elapsed = rt_tick_get() - stat.start_tick;
+    if (elapsed == 0)
+        elapsed = 1;
+
+    rt_kprintf("| Power Management Mode |   Count    |   Time(ms)   | Ratio |\n");
+    rt_kprintf("+-----------------------+------------+--------------+-------+\n");
+    for (index = PM_SLEEP_MODE_IDLE; index < PM_SLEEP_MODE_MAX; index ++)
+    {
+        rt_kprintf("| %021s | %10d | %12d | %4d%% |\n", _pm_sleep_str[index],
+                   stat.sleep_count[index],
+                   (rt_uint32_t)((rt_uint64_t)stat.sleep_ticks[index] * 1000 / RT_TICK_PER_SECOND),
+                   (rt_uint32_t)((rt_uint64_t)stat.sleep_ticks[index] * 100 / elapsed));
+        asleep += stat.sleep_ticks[index];
+    }
+    rt_kprintf("+-----------------------+------------+--------------+-------+\n");
+
+    rt_kprintf("elapsed: %d ms, awake: %d ms\n",
+               (rt_uint32_t)((rt_uint64_t)elapsed * 1000 / RT_TICK_PER_SECOND),
+               (rt_uint32_t)((rt_uint64_t)(elapsed - asleep) * 1000 / RT_TICK_PER_SECOND));
+    rt_kprintf("wake-ups: %d, %d.%02d per second\n", stat.wakeups,
+               (rt_uint32_t)((rt_uint64_t)stat.wakeups * RT_TICK_PER_SECOND / elapsed),
+               (rt_uint32_t)((rt_uint64_t)stat.wakeups * RT_TICK_PER_SECOND * 100 / elapsed % 100));
+}
+MSH_CMD_EXPORT_ALIAS(rt_pm_dump_stat, pm_stat, dump sleep statistics: pm_stat [reset]);
+#endif
 #endif
 
 #endif /* RT_USING_PM */
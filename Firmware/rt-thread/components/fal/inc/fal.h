@@ -23,6 +23,13 @@
  */
 int fal_init(void);
 
+/**
+ * Check if the FAL is initialized successfully
+ *
+ * @return 0: not init or init failed; 1: init success
+ */
+int fal_init_check(void);
+
 /* =============== flash device operator API =============== */
 /**
  * find flash device by name
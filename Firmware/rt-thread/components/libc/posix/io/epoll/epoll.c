@@ -0,0 +1,642 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+/*
+ * epoll() on the poll hooks of the file operations.
+ *
+ * poll() adds a wait node to the wait queue of every descriptor and removes
+ * it again on each call, so the cost of a call grows with the number of the
+ * descriptors. Here the wait nodes are added once by EPOLL_CTL_ADD and stay in
+ * the wait queues of the socket, the pipe or the serial device. The wakeup of
+ * a queue moves the item to the ready list of the epoll instance, and
+ * epoll_wait() only polls the items of the ready list again.
+ *
+ * A descriptor must be removed by EPOLL_CTL_DEL before it is closed, the
+ * wait queues live in the socket or the device which go away on close.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <dfs_file.h>
+#include "epoll.h"
+
+#define DBG_TAG    "epoll"
+#define DBG_LVL    DBG_WARNING
+#include <rtdbg.h>
+
+/* a pipe adds its reader and its writer queue */
+#define EPOLL_WAIT_MAX      2
+
+#define EPOLL_FLAGS         (EPOLLET | EPOLLONESHOT)
+
+struct rt_epoll;
+struct rt_epoll_item;
+
+struct rt_epoll_wait
+{
+    struct rt_wqueue_node wqn;
+    struct rt_epoll_item *item;
+};
+
+struct rt_epoll_item
+{
+    rt_list_t list;                 /* node of the interest set */
+    rt_list_t ready_list;           /* node of the ready list */
+    struct rt_epoll *ep;
+
+    int fd;
+    struct epoll_event event;
+    rt_uint8_t ready;               /* in the ready list or being reported */
+    rt_uint8_t disabled;            /* EPOLLONESHOT reported, wait for EPOLL_CTL_MOD */
+    rt_uint8_t wait_num;
+
+    rt_pollreq_t req;
+    struct rt_epoll_wait wait[EPOLL_WAIT_MAX];
+};
+
+struct rt_epoll
+{
+    rt_list_t items;                /* the interest set */
+    rt_list_t ready;                /* the items woken up */
+    rt_uint8_t waiting;             /* a thread is in epoll_wait() */
+
+    struct rt_mutex lock;
+    struct rt_semaphore sem;
+};
+
+static int _epoll_close(struct dfs_fd *fd);
+
+static const struct dfs_file_ops _epoll_fops =
+{
+    RT_NULL,
+    _epoll_close,
+};
+
+/* put an item to the ready list, in the context of the wakeup */
+static void _epoll_ready(struct rt_epoll_item *item)
+{
+    struct rt_epoll *ep = item->ep;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (!item->ready && !item->disabled)
+    {
+        item->ready = 1;
+        rt_list_insert_before(&(ep->ready), &(item->ready_list));
+    }
+    if (ep->waiting)
+    {
+        ep->waiting = 0;
+        rt_sem_release(&(ep->sem));
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static int _epoll_wakeup(struct rt_wqueue_node *wait, void *key)
+{
+    struct rt_epoll_wait *ew;
+
+    if (key && !((rt_ubase_t)key & wait->key))
+        return -1;
+
+    ew = rt_container_of(wait, struct rt_epoll_wait, wqn);
+    _epoll_ready(ew->item);
+
+    /* keep the node in the queue and let the other waiters be woken up */
+    return -1;
+}
+
+static void _epoll_add_wait(rt_wqueue_t *wq, rt_pollreq_t *req)
+{
+    struct rt_epoll_item *item;
+    struct rt_epoll_wait *ew;
+    rt_base_t level;
+
+    item = rt_container_of(req, struct rt_epoll_item, req);
+    if (item->wait_num >= EPOLL_WAIT_MAX)
+    {
+        LOG_W("fd %d has more than %d wait queues", item->fd, EPOLL_WAIT_MAX);
+        return;
+    }
+
+    ew = &(item->wait[item->wait_num ++]);
+    ew->item = item;
+    ew->wqn.polling_thread = rt_thread_self();
+    ew->wqn.wakeup = _epoll_wakeup;
+    ew->wqn.key = req->_key;
+
+    /* at the head, rt_wqueue_wakeup() stops at the first thread of poll() it wakes up */
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_after(&(wq->waiting_list), &(ew->wqn.list));
+    rt_hw_interrupt_enable(level);
+}
+
+static int _epoll_item_poll(struct rt_epoll_item *item)
+{
+    struct dfs_fd *f;
+    int mask;
+
+    f = fd_get(item->fd);
+    if (f == RT_NULL)
+        return POLLERR | POLLHUP;
+
+    mask = POLLMASK_DEFAULT;
+    if (f->fops->poll)
+    {
+        item->req._key = item->event.events | POLLERR | POLLHUP;
+        mask = f->fops->poll(f, &(item->req));
+        if (mask < 0)
+            mask = POLLERR;
+    }
+    fd_put(f);
+
+    return mask & (item->event.events | POLLERR | POLLHUP);
+}
+
+static void _epoll_item_free(struct rt_epoll_item *item)
+{
+    rt_base_t level;
+    int index;
+
+    for (index = 0; index < item->wait_num; index ++)
+        rt_wqueue_remove(&(item->wait[index].wqn));
+
+    level = rt_hw_interrupt_disable();
+    if (item->ready)
+        rt_list_remove(&(item->ready_list));
+    rt_hw_interrupt_enable(level);
+
+    rt_list_remove(&(item->list));
+    rt_free(item);
+}
+
+static struct rt_epoll_item *_epoll_item_find(struct rt_epoll *ep, int fd)
+{
+    struct rt_epoll_item *item;
+    rt_list_t *node;
+
+    rt_list_for_each(node, &(ep->items))
+    {
+        item = rt_list_entry(node, struct rt_epoll_item, list);
+        if (item->fd == fd)
+            return item;
+    }
+
+    return RT_NULL;
+}
+
+static struct rt_epoll *_epoll_get(int epfd)
+{
+    struct rt_epoll *ep = RT_NULL;
+    struct dfs_fd *d;
+
+    d = fd_get(epfd);
+    if (d == RT_NULL)
+        return RT_NULL;
+
+    if (d->fops == &_epoll_fops)
+        ep = (struct rt_epoll *)d->data;
+    fd_put(d);
+
+    return ep;
+}
+
+static int _epoll_close(struct dfs_fd *fd)
+{
+    struct rt_epoll *ep = (struct rt_epoll *)fd->data;
+
+    rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+    while (!rt_list_isempty(&(ep->items)))
+        _epoll_item_free(rt_list_entry(ep->items.next, struct rt_epoll_item, list));
+    rt_mutex_release(&(ep->lock));
+
+    rt_mutex_detach(&(ep->lock));
+    rt_sem_detach(&(ep->sem));
+    rt_free(ep);
+    fd->data = RT_NULL;
+
+    return 0;
+}
+
+int epoll_create1(int flags)
+{
+    struct rt_epoll *ep;
+    struct dfs_fd *d;
+    int fd;
+
+    if (flags & ~EPOLL_CLOEXEC)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ep = (struct rt_epoll *)rt_calloc(1, sizeof(struct rt_epoll));
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+
+    fd = fd_new();
+    if (fd < 0)
+    {
+        rt_free(ep);
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+
+    rt_list_init(&(ep->items));
+    rt_list_init(&(ep->ready));
+    rt_mutex_init(&(ep->lock), "epoll", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&(ep->sem), "epoll", 0, RT_IPC_FLAG_PRIO);
+
+    d = fd_get(fd);
+    d->type = FT_USER;
+    d->path = RT_NULL;
+    d->fops = &_epoll_fops;
+    d->flags = O_RDWR;
+    d->size = 0;
+    d->pos = 0;
+    d->data = ep;
+    fd_put(d);
+
+    return fd;
+}
+RTM_EXPORT(epoll_create1);
+
+int epoll_create(int size)
+{
+    if (size <= 0)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    return epoll_create1(0);
+}
+RTM_EXPORT(epoll_create);
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    struct rt_epoll *ep;
+    struct rt_epoll_item *item;
+    struct dfs_fd *f;
+    rt_base_t level;
+    int index, mask, result = 0;
+
+    ep = _epoll_get(epfd);
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return -1;
+    }
+    if (fd == epfd || (op != EPOLL_CTL_DEL && event == RT_NULL))
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    f = fd_get(fd);
+    if (f == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return -1;
+    }
+    fd_put(f);
+
+    rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+    item = _epoll_item_find(ep, fd);
+
+    switch (op)
+    {
+    case EPOLL_CTL_ADD:
+        if (item)
+        {
+            result = -EEXIST;
+            break;
+        }
+
+        item = (struct rt_epoll_item *)rt_calloc(1, sizeof(struct rt_epoll_item));
+        if (item == RT_NULL)
+        {
+            result = -ENOMEM;
+            break;
+        }
+        rt_list_init(&(item->ready_list));
+        item->ep = ep;
+        item->fd = fd;
+        item->event = *event;
+        rt_list_insert_before(&(ep->items), &(item->list));
+
+        /* the only poll which adds the wait nodes */
+        item->req._proc = _epoll_add_wait;
+        mask = _epoll_item_poll(item);
+        item->req._proc = RT_NULL;
+        if (mask)
+            _epoll_ready(item);
+        break;
+
+    case EPOLL_CTL_MOD:
+        if (item == RT_NULL)
+        {
+            result = -ENOENT;
+            break;
+        }
+
+        level = rt_hw_interrupt_disable();
+        item->event = *event;
+        item->disabled = 0;
+        for (index = 0; index < item->wait_num; index ++)
+            item->wait[index].wqn.key = event->events | POLLERR | POLLHUP;
+        rt_hw_interrupt_enable(level);
+
+        if (_epoll_item_poll(item))
+            _epoll_ready(item);
+        break;
+
+    case EPOLL_CTL_DEL:
+        if (item == RT_NULL)
+        {
+            result = -ENOENT;
+            break;
+        }
+        _epoll_item_free(item);
+        break;
+
+    default:
+        result = -EINVAL;
+        break;
+    }
+    rt_mutex_release(&(ep->lock));
+
+    if (result < 0)
+    {
+        rt_set_errno(result);
+        return -1;
+    }
+
+    return 0;
+}
+RTM_EXPORT(epoll_ctl);
+
+/* report the items of the ready list, the cost is the number of the ready items */
+static int _epoll_collect(struct rt_epoll *ep, struct epoll_event *events, int maxevents)
+{
+    struct rt_epoll_item *item;
+    rt_list_t pending;
+    rt_base_t level;
+    int count = 0, mask;
+
+    /* take the whole ready list, the items stay marked as ready */
+    rt_list_init(&pending);
+    level = rt_hw_interrupt_disable();
+    if (!rt_list_isempty(&(ep->ready)))
+    {
+        pending.next = ep->ready.next;
+        pending.prev = ep->ready.prev;
+        pending.next->prev = &pending;
+        pending.prev->next = &pending;
+        rt_list_init(&(ep->ready));
+    }
+    rt_hw_interrupt_enable(level);
+
+    while (!rt_list_isempty(&pending) && count < maxevents)
+    {
+        item = rt_list_entry(pending.next, struct rt_epoll_item, ready_list);
+
+        /* a wakeup from now on queues the item again */
+        level = rt_hw_interrupt_disable();
+        rt_list_remove(&(item->ready_list));
+        item->ready = 0;
+        rt_hw_interrupt_enable(level);
+
+        if (item->disabled)
+            continue;
+
+        mask = _epoll_item_poll(item);
+        if (mask == 0)
+            continue;
+
+        events[count].events = mask;
+        events[count].data = item->event.data;
+        count ++;
+
+        if (item->event.events & EPOLLONESHOT)
+        {
+            item->disabled = 1;
+        }
+        else if (!(item->event.events & EPOLLET))
+        {
+            /* level triggered, poll it again on the next call */
+            level = rt_hw_interrupt_disable();
+            if (!item->ready)
+            {
+                item->ready = 1;
+                rt_list_insert_before(&(ep->ready), &(item->ready_list));
+            }
+            rt_hw_interrupt_enable(level);
+        }
+    }
+
+    /* the items not reported go back to the head of the ready list */
+    level = rt_hw_interrupt_disable();
+    if (!rt_list_isempty(&pending))
+    {
+        pending.prev->next = ep->ready.next;
+        ep->ready.next->prev = pending.prev;
+        ep->ready.next = pending.next;
+        pending.next->prev = &(ep->ready);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return count;
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    struct rt_epoll *ep;
+    rt_tick_t deadline = 0;
+    rt_int32_t ticks;
+    rt_base_t level;
+    rt_err_t result;
+    int count;
+
+    ep = _epoll_get(epfd);
+    if (ep == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return -1;
+    }
+    if (events == RT_NULL || maxevents <= 0)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ticks = RT_WAITING_FOREVER;
+    if (timeout >= 0)
+    {
+        ticks = rt_tick_from_millisecond(timeout);
+        deadline = rt_tick_get() + ticks;
+    }
+
+    while (1)
+    {
+        rt_mutex_take(&(ep->lock), RT_WAITING_FOREVER);
+        count = _epoll_collect(ep, events, maxevents);
+        rt_mutex_release(&(ep->lock));
+
+        if (count || ticks == 0)
+            break;
+
+        level = rt_hw_interrupt_disable();
+        if (!rt_list_isempty(&(ep->ready)))
+        {
+            rt_hw_interrupt_enable(level);
+            continue;
+        }
+        ep->waiting = 1;
+        rt_hw_interrupt_enable(level);
+
+        result = rt_sem_take(&(ep->sem), ticks);
+
+        level = rt_hw_interrupt_disable();
+        ep->waiting = 0;
+        rt_hw_interrupt_enable(level);
+
+        if (timeout >= 0)
+        {
+            /* look at the ready list once more after the timeout */
+            ticks = (rt_int32_t)(deadline - rt_tick_get());
+            if (result == -RT_ETIMEOUT || ticks < 0)
+                ticks = 0;
+        }
+    }
+
+    return count;
+}
+RTM_EXPORT(epoll_wait);
+
+#if defined(RT_USING_FINSH) && defined(RT_POSIX_EPOLL_USING_BENCH)
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()    ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT     "cycles"
+#else
+#define _BENCH_NOW()    ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT     "ticks"
+#endif
+
+/* one byte to one of the pipes a round, then wait for it by poll() and by epoll_wait() */
+static int epoll_bench(int argc, char **argv)
+{
+    int nfds = argc > 1 ? atoi(argv[1]) : 8;
+    int rounds = argc > 2 ? atoi(argv[2]) : 1000;
+    struct epoll_event event[4];
+    struct pollfd *pfd = RT_NULL;
+    rt_uint32_t begin, poll_time, epoll_time;
+    int (*pipes)[2] = RT_NULL;
+    int epfd = -1, index, round, num, got = 0;
+    char ch = 'x';
+
+    if (nfds <= 0 || rounds <= 0)
+    {
+        rt_kprintf("Usage: epoll_bench [fds] [rounds]\n");
+        return -RT_EINVAL;
+    }
+
+    pipes = rt_calloc(nfds, sizeof(pipes[0]));
+    pfd = rt_calloc(nfds, sizeof(pfd[0]));
+    if (pipes == RT_NULL || pfd == RT_NULL)
+        goto __exit;
+    for (index = 0; index < nfds; index ++)
+        pipes[index][0] = pipes[index][1] = -1;
+
+    for (index = 0; index < nfds; index ++)
+    {
+        if (pipe(pipes[index]) < 0)
+        {
+            rt_kprintf("only %d pipes, the fds or the memory run out\n", index);
+            goto __exit;
+        }
+        pfd[index].fd = pipes[index][0];
+        pfd[index].events = POLLIN;
+    }
+
+    begin = _BENCH_NOW();
+    for (round = 0; round < rounds; round ++)
+    {
+        write(pipes[round % nfds][1], &ch, 1);
+        num = poll(pfd, nfds, 0);
+        for (index = 0; index < nfds && num > 0; index ++)
+        {
+            if (pfd[index].revents & POLLIN)
+            {
+                read(pfd[index].fd, &ch, 1);
+                got ++;
+                num --;
+            }
+        }
+    }
+    poll_time = _BENCH_NOW() - begin;
+
+    epfd = epoll_create1(0);
+    if (epfd < 0)
+        goto __exit;
+    for (index = 0; index < nfds; index ++)
+    {
+        event[0].events = EPOLLIN;
+        event[0].data.fd = pipes[index][0];
+        epoll_ctl(epfd, EPOLL_CTL_ADD, pipes[index][0], &event[0]);
+    }
+
+    begin = _BENCH_NOW();
+    for (round = 0; round < rounds; round ++)
+    {
+        write(pipes[round % nfds][1], &ch, 1);
+        num = epoll_wait(epfd, event, 4, 0);
+        for (index = 0; index < num; index ++)
+        {
+            read(event[index].data.fd, &ch, 1);
+            got ++;
+        }
+    }
+    epoll_time = _BENCH_NOW() - begin;
+
+    rt_kprintf("%d pipes, %d rounds, %d of %d bytes read\n", nfds, rounds, got, 2 * rounds);
+    rt_kprintf("poll      : %10u %s\n", poll_time, _BENCH_UNIT);
+    rt_kprintf("epoll_wait: %10u %s\n", epoll_time, _BENCH_UNIT);
+
+__exit:
+    if (pipes)
+    {
+        for (index = 0; index < nfds; index ++)
+        {
+            if (pipes[index][0] < 0)
+                break;
+            if (epfd >= 0)
+                epoll_ctl(epfd, EPOLL_CTL_DEL, pipes[index][0], RT_NULL);
+            close(pipes[index][0]);
+            close(pipes[index][1]);
+        }
+    }
+    if (epfd >= 0)
+        close(epfd);
+    rt_free(pipes);
+    rt_free(pfd);
+
+    return 0;
+}
+MSH_CMD_EXPORT(epoll_bench, compare poll and epoll_wait: epoll_bench [fds] [rounds]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_POSIX_EPOLL_USING_BENCH) */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef __EPOLL_H__
+#define __EPOLL_H__
+
+#include <stdint.h>
+#include <poll.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EPOLL_CTL_ADD   1   /* add a file descriptor to the interest set */
+#define EPOLL_CTL_DEL   2   /* remove a file descriptor from the interest set */
+#define EPOLL_CTL_MOD   3   /* change the events of a file descriptor */
+
+/* the events are the ones of poll() */
+#define EPOLLIN         POLLIN
+#define EPOLLOUT        POLLOUT
+#define EPOLLERR        POLLERR
+#define EPOLLHUP        POLLHUP
+#define EPOLLRDNORM     POLLRDNORM
+#define EPOLLWRNORM     POLLWRNORM
+
+#define EPOLLONESHOT    (1u << 30)  /* disable the descriptor after one report */
+#define EPOLLET         (1u << 31)  /* edge triggered, report once a wakeup */
+
+#define EPOLL_CLOEXEC   0x00080000
+
+typedef union epoll_data
+{
+    void *ptr;
+    int fd;
+    uint32_t u32;
+    uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event
+{
+    uint32_t events;
+    epoll_data_t data;
+};
+
+int epoll_create(int size);
+int epoll_create1(int flags);
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EPOLL_H__ */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-06-06     chenyong     first version
+ * 2026-10-19     RT-Thread    allocate receive packets from the object cache
  */
 
 #include <at.h>
@@ -83,7 +84,7 @@ static rt_err_t at_recvpkt_put(rt_slist_t *rlist, const char *ptr, size_t length
 {
     at_recv_pkt_t pkt = RT_NULL;
 
-    pkt = (at_recv_pkt_t) rt_calloc(1, sizeof(struct at_recv_pkt));
+    pkt = (at_recv_pkt_t) at_calloc(1, sizeof(struct at_recv_pkt));
     if (pkt == RT_NULL)
     {
         LOG_E("No memory for receive packet table!");
@@ -115,11 +116,11 @@ static int at_recvpkt_all_delete(rt_slist_t *rlist)
         pkt = rt_slist_entry(node, struct at_recv_pkt, list);
         if (pkt->buff)
         {
-            rt_free(pkt->buff);
+            at_free(pkt->buff);
         }
         if (pkt)
         {
-            rt_free(pkt);
+            at_free(pkt);
             pkt = RT_NULL;
         }
     }
@@ -142,11 +143,11 @@ static int at_recvpkt_node_delete(rt_slist_t *rlist, rt_slist_t *node)
     pkt = rt_slist_entry(node, struct at_recv_pkt, list);
     if (pkt->buff)
     {
-        rt_free(pkt->buff);
+        at_free(pkt->buff);
     }
     if (pkt)
     {
-        rt_free(pkt);
+        at_free(pkt);
         pkt = RT_NULL;
     }
 
@@ -654,7 +655,7 @@ static void at_recv_notice_cb(struct at_socket *sock, at_socket_evt_t event, con
     /* check the socket object status */
     if (sock->magic != AT_SOCKET_MAGIC || sock->state == AT_SOCKET_CLOSED)
     {
-        rt_free((void *)buff);
+        at_free((void *)buff);
         return;
     }
 
@@ -662,7 +663,7 @@ static void at_recv_notice_cb(struct at_socket *sock, at_socket_evt_t event, con
     rt_mutex_take(sock->recv_lock, RT_WAITING_FOREVER);
     if (at_recvpkt_put(&(sock->recvpkt_list), buff, bfsz) != RT_EOK)
     {
-        rt_free((void *)buff);
+        at_free((void *)buff);
         rt_mutex_release(sock->recv_lock);
         return;
     }
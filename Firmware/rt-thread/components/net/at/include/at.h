@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2018-03-30     chenyong     first version
  * 2018-08-17     chenyong     multiple client support
+ * 2026-10-19     RT-Thread    add the at_calloc, at_realloc and at_free allocator
+ * 2026-10-19     RT-Thread    add the URC flags and the deferred URC dispatch
  */
 
 #ifndef __AT_H__
@@ -50,6 +52,18 @@ extern "C" {
 #define AT_CLIENT_NUM_MAX              1
 #endif
 
+/* the allocator of the response objects and the socket receive packets */
+#ifdef AT_USING_OBJCACHE
+#include <objcache.h>
+#define at_calloc                      rt_objcache_calloc
+#define at_realloc                     rt_objcache_realloc
+#define at_free                        rt_objcache_free
+#else
+#define at_calloc                      rt_calloc
+#define at_realloc                     rt_realloc
+#define at_free                        rt_free
+#endif /* AT_USING_OBJCACHE */
+
 #define AT_CMD_EXPORT(_name_, _args_expr_, _test_, _query_, _setup_, _exec_)   \
     RT_USED static const struct at_cmd __at_cmd_##_test_##_query_##_setup_##_exec_ RT_SECTION("RtAtCmdTab") = \
     {                                                                          \
@@ -143,12 +157,18 @@ typedef struct at_response *at_response_t;
 
 struct at_client;
 
+/* the URC function runs on the URC worker thread, with a copy of the line. It
+ * must not read the data following the line with at_client_obj_recv(). */
+#define AT_URC_FLAG_DEFER              0x01
+
 /* URC(Unsolicited Result Code) object, such as: 'RING', 'READY' request by AT server */
 struct at_urc
 {
     const char *cmd_prefix;
     const char *cmd_suffix;
     void (*func)(struct at_client *client, const char *data, rt_size_t size);
+    /* AT_URC_FLAG_*, 0 runs the function on the parser thread */
+    rt_uint32_t flags;
 };
 typedef struct at_urc *at_urc_t;
 
@@ -183,6 +203,19 @@ struct at_client
     rt_size_t urc_table_size;
 
     rt_thread_t parser;
+
+#ifdef AT_USING_URC_DEFER
+    /* the URCs waiting for the worker thread */
+    struct rt_rbb *urc_rbb;
+    rt_sem_t urc_notice;
+    rt_thread_t urc_worker;
+    /* the URCs queued and dropped with the queue full */
+    rt_uint32_t urc_deferred;
+    rt_uint32_t urc_dropped;
+    /* the ticks from the line read to the function call */
+    rt_uint32_t urc_wait_total;
+    rt_uint32_t urc_wait_max;
+#endif /* AT_USING_URC_DEFER */
 };
 typedef struct at_client *at_client_t;
 #endif /* AT_USING_CLIENT */
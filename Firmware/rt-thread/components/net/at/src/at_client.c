@@ -10,6 +10,8 @@
  * 2018-08-17     chenyong     multiple client support
  * 2021-03-17     Meco Man     fix a buf of leaking memory
  * 2021-07-14     Sszl         fix a buf of leaking memory
+ * 2026-10-19     RT-Thread    allocate responses from the object cache
+ * 2026-10-19     RT-Thread    run the URCs with AT_URC_FLAG_DEFER on a worker thread
  */
 
 #include <at.h>
@@ -22,6 +24,31 @@
 
 #ifdef AT_USING_CLIENT
 
+#ifdef AT_USING_URC_DEFER
+#include <rtdevice.h>
+
+#ifndef AT_URC_DEFER_QUEUE_SIZE
+#define AT_URC_DEFER_QUEUE_SIZE        1024
+#endif
+#ifndef AT_URC_DEFER_QUEUE_NUM
+#define AT_URC_DEFER_QUEUE_NUM         8
+#endif
+#ifndef AT_URC_DEFER_THREAD_PRIORITY
+#define AT_URC_DEFER_THREAD_PRIORITY   (RT_THREAD_PRIORITY_MAX / 3 + 2)
+#endif
+#ifndef AT_URC_DEFER_THREAD_STACK_SIZE
+#define AT_URC_DEFER_THREAD_STACK_SIZE (1024 + 512)
+#endif
+
+/* the head of a queued URC, the line and a '\0' follow it */
+struct at_urc_event
+{
+    const struct at_urc *urc;
+    rt_tick_t tick;
+    rt_size_t size;
+};
+#endif /* AT_USING_URC_DEFER */
+
 #define AT_RESP_END_OK                 "OK"
 #define AT_RESP_END_ERROR              "ERROR"
 #define AT_RESP_END_FAIL               "FAIL"
@@ -53,18 +80,18 @@ at_response_t at_create_resp(rt_size_t buf_size, rt_size_t line_num, rt_int32_t
 {
     at_response_t resp = RT_NULL;
 
-    resp = (at_response_t) rt_calloc(1, sizeof(struct at_response));
+    resp = (at_response_t) at_calloc(1, sizeof(struct at_response));
     if (resp == RT_NULL)
     {
         LOG_E("AT create response object failed! No memory for response object!");
         return RT_NULL;
     }
 
-    resp->buf = (char *) rt_calloc(1, buf_size);
+    resp->buf = (char *) at_calloc(1, buf_size);
     if (resp->buf == RT_NULL)
     {
         LOG_E("AT create response object failed! No memory for response buffer!");
-        rt_free(resp);
+        at_free(resp);
         return RT_NULL;
     }
 
@@ -85,12 +112,12 @@ void at_delete_resp(at_response_t resp)
 {
     if (resp && resp->buf)
     {
-        rt_free(resp->buf);
+        at_free(resp->buf);
     }
 
     if (resp)
     {
-        rt_free(resp);
+        at_free(resp);
         resp = RT_NULL;
     }
 }
@@ -117,7 +144,7 @@ at_response_t at_resp_set_info(at_response_t resp, rt_size_t buf_size, rt_size_t
     {
         resp->buf_size = buf_size;
 
-        p_temp = (char *) rt_realloc(resp->buf, buf_size);
+        p_temp = (char *) at_realloc(resp->buf, buf_size);
         if (p_temp == RT_NULL)
         {
             LOG_D("No memory for realloc response buffer size(%d).", buf_size);
@@ -720,6 +747,61 @@ static int at_recv_readline(at_client_t client)
     return read_len;
 }
 
+#ifdef AT_USING_URC_DEFER
+/* copy the received URC line to the queue of the worker thread */
+static void client_urc_defer(at_client_t client, const struct at_urc *urc)
+{
+    struct at_urc_event event;
+    rt_rbb_blk_t blk;
+
+    blk = rt_rbb_blk_alloc(client->urc_rbb, sizeof(event) + client->recv_line_len + 1);
+    if (blk == RT_NULL)
+    {
+        client->urc_dropped++;
+        LOG_W("URC queue full, drop the URC(%.*s).", (int)rt_strlen(urc->cmd_prefix), client->recv_line_buf);
+        return;
+    }
+
+    event.urc = urc;
+    event.tick = rt_tick_get();
+    event.size = client->recv_line_len;
+    rt_memcpy(blk->buf, &event, sizeof(event));
+    rt_memcpy(blk->buf + sizeof(event), client->recv_line_buf, client->recv_line_len);
+    blk->buf[sizeof(event) + client->recv_line_len] = '\0';
+    rt_rbb_blk_put(blk);
+
+    client->urc_deferred++;
+    rt_sem_release(client->urc_notice);
+}
+
+static void client_urc_worker(at_client_t client)
+{
+    struct at_urc_event event;
+    rt_rbb_blk_t blk;
+    rt_uint32_t wait;
+
+    while (1)
+    {
+        rt_sem_take(client->urc_notice, RT_WAITING_FOREVER);
+
+        while ((blk = rt_rbb_blk_get(client->urc_rbb)) != RT_NULL)
+        {
+            rt_memcpy(&event, blk->buf, sizeof(event));
+
+            wait = rt_tick_get() - event.tick;
+            client->urc_wait_total += wait;
+            if (wait > client->urc_wait_max)
+            {
+                client->urc_wait_max = wait;
+            }
+
+            event.urc->func(client, (const char *)blk->buf + sizeof(event), event.size);
+            rt_rbb_blk_free(client->urc_rbb, blk);
+        }
+    }
+}
+#endif /* AT_USING_URC_DEFER */
+
 static void client_parser(at_client_t client)
 {
     const struct at_urc *urc;
@@ -733,6 +815,13 @@ static void client_parser(at_client_t client)
                 /* current receive is request, try to execute related operations */
                 if (urc->func != RT_NULL)
                 {
+#ifdef AT_USING_URC_DEFER
+                    if (urc->flags & AT_URC_FLAG_DEFER)
+                    {
+                        client_urc_defer(client, urc);
+                        continue;
+                    }
+#endif
                     urc->func(client, client->recv_line_buf, client->recv_line_len);
                 }
             }
@@ -818,6 +907,8 @@ static int at_client_para_init(at_client_t client)
 #define AT_CLIENT_SEM_NAME             "at_cs"
 #define AT_CLIENT_RESP_NAME            "at_cr"
 #define AT_CLIENT_THREAD_NAME          "at_clnt"
+#define AT_CLIENT_URC_SEM_NAME         "at_cu"
+#define AT_CLIENT_URC_THREAD_NAME      "at_urc"
 
     int result = RT_EOK;
     static int at_client_num = 0;
@@ -877,9 +968,58 @@ static int at_client_para_init(at_client_t client)
         goto __exit;
     }
 
+#ifdef AT_USING_URC_DEFER
+    client->urc_rbb = rt_rbb_create(AT_URC_DEFER_QUEUE_SIZE, AT_URC_DEFER_QUEUE_NUM);
+    if (client->urc_rbb == RT_NULL)
+    {
+        LOG_E("AT client initialize failed! No memory for URC queue.");
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    rt_snprintf(name, RT_NAME_MAX, "%s%d", AT_CLIENT_URC_SEM_NAME, at_client_num);
+    client->urc_notice = rt_sem_create(name, 0, RT_IPC_FLAG_FIFO);
+    if (client->urc_notice == RT_NULL)
+    {
+        LOG_E("AT client initialize failed! at_client_urc semaphore create failed!");
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    rt_snprintf(name, RT_NAME_MAX, "%s%d", AT_CLIENT_URC_THREAD_NAME, at_client_num);
+    client->urc_worker = rt_thread_create(name,
+                                         (void (*)(void *parameter))client_urc_worker,
+                                         client,
+                                         AT_URC_DEFER_THREAD_STACK_SIZE,
+                                         AT_URC_DEFER_THREAD_PRIORITY,
+                                         5);
+    if (client->urc_worker == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+#endif /* AT_USING_URC_DEFER */
+
 __exit:
     if (result != RT_EOK)
     {
+        if (client->parser)
+        {
+            rt_thread_delete(client->parser);
+        }
+
+#ifdef AT_USING_URC_DEFER
+        if (client->urc_rbb)
+        {
+            rt_rbb_destroy(client->urc_rbb);
+        }
+
+        if (client->urc_notice)
+        {
+            rt_sem_delete(client->urc_notice);
+        }
+#endif /* AT_USING_URC_DEFER */
+
         if (client->lock)
         {
             rt_mutex_delete(client->lock);
@@ -988,6 +1128,9 @@ __exit:
         client->status = AT_STATUS_INITIALIZED;
 
         rt_thread_startup(client->parser);
+#ifdef AT_USING_URC_DEFER
+        rt_thread_startup(client->urc_worker);
+#endif
 
         LOG_I("AT client(V%s) on device %s initialize success.", AT_SW_VERSION, dev_name);
     }
@@ -998,4 +1141,32 @@ __exit:
 
     return result;
 }
+
+#if defined(AT_USING_URC_DEFER) && defined(RT_USING_FINSH)
+#include <finsh.h>
+
+static int at_urc(int argc, char **argv)
+{
+    at_client_t client;
+    int idx;
+
+    for (idx = 0; idx < AT_CLIENT_NUM_MAX; idx++)
+    {
+        client = &at_client_table[idx];
+        if (client->device == RT_NULL)
+        {
+            continue;
+        }
+
+        rt_kprintf("%-8.*s deferred %u, dropped %u, wait max %u ms, average %u ms\n",
+                   RT_NAME_MAX, client->device->parent.name, client->urc_deferred, client->urc_dropped,
+                   client->urc_wait_max * 1000 / RT_TICK_PER_SECOND,
+                   client->urc_deferred ? client->urc_wait_total * 1000 / RT_TICK_PER_SECOND / client->urc_deferred : 0);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(at_urc, show the deferred URC counters of the AT clients);
+#endif /* defined(AT_USING_URC_DEFER) && defined(RT_USING_FINSH) */
+
 #endif /* AT_USING_CLIENT */
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+/*
+ * Table driven CRC, RT_CRCLIB_SLICE bytes a step. A step of the slice-by-4
+ * loop looks up four tables with independent indexes, instead of four
+ * dependent lookups of the byte-wise loop. The data is read a byte at a time,
+ * so any alignment and byte order works.
+ */
+
+#include "crclib.h"
+
+#define _LE16(p)    ((rt_uint32_t)(p)[0] | ((rt_uint32_t)(p)[1] << 8))
+#define _LE32(p)    (_LE16(p) | ((rt_uint32_t)(p)[2] << 16) | ((rt_uint32_t)(p)[3] << 24))
+#define _BE16(p)    (((rt_uint32_t)(p)[0] << 8) | (rt_uint32_t)(p)[1])
+
+#ifdef RT_CRCLIB_USING_HW_HOOK
+#ifndef RT_CRCLIB_HW_MIN
+#define RT_CRCLIB_HW_MIN        64
+#endif
+
+static rt_uint32_t (*_crc32_hw)(rt_uint32_t crc, const void *data, rt_size_t len);
+#endif /* RT_CRCLIB_USING_HW_HOOK */
+
+/**
+ * This function updates a CRC-16/MODBUS, the check of "123456789" is 0x4B37.
+ * The CRC goes on the wire low byte first.
+ *
+ * @param crc the CRC of the data before, or RT_CRC16_MODBUS_INIT.
+ * @param data the data.
+ * @param len the bytes of the data.
+ *
+ * @return the CRC including the data.
+ */
+rt_uint16_t rt_crc16_modbus(rt_uint16_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint16_t (*t)[256] = rt_crc16_modbus_table;
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+    rt_uint32_t c = crc;
+
+#if RT_CRCLIB_SLICE == 8
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        c ^= _LE16(p);
+        c = t[7][c & 0xff] ^ t[6][c >> 8] ^ t[5][p[2]] ^ t[4][p[3]] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+#endif
+#if RT_CRCLIB_SLICE >= 4
+    for (; len >= 4; len -= 4, p += 4)
+    {
+        c ^= _LE16(p);
+        c = t[3][c & 0xff] ^ t[2][c >> 8] ^ t[1][p[2]] ^ t[0][p[3]];
+    }
+#endif
+    while (len --)
+        c = (c >> 8) ^ t[0][(c ^ *p++) & 0xff];
+
+    return (rt_uint16_t)c;
+}
+RTM_EXPORT(rt_crc16_modbus);
+
+/**
+ * This function updates a CRC-16/XMODEM, the check of "123456789" is 0x31C3.
+ * The CRC goes on the wire high byte first.
+ *
+ * @param crc the CRC of the data before, or RT_CRC16_CCITT_INIT.
+ * @param data the data.
+ * @param len the bytes of the data.
+ *
+ * @return the CRC including the data.
+ */
+rt_uint16_t rt_crc16_ccitt(rt_uint16_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint16_t (*t)[256] = rt_crc16_ccitt_table;
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+    rt_uint32_t c = crc;
+
+#if RT_CRCLIB_SLICE == 8
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        c ^= _BE16(p);
+        c = t[7][c >> 8] ^ t[6][c & 0xff] ^ t[5][p[2]] ^ t[4][p[3]] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+#endif
+#if RT_CRCLIB_SLICE >= 4
+    for (; len >= 4; len -= 4, p += 4)
+    {
+        c ^= _BE16(p);
+        c = t[3][c >> 8] ^ t[2][c & 0xff] ^ t[1][p[2]] ^ t[0][p[3]];
+    }
+#endif
+    while (len --)
+        c = ((c << 8) & 0xffff) ^ t[0][((c >> 8) ^ *p++) & 0xff];
+
+    return (rt_uint16_t)c;
+}
+RTM_EXPORT(rt_crc16_ccitt);
+
+/**
+ * This function updates a CRC-32, the check of "123456789" is 0xCBF43926.
+ *
+ * @param crc the CRC of the data before, or RT_CRC32_INIT.
+ * @param data the data.
+ * @param len the bytes of the data.
+ *
+ * @return the CRC including the data.
+ */
+rt_uint32_t rt_crc32(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint32_t (*t)[256] = rt_crc32_table;
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+    rt_uint32_t c;
+
+#ifdef RT_CRCLIB_USING_HW_HOOK
+    if (_crc32_hw != RT_NULL && len >= RT_CRCLIB_HW_MIN)
+        return _crc32_hw(crc, data, len);
+#endif /* RT_CRCLIB_USING_HW_HOOK */
+
+    c = ~crc;
+#if RT_CRCLIB_SLICE == 8
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        c ^= _LE32(p);
+        c = t[7][c & 0xff] ^ t[6][(c >> 8) & 0xff] ^ t[5][(c >> 16) & 0xff] ^ t[4][c >> 24] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+#endif
+#if RT_CRCLIB_SLICE >= 4
+    for (; len >= 4; len -= 4, p += 4)
+    {
+        c ^= _LE32(p);
+        c = t[3][c & 0xff] ^ t[2][(c >> 8) & 0xff] ^ t[1][(c >> 16) & 0xff] ^ t[0][c >> 24];
+    }
+#endif
+    while (len --)
+        c = (c >> 8) ^ t[0][(c ^ *p++) & 0xff];
+
+    return ~c;
+}
+RTM_EXPORT(rt_crc32);
+
+#ifdef RT_CRCLIB_USING_HW_HOOK
+/**
+ * This function sets the CRC32 unit of the chip, RT_NULL goes back to the tables.
+ *
+ * @param update the function of the unit, it must give the same result as rt_crc32().
+ */
+void rt_crc32_set_hw(rt_uint32_t (*update)(rt_uint32_t crc, const void *data, rt_size_t len))
+{
+    _crc32_hw = update;
+}
+RTM_EXPORT(rt_crc32_set_hw);
+#endif /* RT_CRCLIB_USING_HW_HOOK */
+
+#if defined(RT_USING_FINSH) && defined(RT_CRCLIB_USING_BENCH)
+#include <stdlib.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()    ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT     "cycles"
+#else
+#define _BENCH_NOW()    ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT     "ticks"
+#endif
+
+/* the bit-wise and the byte-wise ways, as the protocols did before */
+static rt_uint32_t crc32_bitwise(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+    int bit;
+
+    crc = ~crc;
+    while (len --)
+    {
+        crc ^= *p++;
+        for (bit = 0; bit < 8; bit ++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+
+    return ~crc;
+}
+
+static rt_uint32_t crc16_modbus_bitwise(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+    int bit;
+
+    while (len --)
+    {
+        crc ^= *p++;
+        for (bit = 0; bit < 8; bit ++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+
+    return crc;
+}
+
+static rt_uint32_t crc16_ccitt_bitwise(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+    int bit;
+
+    while (len --)
+    {
+        crc ^= (rt_uint32_t)*p++ << 8;
+        for (bit = 0; bit < 8; bit ++)
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xffff : (crc << 1) & 0xffff;
+    }
+
+    return crc;
+}
+
+static rt_uint32_t crc32_bytewise(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)data;
+
+    crc = ~crc;
+    while (len --)
+        crc = (crc >> 8) ^ rt_crc32_table[0][(crc ^ *p++) & 0xff];
+
+    return ~crc;
+}
+
+static rt_uint32_t crc16_modbus_slice(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    return rt_crc16_modbus((rt_uint16_t)crc, data, len);
+}
+
+static rt_uint32_t crc16_ccitt_slice(rt_uint32_t crc, const void *data, rt_size_t len)
+{
+    return rt_crc16_ccitt((rt_uint16_t)crc, data, len);
+}
+
+struct crc_bench_item
+{
+    const char *name;
+    rt_uint32_t (*fun)(rt_uint32_t crc, const void *data, rt_size_t len);
+    rt_uint32_t init;
+    rt_uint32_t check;
+};
+
+static const struct crc_bench_item crc_bench_tab[] =
+{
+    {"crc16-modbus bit-wise  ", crc16_modbus_bitwise, RT_CRC16_MODBUS_INIT, 0x4B37},
+    {"crc16-modbus slice     ", crc16_modbus_slice, RT_CRC16_MODBUS_INIT, 0x4B37},
+    {"crc16-ccitt  bit-wise  ", crc16_ccitt_bitwise, RT_CRC16_CCITT_INIT, 0x31C3},
+    {"crc16-ccitt  slice     ", crc16_ccitt_slice, RT_CRC16_CCITT_INIT, 0x31C3},
+    {"crc32        bit-wise  ", crc32_bitwise, RT_CRC32_INIT, 0xCBF43926},
+    {"crc32        byte-wise ", crc32_bytewise, RT_CRC32_INIT, 0xCBF43926},
+    {"crc32        slice     ", rt_crc32, RT_CRC32_INIT, 0xCBF43926},
+};
+
+static int crc_bench(int argc, char **argv)
+{
+    int size = argc > 1 ? atoi(argv[1]) : 1024;
+    int loops = argc > 2 ? atoi(argv[2]) : 16;
+    rt_uint32_t begin, used, result, expect = 0;
+    rt_uint8_t *buf;
+    int index, loop;
+
+    if (size <= 0 || loops <= 0)
+    {
+        rt_kprintf("Usage: crc_bench [bytes] [loops]\n");
+        return -RT_EINVAL;
+    }
+
+    buf = (rt_uint8_t *)rt_malloc(size);
+    if (buf == RT_NULL)
+        return -RT_ENOMEM;
+    for (index = 0; index < size; index ++)
+        buf[index] = (rt_uint8_t)(index * 131 + 7);
+
+    rt_kprintf("slice-by-%d, %d bytes x %d loops\n", RT_CRCLIB_SLICE, size, loops);
+    for (index = 0; index < sizeof(crc_bench_tab) / sizeof(crc_bench_tab[0]); index ++)
+    {
+        const struct crc_bench_item *item = &crc_bench_tab[index];
+
+        if (item->fun(item->init, "123456789", 9) != item->check)
+            rt_kprintf("%s check value failed!\n", item->name);
+
+        begin = _BENCH_NOW();
+        for (loop = 0; loop < loops; loop ++)
+            result = item->fun(item->init, buf, size);
+        used = _BENCH_NOW() - begin;
+
+        /* the ways of one CRC must agree */
+        if (index == 0 || crc_bench_tab[index - 1].check != item->check)
+            expect = result;
+        else if (result != expect)
+            rt_kprintf("%s result 0x%08x differs from 0x%08x!\n", item->name, result, expect);
+
+        rt_kprintf("%s %10u %s, %u.%02u %s/byte\n", item->name, used, _BENCH_UNIT,
+                   used / (size * loops), used * 100 / (size * loops) % 100, _BENCH_UNIT);
+    }
+    rt_free(buf);
+
+    return 0;
+}
+MSH_CMD_EXPORT(crc_bench, CRC throughput: crc_bench [bytes] [loops]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_CRCLIB_USING_BENCH) */
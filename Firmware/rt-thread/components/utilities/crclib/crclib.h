@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef __CRCLIB_H__
+#define __CRCLIB_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the bytes a table step, 1, 4 or 8, the tables take RT_CRCLIB_SLICE KB of flash for a CRC32 */
+#ifndef RT_CRCLIB_SLICE
+#define RT_CRCLIB_SLICE         4
+#endif
+
+#if RT_CRCLIB_SLICE != 1 && RT_CRCLIB_SLICE != 4 && RT_CRCLIB_SLICE != 8
+#error "RT_CRCLIB_SLICE must be 1, 4 or 8"
+#endif
+
+/*
+ * Every CRC takes the value returned for the data before, so a stream is
+ * checked piece by piece:
+ *
+ *     crc = RT_CRC32_INIT;
+ *     crc = rt_crc32(crc, head, sizeof(head));
+ *     crc = rt_crc32(crc, body, body_len);
+ */
+#define RT_CRC16_MODBUS_INIT    0xFFFF      /* CRC-16/MODBUS, poly 0x8005 reflected, the Modbus RTU frames */
+#define RT_CRC16_CCITT_INIT     0x0000      /* CRC-16/XMODEM, poly 0x1021, ymodem and zmodem */
+#define RT_CRC32_INIT           0x00000000  /* CRC-32, poly 0x04C11DB7 reflected, zmodem and rt-link */
+
+rt_uint16_t rt_crc16_modbus(rt_uint16_t crc, const void *data, rt_size_t len);
+rt_uint16_t rt_crc16_ccitt(rt_uint16_t crc, const void *data, rt_size_t len);
+rt_uint32_t rt_crc32(rt_uint32_t crc, const void *data, rt_size_t len);
+
+#ifdef RT_CRCLIB_USING_HW_HOOK
+/*
+ * A CRC32 unit of the chip, with the same arguments and result as rt_crc32().
+ * rt_crc32() hands the data of RT_CRCLIB_HW_MIN bytes or more to it.
+ */
+void rt_crc32_set_hw(rt_uint32_t (*update)(rt_uint32_t crc, const void *data, rt_size_t len));
+#endif /* RT_CRCLIB_USING_HW_HOOK */
+
+/* the byte-wise tables are the first rows, for the protocols updating a byte at a time */
+extern const rt_uint16_t rt_crc16_modbus_table[RT_CRCLIB_SLICE][256];
+extern const rt_uint16_t rt_crc16_ccitt_table[RT_CRCLIB_SLICE][256];
+extern const rt_uint32_t rt_crc32_table[RT_CRCLIB_SLICE][256];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRCLIB_H__ */
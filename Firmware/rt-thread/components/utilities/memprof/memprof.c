@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#include <rthw.h>
+#include <memprof.h>
+
+#ifndef MEMPROF_TRACK_MAX
+#define MEMPROF_TRACK_MAX       64
+#endif
+#ifndef MEMPROF_THREAD_MAX
+#define MEMPROF_THREAD_MAX      8
+#endif
+#ifndef MEMPROF_CALLER_MAX
+#define MEMPROF_CALLER_MAX      16
+#endif
+
+/* a tracked heap block */
+struct memprof_block
+{
+    void       *ptr;                /* block address, RT_NULL for an empty slot */
+    void       *caller;             /* address which allocated it */
+    rt_size_t   size;               /* requested size */
+    rt_uint32_t seq;                /* allocation sequence number */
+    rt_uint8_t  thread;             /* index of the owner in the thread table */
+    rt_uint8_t  site;               /* index of the caller in the caller table */
+};
+
+struct memprof_thread
+{
+    rt_thread_t thread;             /* RT_NULL is the interrupt and startup context */
+    char        name[RT_NAME_MAX];
+    struct memprof_stat stat;
+};
+
+struct memprof_caller
+{
+    void       *caller;
+    struct memprof_stat stat;
+};
+
+static struct memprof_block _blocks[MEMPROF_TRACK_MAX];
+static struct memprof_thread _threads[MEMPROF_THREAD_MAX];
+static struct memprof_caller _callers[MEMPROF_CALLER_MAX];
+static rt_uint8_t _thread_num, _caller_num;
+static rt_uint32_t _block_num;
+static rt_uint32_t _seq, _mark_seq;
+static rt_uint32_t _untracked;
+static rt_tick_t _start_tick;
+
+rt_inline rt_uint32_t _block_hash(void *ptr)
+{
+    return (rt_uint32_t)(((rt_ubase_t)ptr / RT_ALIGN_SIZE) % MEMPROF_TRACK_MAX);
+}
+
+static struct memprof_block *_block_find(void *ptr)
+{
+    rt_uint32_t index = _block_hash(ptr);
+
+    while (_blocks[index].ptr)
+    {
+        if (_blocks[index].ptr == ptr)
+            return &_blocks[index];
+        index = (index + 1) % MEMPROF_TRACK_MAX;
+    }
+
+    return RT_NULL;
+}
+
+/* remove a block with backward shift, so no tombstone is left in the probe chain */
+static void _block_remove(struct memprof_block *block)
+{
+    rt_uint32_t hole = block - _blocks, index = hole, home;
+
+    while (1)
+    {
+        index = (index + 1) % MEMPROF_TRACK_MAX;
+        if (_blocks[index].ptr == RT_NULL)
+            break;
+
+        home = _block_hash(_blocks[index].ptr);
+        if ((index > hole && (home <= hole || home > index)) ||
+            (index < hole && (home <= hole && home > index)))
+        {
+            _blocks[hole] = _blocks[index];
+            hole = index;
+        }
+    }
+    _blocks[hole].ptr = RT_NULL;
+    _block_num --;
+}
+
+static rt_uint8_t _thread_index(rt_thread_t thread)
+{
+    rt_uint8_t index;
+
+    for (index = 0; index < _thread_num; index ++)
+    {
+        if (_threads[index].thread == thread)
+            return index;
+    }
+
+    /* the last entry collects the threads which do not fit */
+    if (_thread_num == MEMPROF_THREAD_MAX)
+        return MEMPROF_THREAD_MAX - 1;
+
+    _threads[index].thread = thread;
+    if (thread)
+        rt_strncpy(_threads[index].name, thread->name, RT_NAME_MAX);
+    else
+        rt_strncpy(_threads[index].name, "-", RT_NAME_MAX);
+    _thread_num ++;
+
+    return index;
+}
+
+static rt_uint8_t _caller_index(void *caller)
+{
+    rt_uint8_t index;
+
+    for (index = 0; index < _caller_num; index ++)
+    {
+        if (_callers[index].caller == caller)
+            return index;
+    }
+
+    if (_caller_num == MEMPROF_CALLER_MAX)
+        return MEMPROF_CALLER_MAX - 1;
+
+    _callers[index].caller = caller;
+    _caller_num ++;
+
+    return index;
+}
+
+rt_inline void _stat_add(struct memprof_stat *stat, rt_size_t size)
+{
+    stat->allocs ++;
+    stat->live += size;
+    if (stat->live > stat->peak)
+        stat->peak = stat->live;
+}
+
+rt_inline void _stat_sub(struct memprof_stat *stat, rt_size_t size)
+{
+    stat->frees ++;
+    stat->live = stat->live > size ? stat->live - size : 0;
+}
+
+static void _track(void *ptr, rt_size_t size, void *caller)
+{
+    struct memprof_block *block;
+    rt_uint32_t index;
+    rt_thread_t thread;
+
+    if (_start_tick == 0)
+        _start_tick = rt_tick_get();
+
+    /* keep one slot empty to terminate the probe chains */
+    if (_block_num >= MEMPROF_TRACK_MAX - 1)
+    {
+        _untracked ++;
+        return;
+    }
+
+    thread = rt_interrupt_get_nest() ? RT_NULL : rt_thread_self();
+
+    index = _block_hash(ptr);
+    while (_blocks[index].ptr)
+        index = (index + 1) % MEMPROF_TRACK_MAX;
+
+    block = &_blocks[index];
+    block->ptr = ptr;
+    block->caller = caller;
+    block->size = size;
+    block->seq = ++_seq;
+    block->thread = _thread_index(thread);
+    block->site = _caller_index(caller);
+    _block_num ++;
+
+    _stat_add(&_threads[block->thread].stat, size);
+    _stat_add(&_callers[block->site].stat, size);
+}
+
+static void _untrack(void *ptr)
+{
+    struct memprof_block *block;
+
+    block = _block_find(ptr);
+    if (block == RT_NULL)
+        return;
+
+    _stat_sub(&_threads[block->thread].stat, block->size);
+    _stat_sub(&_callers[block->site].stat, block->size);
+    _block_remove(block);
+}
+
+void rt_memprof_alloc(void *ptr, rt_size_t size, void *caller)
+{
+    rt_base_t level;
+
+    if (ptr == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    _track(ptr, size, caller);
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_memprof_realloc(void *rmem, void *ptr, rt_size_t size, void *caller)
+{
+    rt_base_t level;
+
+    /* a failed realloc keeps the old block */
+    if (ptr == RT_NULL && size != 0)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    if (rmem)
+        _untrack(rmem);
+    if (ptr)
+        _track(ptr, size, caller);
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_memprof_retag(void *ptr, void *caller)
+{
+    struct memprof_block *block;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    block = _block_find(ptr);
+    if (block && block->caller != caller)
+    {
+        /* move the allocation to the real call site */
+        _callers[block->site].stat.allocs --;
+        _callers[block->site].stat.live -= block->size;
+        block->caller = caller;
+        block->site = _caller_index(caller);
+        _stat_add(&_callers[block->site].stat, block->size);
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_memprof_free(void *ptr)
+{
+    rt_base_t level;
+
+    if (ptr == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    _untrack(ptr);
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_memprof_reset(void)
+{
+    rt_base_t level;
+    rt_uint32_t index;
+
+    level = rt_hw_interrupt_disable();
+    for (index = 0; index < _thread_num; index ++)
+    {
+        _threads[index].stat.allocs = 0;
+        _threads[index].stat.frees = 0;
+        _threads[index].stat.peak = _threads[index].stat.live;
+    }
+    for (index = 0; index < _caller_num; index ++)
+    {
+        _callers[index].stat.allocs = 0;
+        _callers[index].stat.frees = 0;
+        _callers[index].stat.peak = _callers[index].stat.live;
+    }
+    _untracked = 0;
+    _start_tick = rt_tick_get();
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_memprof_mark(void)
+{
+    _mark_seq = _seq;
+}
+
+rt_err_t rt_memprof_thread_stat(rt_thread_t thread, struct memprof_stat *stat)
+{
+    rt_base_t level;
+    rt_uint8_t index;
+    rt_err_t result = -RT_EEMPTY;
+
+    level = rt_hw_interrupt_disable();
+    for (index = 0; index < _thread_num; index ++)
+    {
+        if (_threads[index].thread == thread)
+        {
+            *stat = _threads[index].stat;
+            result = RT_EOK;
+            break;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static rt_uint32_t _rate(rt_uint32_t allocs)
+{
+    rt_tick_t elapsed = rt_tick_get() - _start_tick;
+
+    if (_start_tick == 0 || elapsed == 0)
+        return 0;
+
+    return (rt_uint32_t)((rt_uint64_t)allocs * RT_TICK_PER_SECOND / elapsed);
+}
+
+static void _heap_show(rt_bool_t dump)
+{
+    rt_size_t total = 0, used = 0, max_used = 0, free_blocks = 0, max_free = 0, free_size;
+    int frag;
+
+    rt_memory_info(&total, &used, &max_used);
+    rt_memory_frag_info(&free_blocks, &max_free);
+    free_size = total - used;
+    frag = free_size && max_free ? (int)(100 - max_free * 100 / free_size) : 0;
+
+    if (dump)
+    {
+        rt_kprintf("memprof:heap,%d,%d,%d,%d,%d,%d,%d,%d\n", rt_tick_get(), total, used,
+                   max_used, free_blocks, max_free, frag, _untracked);
+        return;
+    }
+
+    rt_kprintf("heap total %d, used %d, max used %d\n", total, used, max_used);
+    rt_kprintf("free blocks %d, largest free %d, fragmentation %d%%, untracked %d\n",
+               free_blocks, max_free, frag, _untracked);
+}
+
+static int memprof_show(int argc, char **argv)
+{
+    rt_uint8_t index;
+
+    _heap_show(RT_FALSE);
+
+    rt_kprintf("\n%-*.s live     peak     allocs   frees    alloc/s\n", RT_NAME_MAX, "thread");
+    rt_kprintf("-------- -------- -------- -------- -------- -------\n");
+    for (index = 0; index < _thread_num; index ++)
+    {
+        struct memprof_thread *t = &_threads[index];
+
+        rt_kprintf("%-*.*s %-8d %-8d %-8d %-8d %d\n", RT_NAME_MAX, RT_NAME_MAX, t->name,
+                   t->stat.live, t->stat.peak, t->stat.allocs, t->stat.frees, _rate(t->stat.allocs));
+    }
+
+    rt_kprintf("\ncaller     live     peak     allocs   frees    alloc/s\n");
+    rt_kprintf("---------- -------- -------- -------- -------- -------\n");
+    for (index = 0; index < _caller_num; index ++)
+    {
+        struct memprof_caller *c = &_callers[index];
+
+        rt_kprintf("0x%08x %-8d %-8d %-8d %-8d %d\n", c->caller,
+                   c->stat.live, c->stat.peak, c->stat.allocs, c->stat.frees, _rate(c->stat.allocs));
+    }
+
+    return 0;
+}
+
+static int memprof_dump(int argc, char **argv)
+{
+    rt_uint32_t index;
+    rt_base_t level;
+    struct memprof_block block;
+
+    /* one record per line: memprof:<type>,<fields> */
+    _heap_show(RT_TRUE);
+    for (index = 0; index < _thread_num; index ++)
+    {
+        struct memprof_thread *t = &_threads[index];
+
+        rt_kprintf("memprof:thread,%.*s,%d,%d,%d,%d\n", RT_NAME_MAX, t->name,
+                   t->stat.live, t->stat.peak, t->stat.allocs, t->stat.frees);
+    }
+    for (index = 0; index < _caller_num; index ++)
+    {
+        struct memprof_caller *c = &_callers[index];
+
+        rt_kprintf("memprof:caller,0x%08x,%d,%d,%d,%d\n", c->caller,
+                   c->stat.live, c->stat.peak, c->stat.allocs, c->stat.frees);
+    }
+    for (index = 0; index < MEMPROF_TRACK_MAX; index ++)
+    {
+        level = rt_hw_interrupt_disable();
+        block = _blocks[index];
+        rt_hw_interrupt_enable(level);
+        if (block.ptr == RT_NULL)
+            continue;
+
+        rt_kprintf("memprof:block,0x%08x,%d,0x%08x,%.*s,%d\n", block.ptr, block.size,
+                   block.caller, RT_NAME_MAX, _threads[block.thread].name, block.seq);
+    }
+
+    return 0;
+}
+
+static int memprof_reset(int argc, char **argv)
+{
+    rt_memprof_reset();
+    return 0;
+}
+
+static int memprof_mark(int argc, char **argv)
+{
+    rt_memprof_mark();
+    rt_kprintf("leak window starts after allocation #%d\n", _mark_seq);
+    return 0;
+}
+
+static int memprof_leak(int argc, char **argv)
+{
+    rt_uint32_t index, site, count;
+    rt_size_t bytes;
+    rt_base_t level;
+
+    rt_kprintf("blocks allocated since mark #%d and still alive:\n", _mark_seq);
+    rt_kprintf("caller     blocks   bytes\n");
+    rt_kprintf("---------- -------- --------\n");
+    for (site = 0; site < _caller_num; site ++)
+    {
+        count = 0;
+        bytes = 0;
+        level = rt_hw_interrupt_disable();
+        for (index = 0; index < MEMPROF_TRACK_MAX; index ++)
+        {
+            if (_blocks[index].ptr && _blocks[index].site == site && _blocks[index].seq > _mark_seq)
+            {
+                count ++;
+                bytes += _blocks[index].size;
+            }
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (count)
+            rt_kprintf("0x%08x %-8d %-8d\n", _callers[site].caller, count, bytes);
+    }
+
+    return 0;
+}
+
+struct memprof_cmd_des
+{
+    const char *cmd;
+    int (*fun)(int argc, char **argv);
+};
+
+static const struct memprof_cmd_des cmd_tab[] =
+{
+    {"show", memprof_show},
+    {"dump", memprof_dump},
+    {"reset", memprof_reset},
+    {"mark", memprof_mark},
+    {"leak", memprof_leak},
+};
+
+static int memprof(int argc, char **argv)
+{
+    int index;
+
+    if (argc < 2)
+        return memprof_show(argc, argv);
+
+    for (index = 0; index < sizeof(cmd_tab) / sizeof(cmd_tab[0]); index ++)
+    {
+        if (rt_strcmp(cmd_tab[index].cmd, argv[1]) == 0)
+            return cmd_tab[index].fun(argc, argv);
+    }
+
+    rt_kprintf("Usage:\n");
+    rt_kprintf("memprof [show]  - show heap, per thread and per caller statistics\n");
+    rt_kprintf("memprof dump    - dump statistics and live blocks as records\n");
+    rt_kprintf("memprof reset   - clear counters and peaks\n");
+    rt_kprintf("memprof mark    - start a leak window\n");
+    rt_kprintf("memprof leak    - list blocks allocated since mark and not freed\n");
+
+    return 0;
+}
+MSH_CMD_EXPORT(memprof, heap profiler: memprof [show|dump|reset|mark|leak]);
+#endif /* RT_USING_FINSH */
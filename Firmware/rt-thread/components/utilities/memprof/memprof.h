@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef _MEMPROF_H__
+#define _MEMPROF_H__
+
+#include <rtthread.h>
+
+/* accounting of one thread or one caller address */
+struct memprof_stat
+{
+    rt_size_t   live;               /* bytes allocated and not freed */
+    rt_size_t   peak;               /* max of live */
+    rt_uint32_t allocs;             /* number of allocations */
+    rt_uint32_t frees;              /* number of releases */
+};
+
+/* called by the system heap, do not call them directly */
+void rt_memprof_alloc(void *ptr, rt_size_t size, void *caller);
+void rt_memprof_realloc(void *rmem, void *ptr, rt_size_t size, void *caller);
+void rt_memprof_retag(void *ptr, void *caller);
+void rt_memprof_free(void *ptr);
+
+/* clear all the statistics, tracked blocks are kept */
+void rt_memprof_reset(void);
+/* start a leak window, blocks allocated after it are reported as leak candidates */
+void rt_memprof_mark(void);
+/* get the statistics of a thread, RT_NULL for the interrupt and startup context */
+rt_err_t rt_memprof_thread_stat(rt_thread_t thread, struct memprof_stat *stat);
+
+#endif /* _MEMPROF_H__ */
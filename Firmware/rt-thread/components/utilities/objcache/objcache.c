@@ -0,0 +1,556 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#include <rthw.h>
+#include <objcache.h>
+
+#ifndef OBJCACHE_16_NUM
+#define OBJCACHE_16_NUM         16
+#endif
+#ifndef OBJCACHE_32_NUM
+#define OBJCACHE_32_NUM         16
+#endif
+#ifndef OBJCACHE_48_NUM
+#define OBJCACHE_48_NUM         24
+#endif
+#ifndef OBJCACHE_64_NUM
+#define OBJCACHE_64_NUM         8
+#endif
+#ifndef OBJCACHE_128_NUM
+#define OBJCACHE_128_NUM        4
+#endif
+#ifndef OBJCACHE_256_NUM
+#define OBJCACHE_256_NUM        2
+#endif
+
+#define _CLASS_MAX              6
+
+/* every block of a memory pool is preceded by a pointer to the pool */
+#define _POOL_SIZE(size, num)   ((num) * ((size) + sizeof(rt_uint8_t *)))
+
+#define _ARENA_SIZE             (_POOL_SIZE(16, OBJCACHE_16_NUM) + _POOL_SIZE(32, OBJCACHE_32_NUM) +  \
+                                 _POOL_SIZE(48, OBJCACHE_48_NUM) + _POOL_SIZE(64, OBJCACHE_64_NUM) +  \
+                                 _POOL_SIZE(128, OBJCACHE_128_NUM) + _POOL_SIZE(256, OBJCACHE_256_NUM))
+
+struct objcache_class
+{
+    struct rt_mempool mp;
+    rt_size_t   peak;
+    rt_uint32_t allocs;
+    rt_uint32_t fallbacks;
+};
+
+static const rt_uint16_t _class_cfg[_CLASS_MAX][2] =
+{
+    {16, OBJCACHE_16_NUM},
+    {32, OBJCACHE_32_NUM},
+    {48, OBJCACHE_48_NUM},
+    {64, OBJCACHE_64_NUM},
+    {128, OBJCACHE_128_NUM},
+    {256, OBJCACHE_256_NUM},
+};
+
+/*
+ * all the pools share one arena, so a single range check tells a pool block
+ * from a heap block. The padding keeps the array valid when no class is enabled.
+ */
+ALIGN(RT_ALIGN_SIZE) static rt_uint8_t _arena[_ARENA_SIZE + RT_ALIGN_SIZE];
+static struct objcache_class _classes[_CLASS_MAX];
+/* zero until the pools are ready, everything goes to the heap before it */
+static int _class_num;
+static rt_uint32_t _oversize;
+
+rt_inline rt_bool_t _in_arena(void *ptr)
+{
+    return (rt_uint8_t *)ptr >= _arena && (rt_uint8_t *)ptr < _arena + _ARENA_SIZE;
+}
+
+static struct objcache_class *_class_find(rt_size_t size)
+{
+    int index;
+
+    for (index = 0; index < _class_num; index ++)
+    {
+        if (size <= _classes[index].mp.block_size)
+            return &_classes[index];
+    }
+
+    return RT_NULL;
+}
+
+static struct objcache_class *_class_of(void *ptr)
+{
+    int index;
+    rt_uint8_t *start;
+
+    for (index = 0; index < _class_num; index ++)
+    {
+        start = (rt_uint8_t *)_classes[index].mp.start_address;
+        if ((rt_uint8_t *)ptr >= start && (rt_uint8_t *)ptr < start + _classes[index].mp.size)
+            return &_classes[index];
+    }
+
+    return RT_NULL;
+}
+
+/**
+ * This function allocates a block from the smallest size class which fits,
+ * or from the system heap when the class is empty or the size is larger than
+ * the largest class. It never blocks.
+ *
+ * @param size is the size of the block.
+ *
+ * @return the allocated block, RT_NULL if there is no memory.
+ */
+void *rt_objcache_alloc(rt_size_t size)
+{
+    struct objcache_class *oc;
+    rt_base_t level;
+    rt_size_t used;
+    void *ptr;
+
+    if (size == 0)
+        return RT_NULL;
+
+    oc = _class_find(size);
+    if (oc == RT_NULL)
+    {
+        if (_class_num)
+        {
+            level = rt_hw_interrupt_disable();
+            _oversize ++;
+            rt_hw_interrupt_enable(level);
+        }
+        return rt_malloc(size);
+    }
+
+    ptr = rt_mp_alloc(&oc->mp, 0);
+
+    level = rt_hw_interrupt_disable();
+    if (ptr)
+    {
+        oc->allocs ++;
+        used = oc->mp.block_total_count - oc->mp.block_free_count;
+        if (used > oc->peak)
+            oc->peak = used;
+    }
+    else
+    {
+        oc->fallbacks ++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return ptr ? ptr : rt_malloc(size);
+}
+RTM_EXPORT(rt_objcache_alloc);
+
+/**
+ * This function allocates a zeroed block for an array of count elements.
+ *
+ * @param count is the number of elements.
+ *
+ * @param size is the size of an element.
+ *
+ * @return the allocated block, RT_NULL if there is no memory.
+ */
+void *rt_objcache_calloc(rt_size_t count, rt_size_t size)
+{
+    void *ptr;
+
+    ptr = rt_objcache_alloc(count * size);
+    if (ptr)
+        rt_memset(ptr, 0, count * size);
+
+    return ptr;
+}
+RTM_EXPORT(rt_objcache_calloc);
+
+/**
+ * This function changes the size of a block. A pool block is kept when the
+ * new size still fits in it, otherwise it moves to a new block. A heap block
+ * stays in the heap.
+ *
+ * @param ptr is the block, RT_NULL to allocate a new one.
+ *
+ * @param size is the new size, zero to release the block.
+ *
+ * @return the new block, RT_NULL if there is no memory and the old block is kept.
+ */
+void *rt_objcache_realloc(void *ptr, rt_size_t size)
+{
+    struct objcache_class *oc;
+    void *new_ptr;
+
+    if (ptr == RT_NULL)
+        return rt_objcache_alloc(size);
+
+    if (size == 0)
+    {
+        rt_objcache_free(ptr);
+        return RT_NULL;
+    }
+
+    if (!_in_arena(ptr))
+        return rt_realloc(ptr, size);
+
+    oc = _class_of(ptr);
+    RT_ASSERT(oc != RT_NULL);
+    if (size <= oc->mp.block_size)
+        return ptr;
+
+    new_ptr = rt_objcache_alloc(size);
+    if (new_ptr)
+    {
+        rt_memcpy(new_ptr, ptr, oc->mp.block_size);
+        rt_mp_free(ptr);
+    }
+
+    return new_ptr;
+}
+RTM_EXPORT(rt_objcache_realloc);
+
+/**
+ * This function releases a block of rt_objcache_alloc, rt_objcache_calloc or
+ * rt_objcache_realloc. A block of the system heap is accepted as well.
+ *
+ * @param ptr is the block.
+ */
+void rt_objcache_free(void *ptr)
+{
+    if (ptr == RT_NULL)
+        return;
+
+    if (_in_arena(ptr))
+        rt_mp_free(ptr);
+    else
+        rt_free(ptr);
+}
+RTM_EXPORT(rt_objcache_free);
+
+int rt_objcache_class_num(void)
+{
+    return _class_num;
+}
+RTM_EXPORT(rt_objcache_class_num);
+
+rt_err_t rt_objcache_stat(int index, struct rt_objcache_stat *stat)
+{
+    struct objcache_class *oc;
+    rt_base_t level;
+
+    RT_ASSERT(stat != RT_NULL);
+
+    if (index < 0 || index >= _class_num)
+        return -RT_EINVAL;
+
+    oc = &_classes[index];
+    level = rt_hw_interrupt_disable();
+    stat->block_size = oc->mp.block_size;
+    stat->total = oc->mp.block_total_count;
+    stat->used = oc->mp.block_total_count - oc->mp.block_free_count;
+    stat->peak = oc->peak;
+    stat->allocs = oc->allocs;
+    stat->fallbacks = oc->fallbacks;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_objcache_stat);
+
+rt_uint32_t rt_objcache_oversize(void)
+{
+    return _oversize;
+}
+RTM_EXPORT(rt_objcache_oversize);
+
+static int rt_objcache_init(void)
+{
+    char name[RT_NAME_MAX];
+    rt_uint8_t *start = _arena;
+    int index, num = 0;
+
+    if (_class_num)
+        return 0;
+
+    for (index = 0; index < _CLASS_MAX; index ++)
+    {
+        /* a class without blocks is skipped, its sizes go to the next class */
+        if (_class_cfg[index][1] == 0)
+            continue;
+
+        rt_snprintf(name, sizeof(name), "oc%d", _class_cfg[index][0]);
+        rt_mp_init(&_classes[num].mp, name, start,
+                   _POOL_SIZE(_class_cfg[index][0], _class_cfg[index][1]), _class_cfg[index][0]);
+        start += _POOL_SIZE(_class_cfg[index][0], _class_cfg[index][1]);
+        num ++;
+    }
+    _class_num = num;
+
+    return 0;
+}
+INIT_BOARD_EXPORT(rt_objcache_init);
+
+#if defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+
+static int objcache_show(int argc, char **argv)
+{
+    struct rt_objcache_stat stat;
+    int index;
+
+    rt_kprintf("size  total used  peak  allocs     fallbacks\n");
+    rt_kprintf("----- ----- ----- ----- ---------- ----------\n");
+    for (index = 0; rt_objcache_stat(index, &stat) == RT_EOK; index ++)
+    {
+        rt_kprintf("%-5d %-5d %-5d %-5d %-10d %-10d\n", stat.block_size, stat.total,
+                   stat.used, stat.peak, stat.allocs, stat.fallbacks);
+    }
+    rt_kprintf("arena: %d bytes, oversize allocations: %d\n", _ARENA_SIZE, _oversize);
+
+    return 0;
+}
+
+#ifdef OBJCACHE_USING_BENCH
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()            ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT             "cycles"
+#else
+#define _BENCH_NOW()            ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT             "ticks"
+#endif /* RT_USING_CPUTIME */
+
+/* one downlink every 5 seconds for 24 hours */
+#define _BENCH_MESSAGES         (24 * 3600 / 5)
+/* the block sizes of the replayed allocations on a 32 bit target */
+#define _BENCH_JSON_NODE        40      /* sizeof(cJSON) */
+#define _BENCH_AT_RESP          28      /* sizeof(struct at_response) */
+#define _BENCH_AT_PKT           16      /* sizeof(struct at_recv_pkt) */
+#define _BENCH_TREE_MAX         40
+#define _BENCH_KEEP             16
+
+struct _bench_path
+{
+    const char *name;
+    void *(*alloc)(rt_size_t size);
+    void (*free)(void *ptr);
+};
+
+struct _bench_result
+{
+    rt_uint32_t allocs;
+    rt_uint32_t failed;
+    rt_uint64_t alloc_time;
+    rt_uint64_t free_time;
+    rt_uint32_t worst_alloc;
+    rt_uint32_t worst_free;
+    rt_size_t   heap_used;
+    rt_size_t   free_blocks;
+    rt_size_t   max_free;
+};
+
+struct _bench
+{
+    const struct _bench_path *path;
+    struct _bench_result *res;
+    rt_uint32_t seed;
+};
+
+rt_inline rt_uint32_t _bench_rand(struct _bench *b)
+{
+    b->seed = b->seed * 1103515245 + 12345;
+    return b->seed >> 16;
+}
+
+static void *_bench_alloc(struct _bench *b, rt_size_t size)
+{
+    rt_uint32_t t0, dt;
+    void *ptr;
+
+    t0 = _BENCH_NOW();
+    ptr = b->path->alloc(size);
+    dt = _BENCH_NOW() - t0;
+
+    b->res->allocs ++;
+    b->res->alloc_time += dt;
+    if (dt > b->res->worst_alloc)
+        b->res->worst_alloc = dt;
+    if (ptr == RT_NULL)
+        b->res->failed ++;
+
+    return ptr;
+}
+
+static void _bench_free(struct _bench *b, void *ptr)
+{
+    rt_uint32_t t0, dt;
+
+    if (ptr == RT_NULL)
+        return;
+
+    t0 = _BENCH_NOW();
+    b->path->free(ptr);
+    dt = _BENCH_NOW() - t0;
+
+    b->res->free_time += dt;
+    if (dt > b->res->worst_free)
+        b->res->worst_free = dt;
+}
+
+/* the allocations of one downlink: AT command, socket packet, JSON parse and modbus scratch */
+static void _bench_message(struct _bench *b, void **keep)
+{
+    void *resp, *resp_buf, *pkt, *payload;
+    void *tree[_BENCH_TREE_MAX], *scratch[3];
+    int index, num = 0, members;
+
+    resp = _bench_alloc(b, _BENCH_AT_RESP);
+    resp_buf = _bench_alloc(b, 64 << (_bench_rand(b) % 3));
+
+    pkt = _bench_alloc(b, _BENCH_AT_PKT);
+    payload = _bench_alloc(b, 32 + _bench_rand(b) % 224);
+
+    _bench_free(b, resp_buf);
+    _bench_free(b, resp);
+
+    /* cJSON_Parse: a node and a key per member, some members hold a string */
+    tree[num ++] = _bench_alloc(b, _BENCH_JSON_NODE);
+    members = 4 + _bench_rand(b) % 12;
+    for (index = 0; index < members && num + 3 <= _BENCH_TREE_MAX; index ++)
+    {
+        tree[num ++] = _bench_alloc(b, _BENCH_JSON_NODE);
+        tree[num ++] = _bench_alloc(b, 4 + _bench_rand(b) % 12);
+        if (_bench_rand(b) % 4 == 0)
+            tree[num ++] = _bench_alloc(b, 4 + _bench_rand(b) % 28);
+    }
+
+    scratch[0] = _bench_alloc(b, 16 * sizeof(int));
+    scratch[1] = _bench_alloc(b, 16 * sizeof(rt_uint16_t));
+    scratch[2] = _bench_alloc(b, 16 * sizeof(rt_uint8_t));
+
+    _bench_free(b, payload);
+    _bench_free(b, pkt);
+
+    /* now and then a block outlives the message, like a session or a cached reply */
+    if (_bench_rand(b) % 32 == 0)
+    {
+        index = _bench_rand(b) % _BENCH_KEEP;
+        _bench_free(b, keep[index]);
+        keep[index] = _bench_alloc(b, 16 + _bench_rand(b) % 80);
+    }
+
+    for (index = 0; index < 3; index ++)
+        _bench_free(b, scratch[index]);
+    for (index = 0; index < num; index ++)
+        _bench_free(b, tree[index]);
+}
+
+static void _bench_run(const struct _bench_path *path, struct _bench_result *res, int messages)
+{
+    struct _bench b;
+    void *keep[_BENCH_KEEP];
+    rt_size_t total, max_used;
+    int index;
+
+    rt_memset(res, 0, sizeof(*res));
+    rt_memset(keep, 0, sizeof(keep));
+    b.path = path;
+    b.res = res;
+    /* the same seed for every path, so they replay the same trace */
+    b.seed = 0x2017;
+
+    for (index = 0; index < messages; index ++)
+        _bench_message(&b, keep);
+
+    /* the heap state at the end of the day, the long lived blocks are still there */
+    rt_memory_info(&total, &res->heap_used, &max_used);
+    rt_memory_frag_info(&res->free_blocks, &res->max_free);
+
+    for (index = 0; index < _BENCH_KEEP; index ++)
+        _bench_free(&b, keep[index]);
+}
+
+static int objcache_bench(int argc, char **argv)
+{
+    static const struct _bench_path paths[] =
+    {
+        {"heap", rt_malloc, rt_free},
+        {"objcache", rt_objcache_alloc, rt_objcache_free},
+    };
+    struct _bench_result res;
+    rt_size_t total, used, max_used, free_blocks, max_free;
+    int index, messages = _BENCH_MESSAGES;
+
+    if (argc > 2)
+        messages = atoi(argv[2]);
+    if (messages <= 0)
+    {
+        rt_kprintf("objcache bench [messages]\n");
+        return -RT_EINVAL;
+    }
+
+    rt_memory_info(&total, &used, &max_used);
+    rt_memory_frag_info(&free_blocks, &max_free);
+    rt_kprintf("replay %d downlink messages, time in %s\n", messages, _BENCH_UNIT);
+    rt_kprintf("heap before: %d used, %d free blocks, max free %d\n", used, free_blocks, max_free);
+    rt_kprintf("path     allocs   failed   avg alloc worst alloc avg free worst free heap used free blocks max free\n");
+    rt_kprintf("-------- -------- -------- --------- ----------- -------- ---------- --------- ----------- --------\n");
+
+    for (index = 0; index < sizeof(paths) / sizeof(paths[0]); index ++)
+    {
+        _bench_run(&paths[index], &res, messages);
+        rt_kprintf("%-8s %-8d %-8d %-9d %-11d %-8d %-10d %-9d %-11d %-8d\n", paths[index].name,
+                   res.allocs, res.failed, (rt_uint32_t)(res.alloc_time / res.allocs), res.worst_alloc,
+                   (rt_uint32_t)(res.free_time / res.allocs), res.worst_free,
+                   res.heap_used, res.free_blocks, res.max_free);
+    }
+
+    return 0;
+}
+#endif /* OBJCACHE_USING_BENCH */
+
+struct objcache_cmd_des
+{
+    const char *cmd;
+    int (*fun)(int argc, char **argv);
+};
+
+static const struct objcache_cmd_des cmd_tab[] =
+{
+    {"show", objcache_show},
+#ifdef OBJCACHE_USING_BENCH
+    {"bench", objcache_bench},
+#endif
+};
+
+static int objcache(int argc, char **argv)
+{
+    int index;
+
+    if (argc < 2)
+        return objcache_show(argc, argv);
+
+    for (index = 0; index < sizeof(cmd_tab) / sizeof(cmd_tab[0]); index ++)
+    {
+        if (rt_strcmp(cmd_tab[index].cmd, argv[1]) == 0)
+            return cmd_tab[index].fun(argc, argv);
+    }
+
+    rt_kprintf("Usage:\n");
+    rt_kprintf("objcache [show]          - show the statistics of the size classes\n");
+#ifdef OBJCACHE_USING_BENCH
+    rt_kprintf("objcache bench [count]   - replay count downlink messages on the heap and the pools\n");
+#endif
+
+    return 0;
+}
+MSH_CMD_EXPORT(objcache, size class object cache: objcache [show|bench]);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef _OBJCACHE_H__
+#define _OBJCACHE_H__
+
+#include <rtthread.h>
+
+/* statistics of one size class */
+struct rt_objcache_stat
+{
+    rt_size_t   block_size;         /* size of the blocks of this class */
+    rt_size_t   total;              /* number of blocks */
+    rt_size_t   used;               /* blocks in use */
+    rt_size_t   peak;               /* max of used */
+    rt_uint32_t allocs;             /* allocations served by the pool */
+    rt_uint32_t fallbacks;          /* allocations sent to the heap as the pool was empty */
+};
+
+/*
+ * Allocate from the smallest size class which fits, a full class or a size
+ * larger than the largest class falls back to the system heap. All of them
+ * never block, and the blocks of both kinds are released by rt_objcache_free.
+ */
+void *rt_objcache_alloc(rt_size_t size);
+void *rt_objcache_calloc(rt_size_t count, rt_size_t size);
+void *rt_objcache_realloc(void *ptr, rt_size_t size);
+void rt_objcache_free(void *ptr);
+
+/* get the number of the enabled size classes */
+int rt_objcache_class_num(void);
+/* get the statistics of a size class, index 0 is the smallest one */
+rt_err_t rt_objcache_stat(int index, struct rt_objcache_stat *stat);
+/* get the number of allocations larger than the largest size class */
+rt_uint32_t rt_objcache_oversize(void);
+
+#endif /* _OBJCACHE_H__ */
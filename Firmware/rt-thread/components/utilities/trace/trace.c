@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#include <rthw.h>
+#include <trace.h>
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#ifndef RT_TRACE_BUF_SIZE
+#define RT_TRACE_BUF_SIZE       4096
+#endif
+
+#define TRACE_RECORD_MAX        (RT_TRACE_BUF_SIZE / sizeof(struct rt_trace_record))
+#define TRACE_VERSION           1
+
+static struct rt_trace_record _records[TRACE_RECORD_MAX];
+static rt_uint32_t _next;           /* index of the next record */
+static rt_uint32_t _total;          /* records written since the last clear */
+static rt_uint32_t _lost;           /* records dropped by a full one shot trace */
+static rt_uint8_t _running;
+static rt_uint8_t _oneshot;
+
+rt_inline rt_uint32_t _trace_time(void)
+{
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+/* the counts of the trace time per second */
+static rt_uint32_t _trace_freq(void)
+{
+#ifdef RT_USING_CPUTIME
+    float res = clock_cpu_getres();
+
+    if (res > 0)
+        return (rt_uint32_t)(1000000000.0f / res);
+#endif
+    return RT_TICK_PER_SECOND;
+}
+
+/* the exception number of the running interrupt */
+rt_inline rt_uint8_t _trace_irq_number(void)
+{
+#if defined(ARCH_ARM_CORTEX_M) && defined(__GNUC__) && !defined(__CC_ARM)
+    rt_uint32_t ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return (rt_uint8_t)ipsr;
+#else
+    return 0;
+#endif
+}
+
+static void _trace_put(rt_uint8_t event, rt_uint8_t aux, rt_uint32_t object, rt_uint16_t arg)
+{
+    struct rt_trace_record *record;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (_running)
+    {
+        if (_oneshot && _total >= TRACE_RECORD_MAX)
+        {
+            _lost ++;
+        }
+        else
+        {
+            record = &_records[_next];
+            record->time   = _trace_time();
+            record->object = object;
+            record->arg    = arg;
+            record->event  = event;
+            record->aux    = aux;
+
+            if (++ _next >= TRACE_RECORD_MAX)
+                _next = 0;
+            _total ++;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static void _trace_switch(rt_thread_t from, rt_thread_t to)
+{
+    _trace_put(RT_TRACE_EV_SWITCH, from->stat & RT_THREAD_STAT_MASK,
+               (rt_uint32_t)(rt_ubase_t)to, to->current_priority);
+}
+
+static void _trace_irq_enter(void)
+{
+    _trace_put(RT_TRACE_EV_IRQ_ENTER, _trace_irq_number(), 0, rt_interrupt_get_nest());
+}
+
+static void _trace_irq_leave(void)
+{
+    _trace_put(RT_TRACE_EV_IRQ_LEAVE, _trace_irq_number(), 0, rt_interrupt_get_nest());
+}
+
+rt_inline void _trace_object(rt_uint8_t event, struct rt_object *object)
+{
+    rt_uint8_t type = object->type & ~RT_Object_Class_Static;
+
+    /* only the ipc objects, timers use the same hooks */
+    if (type >= RT_Object_Class_Semaphore && type <= RT_Object_Class_MessageQueue)
+        _trace_put(event, type, (rt_uint32_t)(rt_ubase_t)object, 0);
+}
+
+static void _trace_trytake(struct rt_object *object)
+{
+    _trace_object(RT_TRACE_EV_TRYTAKE, object);
+}
+
+static void _trace_take(struct rt_object *object)
+{
+    _trace_object(RT_TRACE_EV_TAKE, object);
+}
+
+static void _trace_put_object(struct rt_object *object)
+{
+    _trace_object(RT_TRACE_EV_PUT, object);
+}
+
+static void _trace_suspend(rt_thread_t thread)
+{
+    _trace_put(RT_TRACE_EV_SUSPEND, 0, (rt_uint32_t)(rt_ubase_t)thread, 0);
+}
+
+static void _trace_resume(rt_thread_t thread)
+{
+    _trace_put(RT_TRACE_EV_RESUME, 0, (rt_uint32_t)(rt_ubase_t)thread, 0);
+}
+
+static void _trace_sethook(rt_bool_t on)
+{
+    rt_scheduler_sethook(on ? _trace_switch : RT_NULL);
+    rt_interrupt_enter_sethook(on ? _trace_irq_enter : RT_NULL);
+    rt_interrupt_leave_sethook(on ? _trace_irq_leave : RT_NULL);
+    rt_object_trytake_sethook(on ? _trace_trytake : RT_NULL);
+    rt_object_take_sethook(on ? _trace_take : RT_NULL);
+    rt_object_put_sethook(on ? _trace_put_object : RT_NULL);
+    rt_thread_suspend_sethook(on ? _trace_suspend : RT_NULL);
+    rt_thread_resume_sethook(on ? _trace_resume : RT_NULL);
+}
+
+/**
+ * This function will start recording, the scheduler, interrupt, ipc object
+ * and thread suspend/resume hooks are taken by the trace until it stops.
+ *
+ * @param oneshot RT_TRUE to stop recording when the buffer is full,
+ *        RT_FALSE to overwrite the oldest records
+ */
+void rt_trace_start(rt_bool_t oneshot)
+{
+    rt_thread_t thread;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    _oneshot = oneshot;
+    _running = 1;
+    _trace_sethook(RT_TRUE);
+    rt_hw_interrupt_enable(level);
+
+    thread = rt_thread_self();
+    if (thread)
+        _trace_put(RT_TRACE_EV_START, 0, (rt_uint32_t)(rt_ubase_t)thread, thread->current_priority);
+}
+
+/**
+ * This function will stop recording and release the hooks.
+ */
+void rt_trace_stop(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    _running = 0;
+    _trace_sethook(RT_FALSE);
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will drop all the records.
+ */
+void rt_trace_clear(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    _next = 0;
+    _total = 0;
+    _lost = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_trace_mark(rt_uint32_t id, rt_uint16_t value)
+{
+    _trace_put(RT_TRACE_EV_MARK, 0, id, value);
+}
+
+void rt_trace_begin(rt_uint32_t id, rt_uint16_t value)
+{
+    _trace_put(RT_TRACE_EV_BEGIN, 0, id, value);
+}
+
+void rt_trace_end(rt_uint32_t id, rt_uint16_t value)
+{
+    _trace_put(RT_TRACE_EV_END, 0, id, value);
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+
+#define TRACE_DUMP_PER_LINE     4
+
+static void _trace_dump_objects(rt_uint8_t type)
+{
+    struct rt_object_information *information;
+    struct rt_object *object;
+    struct rt_list_node *node;
+
+    information = rt_object_get_information((enum rt_object_class_type)type);
+    if (information == RT_NULL)
+        return;
+
+    rt_enter_critical();
+    for (node = information->object_list.next; node != &information->object_list; node = node->next)
+    {
+        object = rt_list_entry(node, struct rt_object, list);
+        if (type == RT_Object_Class_Thread)
+        {
+            rt_kprintf("trace:thread,0x%08x,%.*s,%d\n", object, RT_NAME_MAX, object->name,
+                       ((rt_thread_t)object)->current_priority);
+        }
+        else
+        {
+            rt_kprintf("trace:object,0x%08x,%d,%.*s\n", object, type, RT_NAME_MAX, object->name);
+        }
+    }
+    rt_exit_critical();
+}
+
+static int trace_dump(int argc, char **argv)
+{
+    struct rt_trace_record *record;
+    rt_uint32_t count, index, i;
+    rt_uint8_t type;
+
+    /* the console output would be recorded too */
+    rt_trace_stop();
+
+    count = _total < TRACE_RECORD_MAX ? _total : TRACE_RECORD_MAX;
+    index = _total < TRACE_RECORD_MAX ? 0 : _next;
+
+    /* one record per line: trace:<type>,<fields> */
+    rt_kprintf("trace:header,%d,%d,%d,%d,%d\n", TRACE_VERSION, _trace_freq(), count, _total, _lost);
+    for (type = RT_Object_Class_Thread; type <= RT_Object_Class_MessageQueue; type ++)
+    {
+        _trace_dump_objects(type);
+    }
+
+    for (i = 0; i < count; i ++)
+    {
+        record = &_records[(index + i) % TRACE_RECORD_MAX];
+        if (i % TRACE_DUMP_PER_LINE == 0)
+            rt_kprintf("trace:records,");
+        rt_kprintf("%08x%08x%04x%02x%02x", record->time, record->object,
+                   record->arg, record->event, record->aux);
+        if (i % TRACE_DUMP_PER_LINE == TRACE_DUMP_PER_LINE - 1 || i == count - 1)
+            rt_kprintf("\n");
+    }
+    rt_kprintf("trace:end\n");
+
+    return 0;
+}
+
+static int trace_show(int argc, char **argv)
+{
+    rt_kprintf("trace %s, %s\n", _running ? "running" : "stopped", _oneshot ? "one shot" : "ring");
+    rt_kprintf("records: %d of %d, written: %d, lost: %d\n",
+               _total < TRACE_RECORD_MAX ? _total : TRACE_RECORD_MAX, TRACE_RECORD_MAX, _total, _lost);
+    return 0;
+}
+
+static int trace_start(int argc, char **argv)
+{
+    rt_trace_clear();
+    rt_trace_start(argc > 2 && !rt_strcmp(argv[2], "oneshot"));
+    return 0;
+}
+
+static int trace_stop(int argc, char **argv)
+{
+    rt_trace_stop();
+    return trace_show(argc, argv);
+}
+
+static int trace_mark(int argc, char **argv)
+{
+    rt_trace_mark(argc > 2 ? atoi(argv[2]) : 0, argc > 3 ? atoi(argv[3]) : 0);
+    return 0;
+}
+
+struct trace_cmd_des
+{
+    const char *cmd;
+    int (*fun)(int argc, char **argv);
+};
+
+static const struct trace_cmd_des cmd_tab[] =
+{
+    {"show", trace_show},
+    {"start", trace_start},
+    {"stop", trace_stop},
+    {"dump", trace_dump},
+    {"mark", trace_mark},
+};
+
+static int trace(int argc, char **argv)
+{
+    int index;
+
+    if (argc < 2)
+        return trace_show(argc, argv);
+
+    for (index = 0; index < sizeof(cmd_tab) / sizeof(cmd_tab[0]); index ++)
+    {
+        if (rt_strcmp(cmd_tab[index].cmd, argv[1]) == 0)
+            return cmd_tab[index].fun(argc, argv);
+    }
+
+    rt_kprintf("Usage:\n");
+    rt_kprintf("trace [show]            - show the trace buffer status\n");
+    rt_kprintf("trace start [oneshot]   - clear and start recording\n");
+    rt_kprintf("trace stop              - stop recording\n");
+    rt_kprintf("trace dump              - stop and dump the records for tools/trace_decode.py\n");
+    rt_kprintf("trace mark <id> [value] - record a user marker\n");
+
+    return 0;
+}
+MSH_CMD_EXPORT(trace, scheduler and ipc trace: trace [show|start|stop|dump|mark]);
+#endif /* RT_USING_FINSH */
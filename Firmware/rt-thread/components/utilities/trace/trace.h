@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef _TRACE_H__
+#define _TRACE_H__
+
+#include <rtthread.h>
+
+/* trace events, the values are part of the dump format */
+enum rt_trace_event
+{
+    RT_TRACE_EV_START = 0,          /* object: current thread */
+    RT_TRACE_EV_SWITCH,             /* object: next thread, arg: priority, aux: stat of the previous thread */
+    RT_TRACE_EV_IRQ_ENTER,          /* arg: nest, aux: exception number */
+    RT_TRACE_EV_IRQ_LEAVE,          /* arg: nest, aux: exception number */
+    RT_TRACE_EV_TRYTAKE,            /* object: ipc object, aux: object class */
+    RT_TRACE_EV_TAKE,               /* object: ipc object, aux: object class */
+    RT_TRACE_EV_PUT,                /* object: ipc object, aux: object class */
+    RT_TRACE_EV_SUSPEND,            /* object: thread */
+    RT_TRACE_EV_RESUME,             /* object: thread */
+    RT_TRACE_EV_MARK,               /* object: marker id, arg: value */
+    RT_TRACE_EV_BEGIN,              /* object: marker id, arg: value */
+    RT_TRACE_EV_END,                /* object: marker id, arg: value */
+};
+
+/* one trace record, 12 bytes */
+struct rt_trace_record
+{
+    rt_uint32_t time;               /* low 32 bits of the cpu time */
+    rt_uint32_t object;             /* address of the thread or the object, or marker id */
+    rt_uint16_t arg;
+    rt_uint8_t  event;
+    rt_uint8_t  aux;
+};
+
+/* start recording, a one shot trace stops when the buffer is full, otherwise the oldest records are overwritten */
+void rt_trace_start(rt_bool_t oneshot);
+void rt_trace_stop(void);
+void rt_trace_clear(void);
+
+/* user markers, an instant event or a span between begin and end */
+void rt_trace_mark(rt_uint32_t id, rt_uint16_t value);
+void rt_trace_begin(rt_uint32_t id, rt_uint16_t value);
+void rt_trace_end(rt_uint32_t id, rt_uint16_t value);
+
+#endif /* _TRACE_H__ */
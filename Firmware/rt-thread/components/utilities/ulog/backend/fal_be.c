@@ -0,0 +1,636 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#include <rthw.h>
+#include <ulog.h>
+
+#ifdef ULOG_BACKEND_USING_FAL
+
+#include <fal.h>
+#include <crclib.h>
+
+/*
+ * The partition is used as a ring of erase sectors. Every sector starts with
+ * a header holding a sequence number, so the newest sector is found on boot,
+ * and the sectors are erased in turn, so the wear is even.
+ *
+ * The logs are gathered in a page buffer and written as one chunk when it is
+ * full or the backend is flushed. A chunk has a header with its length and
+ * the CRC32 of the text, a chunk cut by a power loss fails the check and the
+ * writing goes on from the next sector. So only the page in RAM and the chunk
+ * being written can be lost.
+ *
+ *   sector: | sector hdr | chunk hdr | text | chunk hdr | text | ... | erased |
+ */
+
+#ifndef ULOG_BACKEND_FAL_PART_NAME
+#define ULOG_BACKEND_FAL_PART_NAME     "ulog"
+#endif
+
+#ifndef ULOG_BACKEND_FAL_BUF_SIZE
+#define ULOG_BACKEND_FAL_BUF_SIZE      256
+#endif
+
+#if ULOG_BACKEND_FAL_BUF_SIZE % 8 != 0
+#error "The ULOG_BACKEND_FAL_BUF_SIZE must be a multiple of 8"
+#endif
+
+#define FAL_BE_SECTOR_MAGIC            0x474F4C55       /* "ULOG" */
+#define FAL_BE_CHUNK_MAGIC             0x4C55
+
+struct fal_be_sector_hdr
+{
+    rt_uint32_t magic;
+    rt_uint32_t seq;
+};
+
+struct fal_be_chunk_hdr
+{
+    rt_uint16_t magic;
+    rt_uint16_t len;
+    rt_uint32_t crc;
+};
+
+#define FAL_BE_TEXT_MAX                (ULOG_BACKEND_FAL_BUF_SIZE - sizeof(struct fal_be_chunk_hdr))
+
+struct fal_be
+{
+    struct ulog_backend parent;
+    const struct fal_partition *part;
+    rt_uint32_t sector_size;
+    rt_uint32_t sector_num;
+    /* the write alignment of the flash */
+    rt_uint32_t align;
+    /* the sector being written, its sequence and the write offset in it */
+    rt_uint32_t sector;
+    rt_uint32_t seq;
+    rt_uint32_t offset;
+    struct rt_mutex lock;
+    /* statistics since the boot */
+    rt_uint32_t log_bytes;
+    rt_uint32_t flash_bytes;
+    rt_uint32_t erase_count;
+    /* the text bytes in the page buffer */
+    rt_size_t len;
+    /* the page buffer, the chunk header is filled in the front when writing */
+    rt_uint32_t buf[ULOG_BACKEND_FAL_BUF_SIZE / sizeof(rt_uint32_t)];
+};
+
+/*
+ * The reading position of the dump. The write position is taken once, then
+ * the partition is read without the lock while the logging goes on: a sector
+ * erased for the new logs meanwhile has a newer sequence, the rest of it is
+ * skipped.
+ */
+struct fal_be_reader
+{
+    rt_uint32_t sector;
+    rt_uint32_t sectors_left;
+    /* the offset of the next chunk in the sector, 0 before the sector header is checked */
+    rt_uint32_t offset;
+    /* the sequence of the sector being read, and the newest one at the start */
+    rt_uint32_t sector_seq;
+    rt_uint32_t seq;
+    /* the end of the text in the last sector at the start */
+    rt_uint32_t end_offset;
+    rt_uint32_t pos;
+    rt_uint32_t left;
+    rt_uint8_t text[FAL_BE_TEXT_MAX];
+};
+
+static struct fal_be fal_be = { 0 };
+
+rt_inline rt_uint32_t fal_be_chunk_size(rt_size_t len)
+{
+    return RT_ALIGN(sizeof(struct fal_be_chunk_hdr) + len, fal_be.align);
+}
+
+rt_inline rt_uint32_t fal_be_first_chunk(void)
+{
+    return RT_ALIGN(sizeof(struct fal_be_sector_hdr), fal_be.align);
+}
+
+static rt_err_t fal_be_sector_open(rt_uint32_t sector, rt_uint32_t seq)
+{
+    struct fal_be_sector_hdr hdr;
+    rt_uint32_t addr = sector * fal_be.sector_size;
+
+    if (fal_partition_erase(fal_be.part, addr, fal_be.sector_size) < 0)
+        return -RT_EIO;
+    fal_be.erase_count++;
+
+    hdr.magic = FAL_BE_SECTOR_MAGIC;
+    hdr.seq = seq;
+    if (fal_partition_write(fal_be.part, addr, (const rt_uint8_t *)&hdr, sizeof(hdr)) < 0)
+        return -RT_EIO;
+    fal_be.flash_bytes += fal_be_first_chunk();
+
+    fal_be.sector = sector;
+    fal_be.seq = seq;
+    fal_be.offset = fal_be_first_chunk();
+
+    return RT_EOK;
+}
+
+/* write the page buffer as one chunk */
+static rt_err_t fal_be_write_page(void)
+{
+    struct fal_be_chunk_hdr *hdr = (struct fal_be_chunk_hdr *)fal_be.buf;
+    rt_uint8_t *text = (rt_uint8_t *)fal_be.buf + sizeof(struct fal_be_chunk_hdr);
+    rt_uint32_t size;
+    rt_err_t result;
+
+    if (fal_be.len == 0)
+        return RT_EOK;
+
+    size = fal_be_chunk_size(fal_be.len);
+    if (fal_be.offset + size > fal_be.sector_size)
+    {
+        /* the oldest sector is erased */
+        result = fal_be_sector_open((fal_be.sector + 1) % fal_be.sector_num, fal_be.seq + 1);
+        if (result != RT_EOK)
+        {
+            fal_be.len = 0;
+            return result;
+        }
+    }
+
+    hdr->magic = FAL_BE_CHUNK_MAGIC;
+    hdr->len = fal_be.len;
+    hdr->crc = rt_crc32(RT_CRC32_INIT, text, fal_be.len);
+    /* keep the padding erased */
+    rt_memset(text + fal_be.len, 0xFF, size - sizeof(struct fal_be_chunk_hdr) - fal_be.len);
+
+    result = fal_partition_write(fal_be.part, fal_be.sector * fal_be.sector_size + fal_be.offset,
+            (const rt_uint8_t *)fal_be.buf, size) < 0 ? -RT_EIO : RT_EOK;
+
+    /* the page is dropped on error, and the next chunk goes to the next sector,
+     * so a broken chunk is always the last one of its sector */
+    fal_be.offset = result == RT_EOK ? fal_be.offset + size : fal_be.sector_size;
+    fal_be.flash_bytes += size;
+    fal_be.len = 0;
+
+    return result;
+}
+
+/* find the write position after a reset, a broken chunk makes it start from the next sector */
+static rt_err_t fal_be_load(void)
+{
+    struct fal_be_sector_hdr sector_hdr;
+    struct fal_be_chunk_hdr hdr;
+    rt_uint8_t *text = (rt_uint8_t *)fal_be.buf;
+    rt_uint32_t sector, base, offset;
+    rt_bool_t found = RT_FALSE;
+
+    for (sector = 0; sector < fal_be.sector_num; sector++)
+    {
+        fal_partition_read(fal_be.part, sector * fal_be.sector_size, (rt_uint8_t *)&sector_hdr, sizeof(sector_hdr));
+        if (sector_hdr.magic != FAL_BE_SECTOR_MAGIC)
+            continue;
+        if (!found || (rt_int32_t)(sector_hdr.seq - fal_be.seq) > 0)
+        {
+            fal_be.sector = sector;
+            fal_be.seq = sector_hdr.seq;
+            found = RT_TRUE;
+        }
+    }
+
+    if (!found)
+        return fal_be_sector_open(0, 1);
+
+    base = fal_be.sector * fal_be.sector_size;
+    for (offset = fal_be_first_chunk(); offset + sizeof(hdr) <= fal_be.sector_size; offset += fal_be_chunk_size(hdr.len))
+    {
+        fal_partition_read(fal_be.part, base + offset, (rt_uint8_t *)&hdr, sizeof(hdr));
+        if (hdr.magic == 0xFFFF && hdr.len == 0xFFFF && hdr.crc == 0xFFFFFFFF)
+        {
+            /* the erased space */
+            fal_be.offset = offset;
+            return RT_EOK;
+        }
+        if (hdr.magic != FAL_BE_CHUNK_MAGIC || hdr.len > FAL_BE_TEXT_MAX
+                || offset + fal_be_chunk_size(hdr.len) > fal_be.sector_size)
+        {
+            break;
+        }
+
+        fal_partition_read(fal_be.part, base + offset + sizeof(hdr), text, hdr.len);
+        if (rt_crc32(RT_CRC32_INIT, text, hdr.len) != hdr.crc)
+            break;
+    }
+
+    if (offset + sizeof(hdr) > fal_be.sector_size)
+    {
+        /* the sector is full */
+        fal_be.offset = fal_be.sector_size;
+        return RT_EOK;
+    }
+
+    /* the tail was cut by a power loss, it can not be written again before erasing */
+    return fal_be_sector_open((fal_be.sector + 1) % fal_be.sector_num, fal_be.seq + 1);
+}
+
+static void fal_be_output(struct ulog_backend *backend, rt_uint32_t level, const char *tag, rt_bool_t is_raw,
+        const char *log, rt_size_t len)
+{
+    rt_size_t n;
+
+    /* the flash is not written in the ISR */
+    if (rt_interrupt_get_nest() != 0)
+        return;
+
+    rt_mutex_take(&fal_be.lock, RT_WAITING_FOREVER);
+    fal_be.log_bytes += len;
+    /* keep the line in one chunk if it can, so the oldest chunk starts with a whole line */
+    if (fal_be.len + len > FAL_BE_TEXT_MAX)
+        fal_be_write_page();
+    while (len)
+    {
+        n = FAL_BE_TEXT_MAX - fal_be.len;
+        if (n > len)
+            n = len;
+        rt_memcpy((rt_uint8_t *)fal_be.buf + sizeof(struct fal_be_chunk_hdr) + fal_be.len, log, n);
+        fal_be.len += n;
+        log += n;
+        len -= n;
+        if (fal_be.len == FAL_BE_TEXT_MAX)
+            fal_be_write_page();
+    }
+    rt_mutex_release(&fal_be.lock);
+}
+
+static void fal_be_flush(struct ulog_backend *backend)
+{
+    if (rt_interrupt_get_nest() != 0)
+        return;
+
+    rt_mutex_take(&fal_be.lock, RT_WAITING_FOREVER);
+    fal_be_write_page();
+    rt_mutex_release(&fal_be.lock);
+}
+
+/* write the page and start from the sector after the one being written, that is the oldest */
+static void fal_be_reader_init(struct fal_be_reader *reader)
+{
+    rt_mutex_take(&fal_be.lock, RT_WAITING_FOREVER);
+    fal_be_write_page();
+    reader->sector = (fal_be.sector + 1) % fal_be.sector_num;
+    reader->seq = fal_be.seq;
+    reader->end_offset = fal_be.offset;
+    rt_mutex_release(&fal_be.lock);
+
+    reader->sectors_left = fal_be.sector_num;
+    reader->offset = 0;
+    reader->left = 0;
+}
+
+static rt_bool_t fal_be_next_chunk(struct fal_be_reader *reader)
+{
+    struct fal_be_sector_hdr sector_hdr;
+    struct fal_be_chunk_hdr hdr;
+    rt_uint32_t base, end;
+
+    while (reader->sectors_left)
+    {
+        base = reader->sector * fal_be.sector_size;
+        /* the last sector is read up to the write position at the start */
+        end = reader->sectors_left == 1 ? reader->end_offset : fal_be.sector_size;
+        if (reader->offset == 0)
+        {
+            fal_partition_read(fal_be.part, base, (rt_uint8_t *)&sector_hdr, sizeof(sector_hdr));
+            if (sector_hdr.magic == FAL_BE_SECTOR_MAGIC && (rt_int32_t)(sector_hdr.seq - reader->seq) <= 0)
+            {
+                reader->sector_seq = sector_hdr.seq;
+                reader->offset = fal_be_first_chunk();
+            }
+        }
+
+        if (reader->offset != 0 && reader->offset + sizeof(hdr) <= end)
+        {
+            fal_partition_read(fal_be.part, base + reader->offset, (rt_uint8_t *)&hdr, sizeof(hdr));
+            if (hdr.magic == FAL_BE_CHUNK_MAGIC && hdr.len <= FAL_BE_TEXT_MAX
+                    && reader->offset + fal_be_chunk_size(hdr.len) <= end)
+            {
+                fal_partition_read(fal_be.part, base + reader->offset + sizeof(hdr), reader->text, hdr.len);
+                /* the sector is still the one the chunk header was read from */
+                fal_partition_read(fal_be.part, base, (rt_uint8_t *)&sector_hdr, sizeof(sector_hdr));
+                /* a broken chunk is the last one of the sector */
+                if (sector_hdr.magic == FAL_BE_SECTOR_MAGIC && sector_hdr.seq == reader->sector_seq
+                        && rt_crc32(RT_CRC32_INIT, reader->text, hdr.len) == hdr.crc)
+                {
+                    reader->pos = 0;
+                    reader->left = hdr.len;
+                    reader->offset += fal_be_chunk_size(hdr.len);
+                    return RT_TRUE;
+                }
+            }
+        }
+
+        /* the end of this sector */
+        reader->sector = (reader->sector + 1) % fal_be.sector_num;
+        reader->sectors_left--;
+        reader->offset = 0;
+    }
+
+    return RT_FALSE;
+}
+
+/* read the stored text from the oldest one */
+static rt_size_t fal_be_read(struct fal_be_reader *reader, rt_uint8_t *buf, rt_size_t size)
+{
+    rt_size_t len = 0, n;
+
+    while (len < size)
+    {
+        if (reader->left == 0 && !fal_be_next_chunk(reader))
+            break;
+
+        n = size - len < reader->left ? size - len : reader->left;
+        rt_memcpy(buf + len, reader->text + reader->pos, n);
+        reader->pos += n;
+        reader->left -= n;
+        len += n;
+    }
+
+    return len;
+}
+
+int ulog_fal_backend_init(void)
+{
+    const struct fal_flash_dev *flash;
+
+    if (!fal_init_check())
+        fal_init();
+
+    fal_be.part = fal_partition_find(ULOG_BACKEND_FAL_PART_NAME);
+    if (fal_be.part == RT_NULL)
+    {
+        rt_kprintf("Error: ulog fal backend partition (%s) not found.\n", ULOG_BACKEND_FAL_PART_NAME);
+        return -RT_ERROR;
+    }
+    flash = fal_flash_device_find(fal_be.part->flash_name);
+    RT_ASSERT(flash);
+
+    fal_be.sector_size = flash->blk_size;
+    fal_be.sector_num = fal_be.part->len / flash->blk_size;
+    fal_be.align = flash->write_gran > 32 ? flash->write_gran / 8 : 4;
+    if (fal_be.sector_num < 2 || fal_be.sector_size < fal_be_first_chunk() + ULOG_BACKEND_FAL_BUF_SIZE
+            || ULOG_BACKEND_FAL_BUF_SIZE % fal_be.align != 0)
+    {
+        rt_kprintf("Error: ulog fal backend partition (%s) needs 2 sectors bigger than the page at least.\n",
+                ULOG_BACKEND_FAL_PART_NAME);
+        return -RT_ERROR;
+    }
+
+    rt_mutex_init(&fal_be.lock, "ulog_fal", RT_IPC_FLAG_PRIO);
+    if (fal_be_load() != RT_EOK)
+    {
+        rt_kprintf("Error: ulog fal backend partition (%s) write failed.\n", ULOG_BACKEND_FAL_PART_NAME);
+        rt_mutex_detach(&fal_be.lock);
+        return -RT_EIO;
+    }
+
+    ulog_init();
+    fal_be.parent.output = fal_be_output;
+    fal_be.parent.flush = fal_be_flush;
+    ulog_backend_register(&fal_be.parent, "fal", RT_FALSE);
+
+    return 0;
+}
+INIT_ENV_EXPORT(ulog_fal_backend_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+#include <stdlib.h>
+
+#ifdef RT_USING_RYM
+#include <ymodem.h>
+#endif
+
+#define FAL_BE_DUMP_SIZE               64
+
+static int ulog_fal_info(int argc, char **argv)
+{
+    rt_kprintf("partition   : %s, %d sectors of %d bytes\n", fal_be.part->name, fal_be.sector_num, fal_be.sector_size);
+    rt_kprintf("writing     : sector %d, seq %d, offset %d, %d bytes in page\n", fal_be.sector, fal_be.seq,
+            fal_be.offset, fal_be.len);
+    rt_kprintf("since boot  : %d log bytes, %d flash bytes, %d erases\n", fal_be.log_bytes, fal_be.flash_bytes,
+            fal_be.erase_count);
+    if (fal_be.log_bytes)
+    {
+        rt_kprintf("write amplification: %d.%02d\n", fal_be.flash_bytes / fal_be.log_bytes,
+                fal_be.flash_bytes % fal_be.log_bytes * 100 / fal_be.log_bytes);
+    }
+    return 0;
+}
+
+static int ulog_fal_dump(int argc, char **argv)
+{
+    struct fal_be_reader *reader;
+    char buf[FAL_BE_DUMP_SIZE + 1];
+    rt_size_t len;
+    rt_device_t console = rt_console_get_device();
+
+    reader = rt_malloc(sizeof(struct fal_be_reader));
+    if (reader == RT_NULL)
+    {
+        rt_kprintf("rt_malloc failed\n");
+        return -RT_ENOMEM;
+    }
+
+    /* the logging goes on while the console prints */
+    fal_be_reader_init(reader);
+    while ((len = fal_be_read(reader, (rt_uint8_t *)buf, FAL_BE_DUMP_SIZE)) > 0)
+    {
+        if (console)
+        {
+            rt_device_write(console, 0, buf, len);
+        }
+        else
+        {
+            buf[len] = '\0';
+            rt_kputs(buf);
+        }
+    }
+    rt_free(reader);
+
+    return 0;
+}
+
+static int ulog_fal_clean(int argc, char **argv)
+{
+    rt_mutex_take(&fal_be.lock, RT_WAITING_FOREVER);
+    fal_be.len = 0;
+    if (fal_partition_erase_all(fal_be.part) < 0 || fal_be_sector_open(0, fal_be.seq + 1) != RT_EOK)
+        rt_kprintf("Error: ulog fal backend partition (%s) erase failed.\n", fal_be.part->name);
+    rt_mutex_release(&fal_be.lock);
+
+    return 0;
+}
+
+/* write the lines to the backend directly, the time includes the flash writing */
+static int ulog_fal_bench(int argc, char **argv)
+{
+    char line[80];
+    rt_uint32_t count = argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 1000;
+    rt_uint32_t log_bytes, flash_bytes, erase_count, i, len;
+    rt_tick_t tick;
+
+    log_bytes = fal_be.log_bytes;
+    flash_bytes = fal_be.flash_bytes;
+    erase_count = fal_be.erase_count;
+
+    tick = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        len = rt_snprintf(line, sizeof(line), "[%d] I/bench: fal backend bench line %d, reg 0x%04x" ULOG_NEWLINE_SIGN,
+                rt_tick_get(), i, i * 7);
+        fal_be_output(&fal_be.parent, LOG_LVL_INFO, "bench", RT_FALSE, line, len);
+    }
+    fal_be_flush(&fal_be.parent);
+    tick = rt_tick_get() - tick;
+
+    log_bytes = fal_be.log_bytes - log_bytes;
+    flash_bytes = fal_be.flash_bytes - flash_bytes;
+    rt_kprintf("%d logs, %d bytes in %d ms: %d logs/s\n", count, log_bytes, tick * 1000 / RT_TICK_PER_SECOND,
+            tick ? count * RT_TICK_PER_SECOND / tick : count * RT_TICK_PER_SECOND);
+    rt_kprintf("%d flash bytes, %d erases, write amplification: %d.%02d\n", flash_bytes,
+            fal_be.erase_count - erase_count, flash_bytes / log_bytes, flash_bytes % log_bytes * 100 / log_bytes);
+
+    return 0;
+}
+
+#ifdef RT_USING_RYM
+struct fal_be_rym_ctx
+{
+    struct rym_ctx parent;
+    struct fal_be_reader reader;
+};
+
+static enum rym_code fal_be_rym_begin(struct rym_ctx *ctx, rt_uint8_t *buf, rt_size_t len)
+{
+    struct fal_be_rym_ctx *cctx = (struct fal_be_rym_ctx *)ctx;
+    rt_uint8_t text[FAL_BE_DUMP_SIZE];
+    rt_size_t size = 0, n;
+
+    /* the file size goes first */
+    fal_be_reader_init(&cctx->reader);
+    while ((n = fal_be_read(&cctx->reader, text, sizeof(text))) > 0)
+        size += n;
+    fal_be_reader_init(&cctx->reader);
+
+    rt_memset(buf, 0, len);
+    rt_snprintf((char *)buf + sizeof("ulog.log"), len - sizeof("ulog.log"), "%d", size);
+    rt_memcpy(buf, "ulog.log", sizeof("ulog.log"));
+
+    return RYM_CODE_SOH;
+}
+
+static enum rym_code fal_be_rym_data(struct rym_ctx *ctx, rt_uint8_t *buf, rt_size_t len)
+{
+    struct fal_be_rym_ctx *cctx = (struct fal_be_rym_ctx *)ctx;
+    rt_size_t read_size = fal_be_read(&cctx->reader, buf, len);
+
+    if (read_size < len)
+    {
+        rt_memset(buf + read_size, 0x1A, len - read_size);
+        ctx->stage = RYM_STAGE_FINISHING;
+    }
+
+    return RYM_CODE_SOH;
+}
+
+static enum rym_code fal_be_rym_end(struct rym_ctx *ctx, rt_uint8_t *buf, rt_size_t len)
+{
+    rt_memset(buf, 0, len);
+
+    return RYM_CODE_SOH;
+}
+
+static int ulog_fal_sy(int argc, char **argv)
+{
+    struct fal_be_rym_ctx *ctx;
+    rt_device_t dev;
+    rt_err_t res;
+
+    dev = argc > 2 ? rt_device_find(argv[2]) : rt_console_get_device();
+    if (dev == RT_NULL)
+    {
+        rt_kprintf("could not find device.\n");
+        return -RT_ERROR;
+    }
+
+    ctx = rt_calloc(1, sizeof(*ctx));
+    if (ctx == RT_NULL)
+    {
+        rt_kprintf("rt_malloc failed\n");
+        return -RT_ENOMEM;
+    }
+
+    /* the reader takes the write position, the transfer runs without the lock */
+    res = rym_send_on_device(&ctx->parent, dev, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX,
+            fal_be_rym_begin, fal_be_rym_data, fal_be_rym_end, 1000);
+    rt_free(ctx);
+
+    return res;
+}
+#endif /* RT_USING_RYM */
+
+struct ulog_fal_cmd_des
+{
+    const char *cmd;
+    int (*fun)(int argc, char **argv);
+};
+
+static const struct ulog_fal_cmd_des cmd_tab[] =
+{
+    {"info", ulog_fal_info},
+    {"dump", ulog_fal_dump},
+    {"clean", ulog_fal_clean},
+    {"bench", ulog_fal_bench},
+#ifdef RT_USING_RYM
+    {"sy", ulog_fal_sy},
+#endif
+};
+
+static int ulog_fal(int argc, char **argv)
+{
+    int index;
+
+    if (fal_be.part == RT_NULL)
+    {
+        rt_kprintf("ulog fal backend is not initialized.\n");
+        return -RT_ERROR;
+    }
+
+    if (argc < 2)
+        return ulog_fal_info(argc, argv);
+
+    for (index = 0; index < sizeof(cmd_tab) / sizeof(cmd_tab[0]); index ++)
+    {
+        if (rt_strcmp(cmd_tab[index].cmd, argv[1]) == 0)
+            return cmd_tab[index].fun(argc, argv);
+    }
+
+    rt_kprintf("Usage:\n");
+    rt_kprintf("ulog_fal [info]         - show the partition and the write statistics\n");
+    rt_kprintf("ulog_fal dump           - print the stored logs from the oldest one\n");
+    rt_kprintf("ulog_fal clean          - erase the stored logs\n");
+    rt_kprintf("ulog_fal bench [count]  - write count lines to measure logs/s and write amplification\n");
+#ifdef RT_USING_RYM
+    rt_kprintf("ulog_fal sy [device]    - send the stored logs as ulog.log by YMODEM\n");
+#endif
+
+    return 0;
+}
+MSH_CMD_EXPORT(ulog_fal, ulog fal backend: ulog_fal [info|dump|clean|bench|sy]);
+#endif /* RT_USING_FINSH */
+
+#endif /* ULOG_BACKEND_USING_FAL */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-25     armink       the first version
+ * 2026-10-19     RT-Thread    add the binary log mode
  */
 
 #include <stdarg.h>
@@ -24,12 +25,29 @@
 #include <rtdevice.h>
 #endif
 
+#if defined(ULOG_USING_BINARY) && defined(RT_USING_CPUTIME)
+#include <drivers/cputime.h>
+#endif
+
 #ifdef RT_USING_ULOG
 
 /* the number which is max stored line logs */
 #ifndef ULOG_ASYNC_OUTPUT_STORE_LINES
+#ifdef ULOG_USING_BINARY
+/* a binary log takes about 32 bytes */
+#define ULOG_ASYNC_OUTPUT_STORE_LINES  (ULOG_ASYNC_OUTPUT_BUF_SIZE / 32)
+#else
 #define ULOG_ASYNC_OUTPUT_STORE_LINES  (ULOG_ASYNC_OUTPUT_BUF_SIZE * 3 / 2 / 80)
 #endif
+#endif
+
+#ifdef ULOG_USING_BINARY
+#ifndef ULOG_BINARY_ARG_BUF_SIZE
+#define ULOG_BINARY_ARG_BUF_SIZE       64
+#endif
+/* the version of the "ulog:bin" lines */
+#define ULOG_BINARY_VERSION            1
+#endif /* ULOG_USING_BINARY */
 
 #ifdef ULOG_USING_COLOR
 /**
@@ -95,6 +113,13 @@ struct rt_ulog
     struct rt_semaphore async_notice;
 #endif
 
+#ifdef ULOG_USING_BINARY
+    rt_bool_t binary_enabled;
+    /* the binary logs dropped by a full async buffer */
+    rt_uint32_t binary_lost;
+    rt_bool_t binary_header_sent;
+#endif
+
 #ifdef ULOG_USING_FILTER
     struct
     {
@@ -539,6 +564,223 @@ static void do_output(rt_uint32_t level, const char *tag, rt_bool_t is_raw, cons
 #endif /* ULOG_USING_ASYNC_OUTPUT */
 }
 
+#ifdef ULOG_USING_BINARY
+rt_inline rt_uint32_t ulog_binary_time(void)
+{
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+/* the counts of the binary log time per second */
+static rt_uint32_t ulog_binary_freq(void)
+{
+#ifdef RT_USING_CPUTIME
+    float res = clock_cpu_getres();
+
+    if (res > 0)
+        return (rt_uint32_t)(1000000000.0f / res);
+#endif
+    return RT_TICK_PER_SECOND;
+}
+
+/**
+ * pack the arguments of the format to words, tools/ulog_decode.py walks the
+ * format in the same way to unpack them:
+ *   %s          the string with its end sign, padded to words
+ *   %e %f %g %a a double, two words
+ *   %ll %j      a 64 bits integer, two words
+ *   others      one word, a '*' width or precision takes one word too
+ *
+ * @param buf the words buffer
+ * @param size the words of the buffer, the arguments over it are dropped
+ * @param format output format
+ * @param args variable argument list
+ *
+ * @return the packed bytes
+ */
+static rt_size_t ulog_binary_pack(rt_uint32_t *buf, rt_size_t size, const char *format, va_list args)
+{
+    rt_size_t n = 0, str_len;
+    const char *str;
+    rt_uint64_t value;
+    double dbl;
+    int long_cnt;
+
+    for (; *format; format++)
+    {
+        if (*format != '%')
+            continue;
+
+        format++;
+        /* flags, width and precision */
+        while (*format == '-' || *format == '+' || *format == ' ' || *format == '#' || *format == '.'
+                || *format == '*' || (*format >= '0' && *format <= '9'))
+        {
+            if (*format == '*')
+            {
+                if (n >= size)
+                    return n * sizeof(rt_uint32_t);
+                buf[n++] = (rt_uint32_t)va_arg(args, int);
+            }
+            format++;
+        }
+        /* length modifier */
+        long_cnt = 0;
+        while (*format == 'h' || *format == 'l' || *format == 'z' || *format == 'j' || *format == 't')
+        {
+            if (*format == 'l')
+                long_cnt++;
+            else if (*format == 'j')
+                long_cnt = 2;
+            format++;
+        }
+
+        switch (*format)
+        {
+        case '\0':
+            return n * sizeof(rt_uint32_t);
+
+        case '%':
+            break;
+
+        case 's':
+            str = va_arg(args, const char *);
+            if (str == RT_NULL)
+                str = "(null)";
+            if (n >= size)
+                return n * sizeof(rt_uint32_t);
+            str_len = rt_strlen(str);
+            /* cut the string to the room */
+            if (str_len / 4 + 1 > size - n)
+                str_len = (size - n) * 4 - 1;
+            buf[n + str_len / 4] = 0;
+            rt_memcpy(&buf[n], str, str_len);
+            n += str_len / 4 + 1;
+            break;
+
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            dbl = va_arg(args, double);
+            if (n + 2 > size)
+                return n * sizeof(rt_uint32_t);
+            rt_memcpy(&buf[n], &dbl, sizeof(dbl));
+            n += 2;
+            break;
+
+        case 'p':
+            if (n >= size)
+                return n * sizeof(rt_uint32_t);
+            buf[n++] = (rt_uint32_t)(rt_ubase_t)va_arg(args, void *);
+            break;
+
+        default:
+            if (long_cnt >= 2)
+            {
+                value = va_arg(args, long long);
+                if (n + 2 > size)
+                    return n * sizeof(rt_uint32_t);
+                buf[n++] = (rt_uint32_t)value;
+                buf[n++] = (rt_uint32_t)(value >> 32);
+            }
+            else
+            {
+                value = long_cnt ? (rt_uint32_t)va_arg(args, long) : (rt_uint32_t)va_arg(args, int);
+                if (n >= size)
+                    return n * sizeof(rt_uint32_t);
+                buf[n++] = (rt_uint32_t)value;
+            }
+            break;
+        }
+    }
+
+    return n * sizeof(rt_uint32_t);
+}
+
+/* store the log to the async buffer without formatting, it is safe in the ISR */
+static void do_binary_output(rt_uint32_t level, const char *tag, rt_bool_t newline, const char *format, va_list args)
+{
+    rt_uint32_t arg_buf[ULOG_BINARY_ARG_BUF_SIZE / sizeof(rt_uint32_t)];
+    rt_uint32_t time = ulog_binary_time();
+    rt_size_t args_len;
+    rt_rbb_blk_t log_blk;
+    ulog_bin_frame_t log_frame;
+    rt_base_t lvl;
+
+    args_len = ulog_binary_pack(arg_buf, sizeof(arg_buf) / sizeof(rt_uint32_t), format, args);
+
+    /* allocate log frame */
+    log_blk = rt_rbb_blk_alloc(ulog.async_rbb, RT_ALIGN(sizeof(struct ulog_bin_frame) + args_len, RT_ALIGN_SIZE));
+    if (log_blk)
+    {
+        /* package the log frame */
+        log_frame = (ulog_bin_frame_t) log_blk->buf;
+        log_frame->magic = ULOG_BIN_FRAME_MAGIC;
+        log_frame->level = level;
+        log_frame->newline = newline;
+        log_frame->args_len = args_len;
+        log_frame->time = time;
+        log_frame->format = format;
+        log_frame->tag = tag;
+        rt_memcpy(log_blk->buf + sizeof(struct ulog_bin_frame), arg_buf, args_len);
+        /* put the block */
+        rt_rbb_blk_put(log_blk);
+        /* send a notice */
+        rt_sem_release(&ulog.async_notice);
+    }
+    else
+    {
+        lvl = rt_hw_interrupt_disable();
+        ulog.binary_lost++;
+        rt_hw_interrupt_enable(lvl);
+    }
+}
+
+/* output the binary log as a "ulog:bin,<frame in hex>" line */
+static void ulog_binary_frame_output(ulog_bin_frame_t log_frame)
+{
+    static const char hex[] = "0123456789abcdef";
+    char line[sizeof("ulog:bin,") + 2 * (sizeof(struct ulog_bin_frame) + ULOG_BINARY_ARG_BUF_SIZE)
+              + sizeof(ULOG_NEWLINE_SIGN)];
+    const rt_uint8_t *data = (const rt_uint8_t *)log_frame;
+    rt_size_t size = sizeof(struct ulog_bin_frame) + log_frame->args_len;
+    rt_size_t len, i;
+    rt_uint32_t lost;
+    rt_base_t lvl;
+
+    /* the decoder needs the time base */
+    if (!ulog.binary_header_sent)
+    {
+        len = rt_snprintf(line, sizeof(line), "ulog:bin_header,%d,%d" ULOG_NEWLINE_SIGN, ULOG_BINARY_VERSION,
+                ulog_binary_freq());
+        ulog_output_to_all_backend(LOG_LVL_ASSERT, RT_NULL, RT_TRUE, line, len);
+        ulog.binary_header_sent = RT_TRUE;
+    }
+
+    lvl = rt_hw_interrupt_disable();
+    lost = ulog.binary_lost;
+    ulog.binary_lost = 0;
+    rt_hw_interrupt_enable(lvl);
+    if (lost)
+    {
+        len = rt_snprintf(line, sizeof(line), "ulog:bin_lost,%d" ULOG_NEWLINE_SIGN, lost);
+        ulog_output_to_all_backend(LOG_LVL_ASSERT, RT_NULL, RT_TRUE, line, len);
+    }
+
+    len = ulog_strcpy(0, line, "ulog:bin,");
+    for (i = 0; i < size; i++)
+    {
+        line[len++] = hex[data[i] >> 4];
+        line[len++] = hex[data[i] & 0x0F];
+    }
+    rt_strncpy(line + len, ULOG_NEWLINE_SIGN, sizeof(ULOG_NEWLINE_SIGN));
+    len += sizeof(ULOG_NEWLINE_SIGN) - 1;
+
+    ulog_output_to_all_backend(log_frame->level, log_frame->tag, RT_TRUE, line, len);
+}
+#endif /* ULOG_USING_BINARY */
+
 /**
  * output the log by variable argument list
  *
@@ -588,6 +830,15 @@ void ulog_voutput(rt_uint32_t level, const char *tag, rt_bool_t newline, const c
     }
 #endif /* ULOG_USING_FILTER */
 
+#ifdef ULOG_USING_BINARY
+    if (ulog.binary_enabled)
+    {
+        /* nothing is formatted, so the line buffer and the lock are not needed */
+        do_binary_output(level, tag, newline, format, args);
+        return;
+    }
+#endif /* ULOG_USING_BINARY */
+
     /* get log buffer */
     log_buf = get_log_buf();
 
@@ -1388,6 +1639,12 @@ void ulog_async_output(void)
             ulog_output_to_all_backend(log_frame->level, log_frame->tag, log_frame->is_raw, log_frame->log,
                     log_frame->log_len);
         }
+#ifdef ULOG_USING_BINARY
+        else if (log_frame->magic == ULOG_BIN_FRAME_MAGIC)
+        {
+            ulog_binary_frame_output((ulog_bin_frame_t) log_blk->buf);
+        }
+#endif /* ULOG_USING_BINARY */
         rt_rbb_blk_free(ulog.async_rbb, log_blk);
     }
     /* output the log_raw format log */
@@ -1415,6 +1672,19 @@ void ulog_async_output_enabled(rt_bool_t enabled)
     ulog.async_enabled = enabled;
 }
 
+#ifdef ULOG_USING_BINARY
+/**
+ * enable or disable binary output mode
+ * the log is formatted on the target when mode is disabled
+ *
+ * @param enabled RT_TRUE: enabled, RT_FALSE: disabled
+ */
+void ulog_binary_enabled(rt_bool_t enabled)
+{
+    ulog.binary_enabled = enabled;
+}
+#endif /* ULOG_USING_BINARY */
+
 /**
  * waiting for get asynchronous output log
  *
@@ -1436,6 +1706,92 @@ static void async_output_thread_entry(void *param)
         ulog_async_output();
     }
 }
+
+#if defined(ULOG_USING_BINARY) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+
+#ifdef RT_USING_CPUTIME
+#define ULOG_BENCH_UNIT                "cycles"
+#else
+#define ULOG_BENCH_UNIT                "ticks"
+#endif
+
+static void ulog_bin_show(void)
+{
+    rt_kprintf("ulog binary mode: %s, lost: %d\n", ulog.binary_enabled ? "on" : "off", ulog.binary_lost);
+    /* for the decoder when the console is attached late */
+    rt_kprintf("ulog:bin_header,%d,%d\n", ULOG_BINARY_VERSION, ulog_binary_freq());
+}
+
+/* log the same record count times, and take it out of the async buffer at once */
+static void ulog_bin_bench_run(const char *name, rt_bool_t binary, int count)
+{
+    rt_uint32_t t0, dt, sum = 0, worst = 0, bytes = 0, records = 0;
+    rt_rbb_blk_t log_blk;
+    int i;
+
+    ulog.binary_enabled = binary;
+    for (i = 0; i < count; i++)
+    {
+        t0 = ulog_binary_time();
+        ulog_output(LOG_LVL_INFO, "bench", RT_TRUE, "send reg %d = 0x%04x, %s", i, i * 7, "holding");
+        dt = ulog_binary_time() - t0;
+
+        sum += dt;
+        if (dt > worst)
+            worst = dt;
+        while ((log_blk = rt_rbb_blk_get(ulog.async_rbb)) != RT_NULL)
+        {
+            bytes += log_blk->size;
+            records++;
+            rt_rbb_blk_free(ulog.async_rbb, log_blk);
+        }
+    }
+
+    rt_kprintf("%-8s %12d %12d %14d\n", name, sum / count, worst, records ? bytes / records : 0);
+}
+
+static void ulog_bin_bench(int count)
+{
+    rt_bool_t binary = ulog.binary_enabled;
+
+    /* output the pending logs, then hold the async output so the records stay in the buffer */
+    ulog_async_output();
+    ulog.async_enabled = RT_FALSE;
+
+    rt_kprintf("%d logs of \"send reg %%d = 0x%%04x, %%s\", run it when the system is quiet\n", count);
+    rt_kprintf("%-8s %12s %12s %14s\n", "path", "avg(" ULOG_BENCH_UNIT ")", "max(" ULOG_BENCH_UNIT ")",
+            "bytes/record");
+    ulog_bin_bench_run("text", RT_FALSE, count);
+    ulog_bin_bench_run("binary", RT_TRUE, count);
+
+    ulog.binary_enabled = binary;
+    ulog.async_enabled = RT_TRUE;
+}
+
+static void ulog_bin(uint8_t argc, char **argv)
+{
+    if (argc < 2)
+    {
+        ulog_bin_show();
+    }
+    else if (!rt_strcmp(argv[1], "on") || !rt_strcmp(argv[1], "off"))
+    {
+        ulog_binary_enabled(!rt_strcmp(argv[1], "on"));
+        ulog_bin_show();
+    }
+    else if (!rt_strcmp(argv[1], "bench"))
+    {
+        ulog_bin_bench(argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 100);
+    }
+    else
+    {
+        rt_kprintf("Please input: ulog_bin [on|off|bench [count]].\n");
+    }
+}
+MSH_CMD_EXPORT(ulog_bin, Set ulog binary mode or compare it with the text mode: ulog_bin [on|off|bench [count]]);
+#endif /* defined(ULOG_USING_BINARY) && defined(RT_USING_FINSH) */
 #endif /* ULOG_USING_ASYNC_OUTPUT */
 
 /**
@@ -1491,6 +1847,10 @@ int ulog_init(void)
     rt_sem_init(&ulog.async_notice, "ulog", 0, RT_IPC_FLAG_FIFO);
 #endif /* ULOG_USING_ASYNC_OUTPUT */
 
+#ifdef ULOG_USING_BINARY
+    ulog.binary_enabled = RT_TRUE;
+#endif
+
 #ifdef ULOG_USING_FILTER
     ulog_global_filter_lvl_set(LOG_FILTER_LVL_ALL);
 #endif
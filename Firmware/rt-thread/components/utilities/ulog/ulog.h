@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-25     armink       the first version
+ * 2026-10-19     RT-Thread    add the binary output API
  */
 
 #ifndef _ULOG_H_
@@ -84,6 +85,13 @@ void ulog_async_output_enabled(rt_bool_t enabled);
 void ulog_async_waiting_log(rt_int32_t time);
 #endif
 
+#ifdef ULOG_USING_BINARY
+/*
+ * binary output API, the log is formatted by tools/ulog_decode.py
+ */
+void ulog_binary_enabled(rt_bool_t enabled);
+#endif
+
 /*
  * dump the hex format data to log
  */
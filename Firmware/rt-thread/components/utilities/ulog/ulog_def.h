@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-25     armink       the first version
+ * 2026-10-19     RT-Thread    add the binary log frame
  */
 
 #ifndef _ULOG_DEF_H_
@@ -177,6 +178,7 @@ extern "C" {
 #endif
 
 #define ULOG_FRAME_MAGIC               0x10
+#define ULOG_BIN_FRAME_MAGIC           0x11
 
 /* tag's level filter */
 struct ulog_tag_lvl_filter
@@ -199,6 +201,21 @@ struct ulog_frame
 };
 typedef struct ulog_frame *ulog_frame_t;
 
+/* binary log frame, the argument words follow it. The layout is decoded by tools/ulog_decode.py */
+struct ulog_bin_frame
+{
+    /* magic word is 0x11 */
+    rt_uint32_t magic:8;
+    rt_uint32_t level:8;
+    rt_uint32_t newline:1;
+    rt_uint32_t args_len:15;
+    rt_uint32_t time;
+    /* the format and the tag are resolved from the ELF file by their address */
+    const char *format;
+    const char *tag;
+};
+typedef struct ulog_bin_frame *ulog_bin_frame_t;
+
 struct ulog_backend
 {
     char name[RT_NAME_MAX];
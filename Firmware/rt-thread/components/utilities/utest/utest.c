@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-19     MurphyZhao   the first version
+ * 2026-10-19     RT-Thread    add the benchmark mode
  */
 
 #include <rtthread.h>
@@ -319,6 +320,14 @@ static void utest_testcase_run(int argc, char** argv)
 }
 MSH_CMD_EXPORT_ALIAS(utest_testcase_run, utest_run, utest_run [-thread or -help] [testcase name] [loop num]);
 
+#ifdef UTEST_USING_BENCH
+void utest_bench_testcase_run(const char *utest_name)
+{
+    tc_loop = 1;
+    utest_run(utest_name);
+}
+#endif /* UTEST_USING_BENCH */
+
 utest_t utest_handle_get(void)
 {
     return (utest_t)&local_utest;
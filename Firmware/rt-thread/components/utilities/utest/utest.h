@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-19     MurphyZhao   the first version
+ * 2026-10-19     RT-Thread    add the benchmark mode
  */
 
 #ifndef __UTEST_H__
@@ -15,6 +16,9 @@
 #include <stdint.h>
 #include "utest_log.h"
 #include "utest_assert.h"
+#ifdef UTEST_USING_BENCH
+#include "utest_bench.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
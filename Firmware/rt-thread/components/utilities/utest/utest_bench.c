@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#include <rtthread.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utest.h"
+
+#ifdef UTEST_USING_BENCH
+#include <drivers/cputime.h>
+
+#ifdef UTEST_BENCH_BASELINE
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#undef DBG_TAG
+#undef DBG_LVL
+
+#define DBG_TAG          "utest"
+#define DBG_LVL          DBG_INFO
+#include <rtdbg.h>
+
+#ifndef UTEST_BENCH_ITERS
+#define UTEST_BENCH_ITERS       100
+#endif
+
+#ifndef UTEST_BENCH_WARMUP
+#define UTEST_BENCH_WARMUP      10
+#endif
+
+#ifndef UTEST_BENCH_THRESHOLD
+#define UTEST_BENCH_THRESHOLD   10
+#endif
+
+/* the calls timed back to back to find the cost of reading the cpu time */
+#define BENCH_OVERHEAD_ROUNDS   16
+
+static const char bench_csv_header[] = "bench,name,iters,min_ns,median_ns,p99_ns,ops_per_s,bytes_per_s\n";
+
+static rt_uint32_t bench_iters = UTEST_BENCH_ITERS;
+static rt_uint32_t bench_warmup = UTEST_BENCH_WARMUP;
+static rt_uint32_t bench_threshold = UTEST_BENCH_THRESHOLD;
+static rt_bool_t bench_csv;
+static rt_uint32_t bench_regressed;
+static struct utest_bench_result bench_result;
+#ifdef UTEST_BENCH_BASELINE
+static char *bench_baseline;    /* the baseline file read in, RT_NULL if not checking */
+static int bench_save_fd = -1;
+#endif
+
+static int bench_cmp(const void *a, const void *b)
+{
+    rt_uint32_t x = *(const rt_uint32_t *)a;
+    rt_uint32_t y = *(const rt_uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+static rt_uint32_t bench_ns(rt_uint32_t cycles, float res)
+{
+    float ns = cycles * res;
+
+    return ns > 4294967295.0f ? 0xffffffff : (rt_uint32_t)ns;
+}
+
+#ifdef UTEST_BENCH_BASELINE
+static char *bench_baseline_load(const char *path)
+{
+    struct stat st;
+    char *buf;
+    int fd, len;
+
+    if (stat(path, &st) < 0 || st.st_size <= 0)
+        return RT_NULL;
+
+    buf = (char *)rt_malloc(st.st_size + 1);
+    if (buf == RT_NULL)
+        return RT_NULL;
+
+    fd = open(path, O_RDONLY, 0);
+    len = fd < 0 ? -1 : read(fd, buf, st.st_size);
+    if (fd >= 0)
+        close(fd);
+    if (len <= 0)
+    {
+        rt_free(buf);
+        return RT_NULL;
+    }
+    buf[len] = '\0';
+
+    return buf;
+}
+
+/* the median of the line "bench,<name>,iters,min_ns,median_ns,..." */
+static rt_uint32_t bench_baseline_median(const char *name)
+{
+    const char *line = bench_baseline;
+    rt_size_t len = rt_strlen(name);
+    int field;
+
+    while (line != RT_NULL && *line != '\0')
+    {
+        if (rt_strncmp(line, "bench,", 6) == 0 &&
+            rt_strncmp(line + 6, name, len) == 0 && line[6 + len] == ',')
+        {
+            line += 6 + len + 1;
+            for (field = 0; field < 2 && line != RT_NULL; field ++)
+            {
+                line = strchr(line, ',');
+                if (line != RT_NULL)
+                    line ++;
+            }
+            return line != RT_NULL ? strtoul(line, RT_NULL, 10) : 0;
+        }
+
+        line = strchr(line, '\n');
+        if (line != RT_NULL)
+            line ++;
+    }
+
+    return 0;
+}
+#endif /* UTEST_BENCH_BASELINE */
+
+rt_err_t utest_bench_run(const char *name, utest_bench_func func, void *param, rt_size_t bytes)
+{
+    struct utest_bench_result *result = &bench_result;
+    rt_uint32_t *samples, index, overhead;
+    rt_uint64_t begin, used;
+    float res;
+
+    RT_ASSERT(name != RT_NULL);
+    RT_ASSERT(func != RT_NULL);
+
+    res = clock_cpu_getres();
+    if (res <= 0)
+    {
+        LOG_E("[  BENCH   ] (%s) no cpu time, the BSP has no rt_clock_cputime_ops", name);
+        return -RT_ENOSYS;
+    }
+
+    samples = (rt_uint32_t *)rt_malloc(bench_iters * sizeof(rt_uint32_t));
+    if (samples == RT_NULL)
+    {
+        LOG_E("[  BENCH   ] (%s) no memory for %d samples", name, bench_iters);
+        return -RT_ENOMEM;
+    }
+
+    for (index = 0; index < bench_warmup; index ++)
+    {
+        func(param);
+    }
+
+    overhead = 0xffffffff;
+    for (index = 0; index < BENCH_OVERHEAD_ROUNDS; index ++)
+    {
+        begin = clock_cpu_gettime();
+        used = clock_cpu_gettime() - begin;
+        if (used < overhead)
+            overhead = (rt_uint32_t)used;
+    }
+
+    for (index = 0; index < bench_iters; index ++)
+    {
+        begin = clock_cpu_gettime();
+        func(param);
+        used = clock_cpu_gettime() - begin;
+
+        used = used > overhead ? used - overhead : 0;
+        samples[index] = used > 0xffffffff ? 0xffffffff : (rt_uint32_t)used;
+    }
+    qsort(samples, bench_iters, sizeof(rt_uint32_t), bench_cmp);
+
+    result->name = name;
+    result->iters = bench_iters;
+    result->min_ns = bench_ns(samples[0], res);
+    result->median_ns = bench_ns(samples[bench_iters / 2], res);
+    result->p99_ns = bench_ns(samples[(bench_iters * 99 + 99) / 100 - 1], res);
+    result->ops = 1000000000UL / (result->median_ns ? result->median_ns : 1);
+    used = (rt_uint64_t)bytes * result->ops;
+    result->bytes = used > 0xffffffff ? 0xffffffff : (rt_uint32_t)used;
+    rt_free(samples);
+
+    if (bench_csv)
+    {
+        rt_kprintf("bench,%s,%u,%u,%u,%u,%u,%u\n", name, result->iters, result->min_ns,
+                   result->median_ns, result->p99_ns, result->ops, result->bytes);
+    }
+    else
+    {
+        LOG_I("[  BENCH   ] (%s) min %u ns, median %u ns, p99 %u ns, %u ops/s, %u B/s", name,
+              result->min_ns, result->median_ns, result->p99_ns, result->ops, result->bytes);
+    }
+
+#ifdef UTEST_BENCH_BASELINE
+    if (bench_save_fd >= 0)
+    {
+        char line[UTEST_NAME_MAX_LEN + 80];
+        int len;
+
+        len = rt_snprintf(line, sizeof(line), "bench,%s,%u,%u,%u,%u,%u,%u\n", name, result->iters,
+                          result->min_ns, result->median_ns, result->p99_ns, result->ops, result->bytes);
+        write(bench_save_fd, line, len);
+    }
+
+    if (bench_baseline != RT_NULL)
+    {
+        rt_uint32_t base = bench_baseline_median(name);
+
+        if (base != 0 && result->median_ns > (rt_uint64_t)base * (100 + bench_threshold) / 100)
+        {
+            LOG_E("[ REGRESS  ] (%s) median %u ns, baseline %u ns", name, result->median_ns, base);
+            bench_regressed ++;
+            utest_assert(0, __FILE__, __LINE__, name, "benchmark regression");
+            return -RT_ERROR;
+        }
+    }
+#endif /* UTEST_BENCH_BASELINE */
+
+    return RT_EOK;
+}
+
+const struct utest_bench_result *utest_bench_result_get(void)
+{
+    return &bench_result;
+}
+
+static void utest_bench_usage(void)
+{
+    rt_kprintf("Usage: utest_bench [-csv] [-save] [-n iters] [-w warmup] [-t threshold] [testcase name]\n");
+    rt_kprintf("       -csv   print the results as 'bench,name,iters,min_ns,median_ns,p99_ns,ops_per_s,bytes_per_s'\n");
+#ifdef UTEST_BENCH_BASELINE
+    rt_kprintf("       -save  store the results to %s as the baseline,\n", UTEST_BENCH_BASELINE);
+    rt_kprintf("              without it a median slower than the baseline fails the testcase\n");
+#endif
+    rt_kprintf("       -t     the allowed regression in percent, default %d\n", UTEST_BENCH_THRESHOLD);
+}
+
+static int utest_bench(int argc, char **argv)
+{
+    const char *name = RT_NULL;
+    rt_bool_t save = RT_FALSE;
+    int index;
+
+    bench_iters = UTEST_BENCH_ITERS;
+    bench_warmup = UTEST_BENCH_WARMUP;
+    bench_threshold = UTEST_BENCH_THRESHOLD;
+    bench_csv = RT_FALSE;
+
+    for (index = 1; index < argc; index ++)
+    {
+        if (rt_strcmp(argv[index], "-csv") == 0)
+            bench_csv = RT_TRUE;
+        else if (rt_strcmp(argv[index], "-save") == 0)
+            save = RT_TRUE;
+        else if (rt_strcmp(argv[index], "-n") == 0 && index + 1 < argc)
+            bench_iters = atoi(argv[++ index]);
+        else if (rt_strcmp(argv[index], "-w") == 0 && index + 1 < argc)
+            bench_warmup = atoi(argv[++ index]);
+        else if (rt_strcmp(argv[index], "-t") == 0 && index + 1 < argc)
+            bench_threshold = atoi(argv[++ index]);
+        else if (argv[index][0] != '-' && name == RT_NULL)
+            name = argv[index];
+        else
+            break;
+    }
+    if (index < argc || bench_iters == 0)
+    {
+        utest_bench_usage();
+        return -RT_EINVAL;
+    }
+
+#ifdef UTEST_BENCH_BASELINE
+    if (save)
+    {
+        bench_save_fd = open(UTEST_BENCH_BASELINE, O_WRONLY | O_CREAT | O_TRUNC, 0);
+        if (bench_save_fd < 0)
+            LOG_E("[  BENCH   ] open %s failed, the baseline is not saved", UTEST_BENCH_BASELINE);
+        else
+            write(bench_save_fd, bench_csv_header, sizeof(bench_csv_header) - 1);
+    }
+    else
+    {
+        bench_baseline = bench_baseline_load(UTEST_BENCH_BASELINE);
+        if (bench_baseline == RT_NULL)
+            LOG_I("[  BENCH   ] no baseline in %s, the results are not checked", UTEST_BENCH_BASELINE);
+    }
+#else
+    (void)save;
+#endif /* UTEST_BENCH_BASELINE */
+
+    if (bench_csv)
+        rt_kprintf("%s", bench_csv_header);
+
+    bench_regressed = 0;
+    utest_bench_testcase_run(name);
+
+#ifdef UTEST_BENCH_BASELINE
+    if (bench_save_fd >= 0)
+    {
+        close(bench_save_fd);
+        bench_save_fd = -1;
+    }
+    if (bench_baseline != RT_NULL)
+    {
+        rt_free(bench_baseline);
+        bench_baseline = RT_NULL;
+    }
+#endif /* UTEST_BENCH_BASELINE */
+
+    /* utest_run uses the defaults */
+    bench_iters = UTEST_BENCH_ITERS;
+    bench_warmup = UTEST_BENCH_WARMUP;
+    bench_csv = RT_FALSE;
+
+    if (bench_regressed > 0)
+    {
+        LOG_E("[  FAILED  ] [ result   ] %d benchmarks regressed more than %d%%", bench_regressed, bench_threshold);
+        return -RT_ERROR;
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(utest_bench, utest_bench [-csv] [-save] [-n iters] [-w warmup] [-t threshold] [testcase name]);
+#endif /* UTEST_USING_BENCH */
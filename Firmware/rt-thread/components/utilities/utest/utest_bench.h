@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef __UTEST_BENCH_H__
+#define __UTEST_BENCH_H__
+
+#include <rtthread.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * utest_bench_result
+ *
+ * @brief Benchmark result, the times are of one call.
+ *
+ * @member name      Benchmark name.
+ * @member iters     Number of timed calls.
+ * @member min_ns    Shortest call in nanoseconds.
+ * @member median_ns Median call in nanoseconds.
+ * @member p99_ns    99th percentile call in nanoseconds.
+ * @member ops       Calls per second at the median.
+ * @member bytes     Bytes per second at the median, 0 if the call handles no data.
+ *
+*/
+struct utest_bench_result
+{
+    const char *name;
+    uint32_t iters;
+    uint32_t min_ns;
+    uint32_t median_ns;
+    uint32_t p99_ns;
+    uint32_t ops;
+    uint32_t bytes;
+};
+
+/**
+ * utest_bench_func
+ *
+ * @brief Benchmark function pointer, called once an iteration.
+ *
+*/
+typedef void (*utest_bench_func)(void *param);
+
+/**
+ * utest_bench_run
+ *
+ * @brief Benchmark executor.
+ *        No need for the user to call this function directly
+ *
+ * @param name  Benchmark name, the key of the baseline.
+ * @param func  Benchmark function.
+ * @param param The parameter of the function.
+ * @param bytes Bytes handled a call, 0 for none.
+ *
+ * @return RT_EOK, -RT_ERROR on a regression against the baseline.
+ *
+*/
+rt_err_t utest_bench_run(const char *name, utest_bench_func func, void *param, rt_size_t bytes);
+
+/**
+ * utest_bench_testcase_run
+ *
+ * @brief Run the testcases once, used by the `utest_bench` command.
+ *        No need for the user to call this function directly
+ *
+ * @param utest_name Testcase name, '*' wildcard supported, RT_NULL for all.
+ *
+ * @return void
+ *
+*/
+void utest_bench_testcase_run(const char *utest_name);
+
+/**
+ * utest_bench_result_get
+ *
+ * @brief Get the result of the last benchmark.
+ *
+ * @param void
+ *
+ * @return struct utest_bench_result *
+ *
+*/
+const struct utest_bench_result *utest_bench_result_get(void);
+
+/**
+ * UTEST_BENCH
+ *
+ * @brief Benchmark a function in a testcase. The function runs the
+ *        warm-up calls, then the timed calls set by `utest_bench`.
+ *        A median slower than the stored baseline by more than the
+ *        threshold fails the testcase.
+ *        Used in `testcase` function in application, e.g.
+ *
+ *            static void bench_parse(void *param) { at_parse(param); }
+ *
+ *            static void testcase(void)
+ *            {
+ *                UTEST_BENCH(bench_parse, line, sizeof(line));
+ *            }
+ *
+ * @param func  Benchmark function, void func(void *param).
+ * @param param The parameter of the function.
+ * @param bytes Bytes handled a call, 0 for none.
+ *
+ * @return None
+ *
+*/
+#define UTEST_BENCH(func, param, bytes)                                        \
+    utest_bench_run(#func, func, param, bytes)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTEST_BENCH_H__ */
@@ -41,6 +41,8 @@
  * 2022-01-01     Gabriel      improve hooking method
  * 2022-01-07     Gabriel      move some __on_rt_xxxxx_hook to dedicated c source files
  * 2022-01-12     Meco Man     remove RT_THREAD_BLOCK
+ * 2026-10-19     RT-Thread    add the name hash link of kernel objects
+ * 2026-10-19     RT-Thread    keep the init function names for the init profile
  */
 
 #ifndef __RT_DEF_H__
@@ -232,7 +234,12 @@ typedef int (*init_fn_t)(void);
                                 {__rti_level_##fn, fn };
     #endif
 #else
-    #if RT_DEBUG_INIT
+    /* the names are kept for the debug log, the profile and the deferral */
+    #if RT_DEBUG_INIT || defined(RT_USING_INIT_PROFILE) || defined(RT_USING_INIT_DEFER)
+        #define RT_INIT_USING_NAME
+    #endif
+
+    #ifdef RT_INIT_USING_NAME
         struct rt_init_desc
         {
             const char* fn_name;
@@ -388,6 +395,9 @@ struct rt_object
     void      *module_id;                               /**< id of application module */
 #endif
     rt_list_t  list;                                    /**< list node of kernel object */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object of the same name hash */
+#endif
 };
 typedef struct rt_object *rt_object_t;                  /**< Type for kernel objects. */
 
@@ -621,6 +631,9 @@ struct rt_thread
 #endif
 
     rt_list_t   list;                                   /**< the object list */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object of the same name hash */
+#endif
     rt_list_t   tlist;                                  /**< the thread list */
 
     /* stack point and entry */
@@ -853,6 +866,10 @@ typedef rt_mem_t rt_smem_t;
 typedef rt_mem_t rt_slab_t;
 #endif
 
+#ifdef RT_USING_TLSF
+typedef rt_mem_t rt_tlsf_t;
+#endif
+
 #ifdef RT_USING_MEMHEAP
 /**
  * memory item on the heap
@@ -272,6 +272,8 @@ void rt_free_align(void *ptr);
 void rt_memory_info(rt_size_t *total,
                     rt_size_t *used,
                     rt_size_t *max_used);
+void rt_memory_frag_info(rt_size_t *free_blocks,
+                         rt_size_t *max_free);
 
 #if defined(RT_USING_SLAB) && defined(RT_USING_SLAB_AS_HEAP)
 void *rt_page_alloc(rt_size_t npages);
@@ -296,6 +298,7 @@ rt_err_t rt_smem_detach(rt_smem_t m);
 void *rt_smem_alloc(rt_smem_t m, rt_size_t size);
 void *rt_smem_realloc(rt_smem_t m, void *rmem, rt_size_t newsize);
 void rt_smem_free(void *rmem);
+void rt_smem_frag_info(rt_smem_t m, rt_size_t *free_blocks, rt_size_t *max_free);
 #endif
 
 #ifdef RT_USING_MEMHEAP
@@ -329,6 +332,18 @@ void *rt_slab_realloc(rt_slab_t m, void *ptr, rt_size_t size);
 void rt_slab_free(rt_slab_t m, void *ptr);
 #endif
 
+#ifdef RT_USING_TLSF
+/**
+ * tlsf memory object interface
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size);
+rt_err_t rt_tlsf_detach(rt_tlsf_t m);
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size);
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize);
+void rt_tlsf_free(rt_tlsf_t m, void *rmem);
+void rt_tlsf_frag_info(rt_tlsf_t m, rt_size_t *free_blocks, rt_size_t *max_free);
+#endif
+
 /**@}*/
 
 /**
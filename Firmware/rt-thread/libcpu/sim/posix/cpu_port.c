@@ -12,6 +12,7 @@
 #include <semaphore.h>
 #include <time.h>
 #include <sys/time.h>
+#include "cpu_port.h"
 
 //#define TRACE       printf
 #define TRACE(...)
@@ -65,6 +66,9 @@ static void start_sys_timer(void);
 static int tick_interrupt_isr(void);
 static void mthread_signal_tick(int sig);
 static int mainthread_scheduler(void);
+#ifdef RT_SIM_USING_VTIME
+static int vtime_step_isr(void);
+#endif
 
 int signal_install(int sig, void (*func)(int))
 {
@@ -478,7 +482,11 @@ static int mainthread_scheduler(void)
         // if (systick_signal_flag != 0)
         if (pthread_mutex_trylock(ptr_int_mutex) == 0)
         {
+#ifdef RT_SIM_USING_VTIME
+            vtime_step_isr();
+#else
             tick_interrupt_isr();
+#endif
             // systick_signal_flag = 0;
             pthread_mutex_unlock(ptr_int_mutex);
         }
@@ -505,7 +513,12 @@ static void start_sys_timer(void)
 
     RT_ASSERT(RT_TICK_PER_SECOND <= 1000000 || RT_TICK_PER_SECOND >= 1);
 
+#ifdef RT_SIM_USING_VTIME
+    /* the timer paces the time steps, not the tick */
+    us = RT_SIM_VTIME_PERIOD_US;
+#else
     us = 1000000 / RT_TICK_PER_SECOND - 1;
+#endif
 
     TRACE("start system tick!\n");
     /* Initialise the structure with the current timer information. */
@@ -564,3 +577,67 @@ static int tick_interrupt_isr(void)
     return 0;
 }
 
+#ifdef RT_SIM_USING_VTIME
+static rt_uint32_t vtime_busy_steps;
+
+/*
+ * A time step of the virtual time. When the idle thread runs, all threads
+ * are blocked and nothing happens before the next timer timeout, so the
+ * tick jumps there at once. The timers fire in the order of their timeouts
+ * whatever the speed of the host.
+ */
+static int vtime_step_isr(void)
+{
+    rt_tick_t tick, next;
+
+    if (rt_thread_self() != rt_thread_idle_gethandler() || cpu_pending_interrupts)
+    {
+        /* a thread is running, let the ones polling the tick go on */
+        if (++ vtime_busy_steps < RT_SIM_VTIME_BUSY_STEPS)
+            return 0;
+
+        vtime_busy_steps = 0;
+        return tick_interrupt_isr();
+    }
+    vtime_busy_steps = 0;
+
+    next = rt_timer_next_timeout_tick();
+    if (next == RT_TICK_MAX)
+    {
+        /* no timer, only an input of the host wakes the system */
+        return 0;
+    }
+
+    tick = rt_tick_get();
+    if (next - tick > 1 && next - tick < RT_TICK_MAX / 2)
+    {
+        rt_tick_set(next - 1);
+    }
+
+    return tick_interrupt_isr();
+}
+#endif /* RT_SIM_USING_VTIME */
+
+/*
+ * The latency of a simulated device, the caller sleeps for it. The part
+ * below a tick is carried to the next call, so many short transfers add
+ * up to the right time. On virtual time the sleep takes no real time.
+ */
+void rt_hw_sim_latency(rt_uint32_t us)
+{
+    static rt_uint32_t carry_us;
+    rt_base_t level;
+    rt_tick_t tick;
+
+    level = rt_hw_interrupt_disable();
+    carry_us += us;
+    tick = carry_us / (1000000 / RT_TICK_PER_SECOND);
+    carry_us %= 1000000 / RT_TICK_PER_SECOND;
+    rt_hw_interrupt_enable(level);
+
+    /* in an interrupt or before the scheduler the time is only accounted */
+    if (tick > 0 && rt_interrupt_get_nest() == 0 && rt_thread_self() != RT_NULL)
+    {
+        rt_thread_delay(tick);
+    }
+}
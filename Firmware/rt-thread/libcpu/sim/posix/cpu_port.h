@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+#ifndef __CPU_PORT_H__
+#define __CPU_PORT_H__
+
+#include <rtthread.h>
+
+/*
+ * The latency models of the simulated devices, in microseconds. A driver
+ * passes them to rt_hw_sim_latency() before it completes a transfer, e.g.
+ *
+ *     rt_hw_sim_latency(RT_SIM_SERIAL_LATENCY_US(115200, size));
+ *
+ * The flash figures are of a SPI NOR flash, a board may define its own.
+ */
+#define RT_SIM_SERIAL_LATENCY_US(baud, bytes)   ((rt_uint32_t)((rt_uint64_t)(bytes) * 10 * 1000000 / (baud)))
+
+#ifndef RT_SIM_FLASH_READ_LATENCY_US
+#define RT_SIM_FLASH_READ_LATENCY_US(bytes)     (10 + (rt_uint32_t)(bytes) / 5)
+#endif
+#ifndef RT_SIM_FLASH_WRITE_LATENCY_US
+#define RT_SIM_FLASH_WRITE_LATENCY_US(bytes)    (700 * (((rt_uint32_t)(bytes) + 255) / 256))
+#endif
+#ifndef RT_SIM_FLASH_ERASE_LATENCY_US
+#define RT_SIM_FLASH_ERASE_LATENCY_US(bytes)    (45000 * (((rt_uint32_t)(bytes) + 4095) / 4096))
+#endif
+
+void rt_hw_sim_latency(rt_uint32_t us);
+
+#endif /* __CPU_PORT_H__ */
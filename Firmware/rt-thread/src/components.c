@@ -15,6 +15,7 @@
  *                             in some IDEs.
  * 2015-07-29     Arda.Fu      Add support to use RT_USING_USER_MAIN with IAR
  * 2018-11-22     Jesven       Add secondary cpu boot up
+ * 2026-10-19     RT-Thread    Add the init profile and the deferred initialization
  */
 
 #include <rthw.h>
@@ -77,6 +78,150 @@ static int rti_end(void)
 }
 INIT_EXPORT(rti_end, "6.end");
 
+#ifdef RT_USING_INIT_PROFILE
+#ifndef RT_INIT_PROFILE_MAX
+#define RT_INIT_PROFILE_MAX     64
+#endif
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#if defined(RT_USING_CPUTIME_CORTEXM)
+/*
+ * The DWT cycle counter of the cortex-m cputime, read directly as the board
+ * level may run before cortexm_cputime_init() sets the cputime ops.
+ */
+#define RTI_DEMCR               (*(volatile rt_uint32_t *)0xE000EDFC)
+#define RTI_DWT_CTRL            (*(volatile rt_uint32_t *)0xE0001000)
+#define RTI_DWT_CYCCNT          (*(volatile rt_uint32_t *)0xE0001004)
+
+#define rti_clock_start()       do { RTI_DEMCR |= 1UL << 24; RTI_DWT_CTRL |= 1UL; } while (0)
+#define rti_clock()             RTI_DWT_CYCCNT
+#elif defined(RT_USING_CPUTIME)
+#define rti_clock_start()
+#define rti_clock()             ((rt_uint32_t)clock_cpu_gettime())
+#else
+#define rti_clock_start()
+#define rti_clock()             ((rt_uint32_t)rt_tick_get())
+#endif /* RT_USING_CPUTIME_CORTEXM */
+#endif /* RT_USING_INIT_PROFILE */
+
+#ifdef RT_INIT_USING_NAME
+enum rti_phase
+{
+    RTI_PHASE_BOARD = 0,                /* rt_components_board_init() */
+    RTI_PHASE_COMPONENTS,               /* rt_components_init() */
+    RTI_PHASE_DEFER,                    /* the deferred initialization thread */
+    RTI_PHASE_MARK,                     /* a point of the boot, no function */
+};
+
+#ifdef RT_USING_INIT_PROFILE
+struct rti_record
+{
+    const char *name;
+    rt_uint32_t start;                  /* clock counts since the board level began */
+    rt_uint32_t used;                   /* clock counts of the function */
+    rt_int16_t result;
+    rt_uint8_t phase;
+};
+
+static struct rti_record rti_records[RT_INIT_PROFILE_MAX];
+static rt_uint16_t rti_record_count;
+static rt_uint16_t rti_record_lost;
+static rt_uint32_t rti_origin;
+
+static void rti_profile_add(const char *name, rt_uint8_t phase, rt_uint32_t begin, rt_uint32_t end, int result)
+{
+    struct rti_record *record;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (rti_record_count < RT_INIT_PROFILE_MAX)
+    {
+        record = &rti_records[rti_record_count ++];
+        record->name = name;
+        record->start = begin - rti_origin;
+        record->used = end - begin;
+        record->result = (rt_int16_t)result;
+        record->phase = phase;
+    }
+    else
+    {
+        rti_record_lost ++;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static void rti_profile_mark(const char *name)
+{
+    rt_uint32_t now = rti_clock();
+
+    rti_profile_add(name, RTI_PHASE_MARK, now, now, 0);
+}
+#endif /* RT_USING_INIT_PROFILE */
+
+#ifdef RT_USING_INIT_DEFER
+#ifndef RT_INIT_DEFER_LIST
+#define RT_INIT_DEFER_LIST      ""
+#endif
+
+/* whether the name is one of the comma separated RT_INIT_DEFER_LIST */
+static rt_bool_t rti_deferred(const char *name)
+{
+    const char *list = RT_INIT_DEFER_LIST;
+    rt_size_t len = rt_strlen(name);
+
+    while (*list != '\0')
+    {
+        while (*list == ',' || *list == ' ')
+            list ++;
+        if (rt_strncmp(list, name, len) == 0 &&
+            (list[len] == '\0' || list[len] == ',' || list[len] == ' '))
+            return RT_TRUE;
+        while (*list != '\0' && *list != ',' && *list != ' ')
+            list ++;
+    }
+
+    return RT_FALSE;
+}
+#endif /* RT_USING_INIT_DEFER */
+
+static void rti_call(const struct rt_init_desc *desc, rt_uint8_t phase)
+{
+    int result;
+#ifdef RT_USING_INIT_PROFILE
+    rt_uint32_t begin;
+#endif
+
+#ifdef RT_USING_INIT_DEFER
+    if (phase == RTI_PHASE_COMPONENTS && rti_deferred(desc->fn_name))
+    {
+#if RT_DEBUG_INIT
+        rt_kprintf("initialize %s: deferred\n", desc->fn_name);
+#endif
+        return;
+    }
+#endif /* RT_USING_INIT_DEFER */
+
+#if RT_DEBUG_INIT
+    rt_kprintf("initialize %s", desc->fn_name);
+#endif
+#ifdef RT_USING_INIT_PROFILE
+    begin = rti_clock();
+#endif
+    result = desc->fn();
+#ifdef RT_USING_INIT_PROFILE
+    if (desc->fn != rti_board_start && desc->fn != rti_board_end)
+        rti_profile_add(desc->fn_name, phase, begin, rti_clock(), result);
+#endif
+#if RT_DEBUG_INIT
+    rt_kprintf(":%d done\n", result);
+#endif
+    (void)result;
+}
+#endif /* RT_INIT_USING_NAME */
+
 /**
  * @brief  Onboard components initialization. In this function, the board-level
  *         initialization function will be called to complete the initialization
@@ -84,14 +229,16 @@ INIT_EXPORT(rti_end, "6.end");
  */
 void rt_components_board_init(void)
 {
-#if RT_DEBUG_INIT
-    int result;
+#ifdef RT_INIT_USING_NAME
     const struct rt_init_desc *desc;
+
+#ifdef RT_USING_INIT_PROFILE
+    rti_clock_start();
+    rti_origin = rti_clock();
+#endif
     for (desc = &__rt_init_desc_rti_board_start; desc < &__rt_init_desc_rti_board_end; desc ++)
     {
-        rt_kprintf("initialize %s", desc->fn_name);
-        result = desc->fn();
-        rt_kprintf(":%d done\n", result);
+        rti_call(desc, RTI_PHASE_BOARD);
     }
 #else
     volatile const init_fn_t *fn_ptr;
@@ -100,7 +247,7 @@ void rt_components_board_init(void)
     {
         (*fn_ptr)();
     }
-#endif /* RT_DEBUG_INIT */
+#endif /* RT_INIT_USING_NAME */
 }
 
 /**
@@ -108,16 +255,15 @@ void rt_components_board_init(void)
  */
 void rt_components_init(void)
 {
-#if RT_DEBUG_INIT
-    int result;
+#ifdef RT_INIT_USING_NAME
     const struct rt_init_desc *desc;
 
+#if RT_DEBUG_INIT
     rt_kprintf("do components initialization.\n");
+#endif
     for (desc = &__rt_init_desc_rti_board_end; desc < &__rt_init_desc_rti_end; desc ++)
     {
-        rt_kprintf("initialize %s", desc->fn_name);
-        result = desc->fn();
-        rt_kprintf(":%d done\n", result);
+        rti_call(desc, RTI_PHASE_COMPONENTS);
     }
 #else
     volatile const init_fn_t *fn_ptr;
@@ -126,8 +272,165 @@ void rt_components_init(void)
     {
         (*fn_ptr)();
     }
-#endif /* RT_DEBUG_INIT */
+#endif /* RT_INIT_USING_NAME */
 }
+
+#ifdef RT_USING_INIT_DEFER
+#ifndef RT_INIT_DEFER_PRIORITY
+#define RT_INIT_DEFER_PRIORITY      (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+/* the Kconfig range can not follow RT_THREAD_PRIORITY_MAX, the lowest priority is MAX - 1 */
+#if RT_INIT_DEFER_PRIORITY > RT_THREAD_PRIORITY_MAX - 1
+#undef RT_INIT_DEFER_PRIORITY
+#define RT_INIT_DEFER_PRIORITY      (RT_THREAD_PRIORITY_MAX - 1)
+#endif
+#ifndef RT_INIT_DEFER_STACK_SIZE
+#define RT_INIT_DEFER_STACK_SIZE    1024
+#endif
+
+#ifndef RT_USING_HEAP
+ALIGN(8)
+static rt_uint8_t rti_defer_stack[RT_INIT_DEFER_STACK_SIZE];
+static struct rt_thread rti_defer_thread;
+#endif /* RT_USING_HEAP */
+
+static void rti_defer_entry(void *parameter)
+{
+    const struct rt_init_desc *desc;
+
+    for (desc = &__rt_init_desc_rti_board_end; desc < &__rt_init_desc_rti_end; desc ++)
+    {
+        if (rti_deferred(desc->fn_name))
+            rti_call(desc, RTI_PHASE_DEFER);
+    }
+#ifdef RT_USING_INIT_PROFILE
+    rti_profile_mark("defer_done");
+#endif
+}
+
+/**
+ * @brief  Start the thread of the deferred initialization functions. It runs
+ *         them in the order of the init table when the higher priority
+ *         threads wait.
+ */
+static void rt_components_defer_init(void)
+{
+    rt_thread_t tid;
+
+    if (RT_INIT_DEFER_LIST[0] == '\0')
+        return;
+
+#ifdef RT_USING_HEAP
+    tid = rt_thread_create("init_d", rti_defer_entry, RT_NULL,
+                           RT_INIT_DEFER_STACK_SIZE, RT_INIT_DEFER_PRIORITY, 20);
+#else
+    tid = &rti_defer_thread;
+    if (rt_thread_init(tid, "init_d", rti_defer_entry, RT_NULL, rti_defer_stack,
+                       sizeof(rti_defer_stack), RT_INIT_DEFER_PRIORITY, 20) != RT_EOK)
+        tid = RT_NULL;
+#endif /* RT_USING_HEAP */
+
+    if (tid != RT_NULL)
+        rt_thread_startup(tid);
+    else
+        rti_defer_entry(RT_NULL);   /* no thread, run them before main() */
+}
+#endif /* RT_USING_INIT_DEFER */
+
+#if defined(RT_USING_INIT_PROFILE) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+
+static const char *const rti_phase_names[] = {"board", "component", "deferred", "mark"};
+
+static rt_uint32_t rti_us(rt_uint32_t count)
+{
+#ifdef RT_USING_CPUTIME
+    float res = clock_cpu_getres();
+
+    if (res > 0)
+        return (rt_uint32_t)(count * res / 1000.0f);
+#endif
+    return (rt_uint32_t)((rt_uint64_t)count * 1000000UL / RT_TICK_PER_SECOND);
+}
+
+static rt_uint32_t rti_phase_us(rt_uint8_t phase)
+{
+    rt_uint32_t used = 0;
+    rt_uint16_t index;
+
+    for (index = 0; index < rti_record_count; index ++)
+    {
+        if (rti_records[index].phase == phase)
+            used += rti_records[index].used;
+    }
+
+    return rti_us(used);
+}
+
+static int init_profile(int argc, char **argv)
+{
+    rt_uint16_t order[RT_INIT_PROFILE_MAX];
+    rt_uint16_t index, count, pos;
+    const struct rti_record *record;
+    int top = 10;
+
+    if (argc > 1 && rt_strcmp(argv[1], "-csv") == 0)
+    {
+        rt_kprintf("init,phase,name,start_us,time_us,result\n");
+        for (index = 0; index < rti_record_count; index ++)
+        {
+            record = &rti_records[index];
+            rt_kprintf("init,%s,%s,%u,%u,%d\n", rti_phase_names[record->phase], record->name,
+                       rti_us(record->start), rti_us(record->used), record->result);
+        }
+        return 0;
+    }
+    if (argc > 1)
+    {
+        top = atoi(argv[1]);
+        if (top <= 0)
+        {
+            rt_kprintf("Usage: init_profile [count]   the slowest initialization functions, default 10\n");
+            rt_kprintf("       init_profile -csv      all the records for tools/init_report.py\n");
+            return -RT_EINVAL;
+        }
+    }
+
+    /* the functions by the time used, the slowest first */
+    count = 0;
+    for (index = 0; index < rti_record_count; index ++)
+    {
+        if (rti_records[index].phase == RTI_PHASE_MARK)
+            continue;
+        for (pos = count; pos > 0 && rti_records[order[pos - 1]].used < rti_records[index].used; pos --)
+            order[pos] = order[pos - 1];
+        order[pos] = index;
+        count ++;
+    }
+
+    for (index = 0; index < rti_record_count; index ++)
+    {
+        if (rti_records[index].phase == RTI_PHASE_MARK)
+            rt_kprintf("%-10s at %u us\n", rti_records[index].name, rti_us(rti_records[index].start));
+    }
+    rt_kprintf("board %u us, components %u us, deferred %u us, %d functions",
+               rti_phase_us(RTI_PHASE_BOARD), rti_phase_us(RTI_PHASE_COMPONENTS),
+               rti_phase_us(RTI_PHASE_DEFER), count);
+    if (rti_record_lost)
+        rt_kprintf(", %d not recorded", rti_record_lost);
+    rt_kprintf("\n\n   time_us   start_us  phase      result  name\n");
+    for (index = 0; index < count && index < top; index ++)
+    {
+        record = &rti_records[order[index]];
+        rt_kprintf("%10u %10u  %-10s %6d  %s\n", rti_us(record->used), rti_us(record->start),
+                   rti_phase_names[record->phase], record->result, record->name);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(init_profile, show the slowest initialization functions: init_profile [count|-csv]);
+#endif /* defined(RT_USING_INIT_PROFILE) && defined(RT_USING_FINSH) */
 #endif /* RT_USING_COMPONENTS_INIT */
 
 #ifdef RT_USING_USER_MAIN
@@ -180,6 +483,9 @@ void main_thread_entry(void *parameter)
 {
     extern int main(void);
 
+#ifdef RT_USING_INIT_PROFILE
+    rti_profile_mark("main_thread");
+#endif
 #ifdef RT_USING_COMPONENTS_INIT
     /* RT-Thread components initialization */
     rt_components_init();
@@ -188,6 +494,12 @@ void main_thread_entry(void *parameter)
 #ifdef RT_USING_SMP
     rt_hw_secondary_cpu_up();
 #endif /* RT_USING_SMP */
+#ifdef RT_USING_INIT_DEFER
+    rt_components_defer_init();
+#endif
+#ifdef RT_USING_INIT_PROFILE
+    rti_profile_mark("main");
+#endif
     /* invoke system main function */
 #ifdef __ARMCC_VERSION
     {
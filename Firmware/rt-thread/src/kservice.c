@@ -20,6 +20,8 @@
  * 2021-02-28     Meco Man     add RT_KSERVICE_USING_STDLIB
  * 2021-12-20     Meco Man     implement rt_strcpy()
  * 2022-01-07     Gabriel      add __on_rt_assert_hook
+ * 2026-10-19     RT-Thread    add rt_memory_frag_info and heap profiler hooks
+ * 2026-10-19     RT-Thread    word copy for unaligned sources in rt_memcpy and rt_memmove
  */
 
 #include <rtthread.h>
@@ -117,6 +119,95 @@ int *_rt_errno(void)
 }
 RTM_EXPORT(_rt_errno);
 
+#ifndef RT_KSERVICE_USING_TINY_SIZE
+#define _MEM_WORD               (sizeof(rt_ubase_t))
+#define _MEM_UNALIGNED(x)       ((rt_ubase_t)(x) & (_MEM_WORD - 1))
+/* below it the setup of the word loops costs more than it saves */
+#define _MEM_TOO_SMALL(n)       ((n) < _MEM_WORD * 4)
+
+/* the word at the lower address holds the first bytes, shift the two halves into one word */
+#ifdef ARCH_CPU_BIG_ENDIAN
+#define _MEM_MERGE(lo, hi, shift) (((lo) << (shift)) | ((hi) >> (_MEM_WORD * 8 - (shift))))
+#else
+#define _MEM_MERGE(lo, hi, shift) (((lo) >> (shift)) | ((hi) << (_MEM_WORD * 8 - (shift))))
+#endif /* ARCH_CPU_BIG_ENDIAN */
+#endif /* RT_KSERVICE_USING_TINY_SIZE */
+
+#if !defined(RT_KSERVICE_USING_TINY_SIZE) && !defined(RT_KSERVICE_USING_STDLIB_MEMCPY)
+/*
+ * Copy from the lower address up. The destination is aligned first, then a
+ * source of the same alignment is copied four words at a time, and a source
+ * of another alignment is read as aligned words and shifted into place, so
+ * no unaligned word access is made. It is safe for an overlap where the
+ * destination is below the source.
+ */
+static void _mem_copy_forward(rt_uint8_t *dst, const rt_uint8_t *src, rt_ubase_t count)
+{
+    rt_ubase_t *aligned_dst;
+    const rt_ubase_t *aligned_src;
+    rt_ubase_t prev, next, shift, left;
+
+    if (!_MEM_TOO_SMALL(count))
+    {
+        while (_MEM_UNALIGNED(dst))
+        {
+            *dst++ = *src++;
+            count --;
+        }
+
+        aligned_dst = (rt_ubase_t *)dst;
+        if (!_MEM_UNALIGNED(src))
+        {
+            aligned_src = (const rt_ubase_t *)src;
+            while (count >= _MEM_WORD * 4)
+            {
+                aligned_dst[0] = aligned_src[0];
+                aligned_dst[1] = aligned_src[1];
+                aligned_dst[2] = aligned_src[2];
+                aligned_dst[3] = aligned_src[3];
+                aligned_dst += 4;
+                aligned_src += 4;
+                count -= _MEM_WORD * 4;
+            }
+            while (count >= _MEM_WORD)
+            {
+                *aligned_dst++ = *aligned_src++;
+                count -= _MEM_WORD;
+            }
+            src = (const rt_uint8_t *)aligned_src;
+        }
+        else
+        {
+            /* the words read never leave the aligned words holding the source bytes */
+            shift = _MEM_UNALIGNED(src) * 8;
+            aligned_src = (const rt_ubase_t *)(src - _MEM_UNALIGNED(src));
+            left = count;
+            prev = *aligned_src++;
+            while (count >= _MEM_WORD * 2)
+            {
+                next = *aligned_src++;
+                aligned_dst[0] = _MEM_MERGE(prev, next, shift);
+                prev = *aligned_src++;
+                aligned_dst[1] = _MEM_MERGE(next, prev, shift);
+                aligned_dst += 2;
+                count -= _MEM_WORD * 2;
+            }
+            if (count >= _MEM_WORD)
+            {
+                next = *aligned_src;
+                *aligned_dst++ = _MEM_MERGE(prev, next, shift);
+                count -= _MEM_WORD;
+            }
+            src += left - count;
+        }
+        dst = (rt_uint8_t *)aligned_dst;
+    }
+
+    while (count--)
+        *dst++ = *src++;
+}
+#endif /* !defined(RT_KSERVICE_USING_TINY_SIZE) && !defined(RT_KSERVICE_USING_STDLIB_MEMCPY) */
+
 #ifndef RT_KSERVICE_USING_STDLIB_MEMSET
 /**
  * This function will set the content of memory to specified value.
@@ -140,66 +231,60 @@ RT_WEAK void *rt_memset(void *s, int c, rt_ubase_t count)
 
     return s;
 #else
-#define LBLOCKSIZE      (sizeof(long))
-#define UNALIGNED(X)    ((long)X & (LBLOCKSIZE - 1))
-#define TOO_SMALL(LEN)  ((LEN) < LBLOCKSIZE)
-
     unsigned int i;
-    char *m = (char *)s;
-    unsigned long buffer;
-    unsigned long *aligned_addr;
-    unsigned int d = c & 0xff;  /* To avoid sign extension, copy C to an
+    rt_uint8_t *m = (rt_uint8_t *)s;
+    rt_ubase_t buffer;
+    rt_ubase_t *aligned_addr;
+    rt_uint8_t d = c & 0xff;    /* To avoid sign extension, copy C to an
                                 unsigned variable.  */
 
-    if (!TOO_SMALL(count) && !UNALIGNED(s))
+    if (!_MEM_TOO_SMALL(count))
     {
-        /* If we get this far, we know that count is large and s is word-aligned. */
-        aligned_addr = (unsigned long *)s;
+        /* Set the head up to the first word boundary byte by byte. */
+        while (_MEM_UNALIGNED(m))
+        {
+            *m++ = d;
+            count --;
+        }
+        aligned_addr = (rt_ubase_t *)m;
 
         /* Store d into each char sized location in buffer so that
          * we can set large blocks quickly.
          */
-        if (LBLOCKSIZE == 4)
-        {
-            buffer = (d << 8) | d;
-            buffer |= (buffer << 16);
-        }
-        else
-        {
-            buffer = 0;
-            for (i = 0; i < LBLOCKSIZE; i ++)
-                buffer = (buffer << 8) | d;
-        }
+        buffer = 0;
+        for (i = 0; i < _MEM_WORD; i ++)
+            buffer = (buffer << 8) | d;
 
-        while (count >= LBLOCKSIZE * 4)
+        while (count >= _MEM_WORD * 8)
         {
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            count -= 4 * LBLOCKSIZE;
+            aligned_addr[0] = buffer;
+            aligned_addr[1] = buffer;
+            aligned_addr[2] = buffer;
+            aligned_addr[3] = buffer;
+            aligned_addr[4] = buffer;
+            aligned_addr[5] = buffer;
+            aligned_addr[6] = buffer;
+            aligned_addr[7] = buffer;
+            aligned_addr += 8;
+            count -= _MEM_WORD * 8;
         }
 
-        while (count >= LBLOCKSIZE)
+        while (count >= _MEM_WORD)
         {
             *aligned_addr++ = buffer;
-            count -= LBLOCKSIZE;
+            count -= _MEM_WORD;
         }
 
         /* Pick up the remainder with a bytewise loop. */
-        m = (char *)aligned_addr;
+        m = (rt_uint8_t *)aligned_addr;
     }
 
     while (count--)
     {
-        *m++ = (char)d;
+        *m++ = d;
     }
 
     return s;
-
-#undef LBLOCKSIZE
-#undef UNALIGNED
-#undef TOO_SMALL
 #endif /* RT_KSERVICE_USING_TINY_SIZE */
 }
 RTM_EXPORT(rt_memset);
@@ -236,62 +321,62 @@ RT_WEAK void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
 
     return dst;
 #else
+    _mem_copy_forward((rt_uint8_t *)dst, (const rt_uint8_t *)src, count);
 
-#define UNALIGNED(X, Y) \
-    (((long)X & (sizeof (long) - 1)) | ((long)Y & (sizeof (long) - 1)))
-#define BIGBLOCKSIZE    (sizeof (long) << 2)
-#define LITTLEBLOCKSIZE (sizeof (long))
-#define TOO_SMALL(LEN)  ((LEN) < BIGBLOCKSIZE)
-
-    char *dst_ptr = (char *)dst;
-    char *src_ptr = (char *)src;
-    long *aligned_dst;
-    long *aligned_src;
-    int len = count;
-
-    /* If the size is small, or either SRC or DST is unaligned,
-    then punt into the byte copy loop.  This should be rare. */
-    if (!TOO_SMALL(len) && !UNALIGNED(src_ptr, dst_ptr))
-    {
-        aligned_dst = (long *)dst_ptr;
-        aligned_src = (long *)src_ptr;
+    return dst;
+#endif /* RT_KSERVICE_USING_TINY_SIZE */
+}
+RTM_EXPORT(rt_memcpy);
+#endif /* RT_KSERVICE_USING_STDLIB_MEMCPY */
 
-        /* Copy 4X long words at a time if possible. */
-        while (len >= BIGBLOCKSIZE)
+#ifndef RT_KSERVICE_USING_STDLIB
+
+#ifndef RT_KSERVICE_USING_TINY_SIZE
+/*
+ * Copy from the higher address down, for an overlap where the destination is
+ * above the source. Only a source of the same alignment takes the word loop.
+ */
+static void _mem_copy_backward(rt_uint8_t *dst, const rt_uint8_t *src, rt_ubase_t count)
+{
+    rt_ubase_t *aligned_dst;
+    const rt_ubase_t *aligned_src;
+
+    dst += count;
+    src += count;
+
+    if (!_MEM_TOO_SMALL(count) && _MEM_UNALIGNED(dst) == _MEM_UNALIGNED(src))
+    {
+        while (_MEM_UNALIGNED(dst))
         {
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            len -= BIGBLOCKSIZE;
+            *--dst = *--src;
+            count --;
         }
 
-        /* Copy one long word at a time if possible. */
-        while (len >= LITTLEBLOCKSIZE)
+        aligned_dst = (rt_ubase_t *)dst;
+        aligned_src = (const rt_ubase_t *)src;
+        while (count >= _MEM_WORD * 4)
         {
-            *aligned_dst++ = *aligned_src++;
-            len -= LITTLEBLOCKSIZE;
+            aligned_dst -= 4;
+            aligned_src -= 4;
+            aligned_dst[3] = aligned_src[3];
+            aligned_dst[2] = aligned_src[2];
+            aligned_dst[1] = aligned_src[1];
+            aligned_dst[0] = aligned_src[0];
+            count -= _MEM_WORD * 4;
         }
-
-        /* Pick up any residual with a byte copier. */
-        dst_ptr = (char *)aligned_dst;
-        src_ptr = (char *)aligned_src;
+        while (count >= _MEM_WORD)
+        {
+            *--aligned_dst = *--aligned_src;
+            count -= _MEM_WORD;
+        }
+        dst = (rt_uint8_t *)aligned_dst;
+        src = (const rt_uint8_t *)aligned_src;
     }
 
-    while (len--)
-        *dst_ptr++ = *src_ptr++;
-
-    return dst;
-#undef UNALIGNED
-#undef BIGBLOCKSIZE
-#undef LITTLEBLOCKSIZE
-#undef TOO_SMALL
-#endif /* RT_KSERVICE_USING_TINY_SIZE */
+    while (count--)
+        *--dst = *--src;
 }
-RTM_EXPORT(rt_memcpy);
-#endif /* RT_KSERVICE_USING_STDLIB_MEMCPY */
-
-#ifndef RT_KSERVICE_USING_STDLIB
+#endif /* RT_KSERVICE_USING_TINY_SIZE */
 
 /**
  * This function will move memory content from source address to destination
@@ -310,6 +395,7 @@ void *rt_memmove(void *dest, const void *src, rt_size_t n)
 {
     char *tmp = (char *)dest, *s = (char *)src;
 
+#ifdef RT_KSERVICE_USING_TINY_SIZE
     if (s < tmp && tmp < s + n)
     {
         tmp += n;
@@ -323,6 +409,12 @@ void *rt_memmove(void *dest, const void *src, rt_size_t n)
         while (n--)
             *tmp++ = *s++;
     }
+#else
+    if (s < tmp && tmp < s + n)
+        _mem_copy_backward((rt_uint8_t *)tmp, (const rt_uint8_t *)s, n);
+    else
+        _mem_copy_forward((rt_uint8_t *)tmp, (const rt_uint8_t *)s, n);
+#endif /* RT_KSERVICE_USING_TINY_SIZE */
 
     return dest;
 }
@@ -347,7 +439,32 @@ rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_size_t count)
     const unsigned char *su1, *su2;
     int res = 0;
 
-    for (su1 = (const unsigned char *)cs, su2 = (const unsigned char *)ct; 0 < count; ++su1, ++su2, count--)
+    su1 = (const unsigned char *)cs;
+    su2 = (const unsigned char *)ct;
+
+#ifndef RT_KSERVICE_USING_TINY_SIZE
+    /* skip the equal words, the byte loop below finds the first different byte */
+    if (!_MEM_TOO_SMALL(count) && _MEM_UNALIGNED(su1) == _MEM_UNALIGNED(su2))
+    {
+        while (_MEM_UNALIGNED(su1))
+        {
+            if ((res = *su1 - *su2) != 0)
+                return res;
+            su1 ++;
+            su2 ++;
+            count --;
+        }
+
+        while (count >= _MEM_WORD && *(const rt_ubase_t *)su1 == *(const rt_ubase_t *)su2)
+        {
+            su1 += _MEM_WORD;
+            su2 += _MEM_WORD;
+            count -= _MEM_WORD;
+        }
+    }
+#endif /* RT_KSERVICE_USING_TINY_SIZE */
+
+    for (; 0 < count; ++su1, ++su2, count--)
         if ((res = *su1 - *su2) != 0)
             break;
 
@@ -1403,6 +1520,8 @@ rt_inline void _smem_info(rt_size_t *total,
     rt_smem_free(_ptr)
 #define _MEM_INFO(_total, _used, _max)  \
     _smem_info(_total, _used, _max)
+#define _MEM_FRAG(_blocks, _max)    \
+    rt_smem_frag_info(system_heap, _blocks, _max)
 #elif defined(RT_USING_MEMHEAP_AS_HEAP)
 static struct rt_memheap system_heap;
 void *_memheap_alloc(struct rt_memheap *heap, rt_size_t size);
@@ -1439,6 +1558,29 @@ rt_inline void _slab_info(rt_size_t *total,
 #define _MEM_FREE(_ptr) \
     rt_slab_free(system_heap, _ptr)
 #define _MEM_INFO       _slab_info
+#elif defined(RT_USING_TLSF_AS_HEAP)
+static rt_tlsf_t system_heap;
+rt_inline void _tlsf_info(rt_size_t *total,
+    rt_size_t *used, rt_size_t *max_used)
+{
+    if (total)
+        *total = system_heap->total;
+    if (used)
+        *used = system_heap->used;
+    if (max_used)
+        *max_used = system_heap->max;
+}
+#define _MEM_INIT(_name, _start, _size) \
+    system_heap = rt_tlsf_init(_name, _start, _size)
+#define _MEM_MALLOC(_size)  \
+    rt_tlsf_alloc(system_heap, _size)
+#define _MEM_REALLOC(_ptr, _newsize)    \
+    rt_tlsf_realloc(system_heap, _ptr, _newsize)
+#define _MEM_FREE(_ptr) \
+    rt_tlsf_free(system_heap, _ptr)
+#define _MEM_INFO       _tlsf_info
+#define _MEM_FRAG(_blocks, _max)    \
+    rt_tlsf_frag_info(system_heap, _blocks, _max)
 #else
 #define _MEM_INIT(...)
 #define _MEM_MALLOC(...)     RT_NULL
@@ -1447,6 +1589,25 @@ rt_inline void _slab_info(rt_size_t *total,
 #define _MEM_INFO(...)
 #endif
 
+#ifndef _MEM_FRAG
+#define _MEM_FRAG(...)
+#endif
+
+#ifdef RT_USING_MEMPROF
+void rt_memprof_alloc(void *ptr, rt_size_t size, void *caller);
+void rt_memprof_realloc(void *rmem, void *ptr, rt_size_t size, void *caller);
+void rt_memprof_retag(void *ptr, void *caller);
+void rt_memprof_free(void *ptr);
+
+#if defined(__CC_ARM)
+#define _MEM_CALLER()   ((void *)__return_address())
+#elif defined(__GNUC__) || defined(__clang__)
+#define _MEM_CALLER()   __builtin_return_address(0)
+#else
+#define _MEM_CALLER()   RT_NULL
+#endif
+#endif /* RT_USING_MEMPROF */
+
 /**
  * @brief This function will init system heap.
  *
@@ -1485,6 +1646,9 @@ RT_WEAK void *rt_malloc(rt_size_t size)
     ptr = _MEM_MALLOC(size);
     /* Exit critical zone */
     _heap_unlock(level);
+#ifdef RT_USING_MEMPROF
+    rt_memprof_alloc(ptr, size, _MEM_CALLER());
+#endif /* RT_USING_MEMPROF */
     /* call 'rt_malloc' hook */
     RT_OBJECT_HOOK_CALL(rt_malloc_hook, (ptr, size));
     return ptr;
@@ -1511,6 +1675,9 @@ RT_WEAK void *rt_realloc(void *rmem, rt_size_t newsize)
     nptr = _MEM_REALLOC(rmem, newsize);
     /* Exit critical zone */
     _heap_unlock(level);
+#ifdef RT_USING_MEMPROF
+    rt_memprof_realloc(rmem, nptr, newsize, _MEM_CALLER());
+#endif /* RT_USING_MEMPROF */
     return nptr;
 }
 RTM_EXPORT(rt_realloc);
@@ -1538,6 +1705,9 @@ RT_WEAK void *rt_calloc(rt_size_t count, rt_size_t size)
     if (p)
     {
         rt_memset(p, 0, count * size);
+#ifdef RT_USING_MEMPROF
+        rt_memprof_retag(p, _MEM_CALLER());
+#endif /* RT_USING_MEMPROF */
     }
     return p;
 }
@@ -1555,6 +1725,9 @@ RT_WEAK void rt_free(void *rmem)
 
     /* call 'rt_free' hook */
     RT_OBJECT_HOOK_CALL(rt_free_hook, (rmem));
+#ifdef RT_USING_MEMPROF
+    rt_memprof_free(rmem);
+#endif /* RT_USING_MEMPROF */
     /* Enter critical zone */
     level = _heap_lock();
     _MEM_FREE(rmem);
@@ -1587,6 +1760,34 @@ RT_WEAK void rt_memory_info(rt_size_t *total,
 }
 RTM_EXPORT(rt_memory_info);
 
+/**
+* @brief This function will get the fragmentation information of the system heap.
+*
+* @note Only the small memory and tlsf heap algorithms report it, the others
+*       return zero.
+*
+* @param free_blocks is a pointer to get the number of free blocks.
+*
+* @param max_free is a pointer to get the size of the largest free block.
+*/
+RT_WEAK void rt_memory_frag_info(rt_size_t *free_blocks,
+                                 rt_size_t *max_free)
+{
+    rt_base_t level;
+
+    if (free_blocks)
+        *free_blocks = 0;
+    if (max_free)
+        *max_free = 0;
+
+    /* Enter critical zone */
+    level = _heap_lock();
+    _MEM_FRAG(free_blocks, max_free);
+    /* Exit critical zone */
+    _heap_unlock(level);
+}
+RTM_EXPORT(rt_memory_frag_info);
+
 #if defined(RT_USING_SLAB) && defined(RT_USING_SLAB_AS_HEAP)
 void *rt_page_alloc(rt_size_t npages)
 {
@@ -1811,4 +2012,242 @@ void rt_assert_handler(const char *ex_string, const char *func, rt_size_t line)
 RTM_EXPORT(rt_assert_handler);
 #endif /* RT_DEBUG */
 
+#if defined(RT_USING_FINSH) && defined(RT_KSERVICE_USING_BENCH)
+#include <finsh.h>
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()            ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT             "cycle"
+#else
+#define _BENCH_NOW()            ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT             "tick"
+#endif /* RT_USING_CPUTIME */
+
+#define _BENCH_SIZE_MAX         1024
+#define _BENCH_BYTES            (64 * 1024)     /* bytes moved by each measure */
+#define _BENCH_CHECK_MAX        80              /* sizes checked one by one */
+#define _BENCH_PAD              16
+
+enum
+{
+    _BENCH_MEMCPY,
+    _BENCH_MEMMOVE,
+    _BENCH_MEMSET,
+    _BENCH_MEMCMP,
+};
+
+static const char *const _bench_op_name[] = {"memcpy", "memmove", "memset", "memcmp"};
+static const rt_uint16_t _bench_size[] = {8, 32, 128, 512, 1024};
+static const rt_uint8_t _bench_align[][2] = {{0, 0}, {1, 1}, {0, 1}, {0, 2}, {3, 1}};
+
+static rt_uint32_t _bench_measure(int op, rt_uint8_t *dst, rt_uint8_t *src, rt_size_t size)
+{
+    rt_uint32_t rounds = _BENCH_BYTES / size, index, t0;
+    volatile rt_int32_t sink = 0;
+
+    t0 = _BENCH_NOW();
+    for (index = 0; index < rounds; index ++)
+    {
+        switch (op)
+        {
+        case _BENCH_MEMCPY:
+            rt_memcpy(dst, src, size);
+            break;
+        case _BENCH_MEMMOVE:
+            rt_memmove(dst, src, size);
+            break;
+        case _BENCH_MEMSET:
+            rt_memset(dst, (int)index, size);
+            break;
+        default:
+            sink += rt_memcmp(dst, src, size);
+            break;
+        }
+    }
+
+    return _BENCH_NOW() - t0;
+}
+
+static void _bench_fill(rt_uint8_t *buf, rt_size_t size, rt_uint32_t seed)
+{
+    while (size--)
+    {
+        seed = seed * 1103515245 + 12345;
+        *buf++ = (rt_uint8_t)(seed >> 16);
+    }
+}
+
+/* compare every size, alignment and overlap against plain byte loops */
+static int _bench_check(rt_uint8_t *a, rt_uint8_t *b, rt_uint8_t *ref)
+{
+    rt_size_t size, len = _BENCH_CHECK_MAX + 2 * _BENCH_PAD, i;
+    int dst_off, src_off, shift, errors = 0;
+
+    for (size = 0; size <= _BENCH_CHECK_MAX; size ++)
+    {
+        for (dst_off = 0; dst_off < sizeof(rt_ubase_t); dst_off ++)
+        {
+            for (src_off = 0; src_off < sizeof(rt_ubase_t); src_off ++)
+            {
+                /* memcpy and memmove between two buffers, the bytes around must be kept */
+                _bench_fill(a, len, size + 1);
+                _bench_fill(b, len, size + 2);
+                rt_memcpy(ref, a, len);
+                for (i = 0; i < size; i ++)
+                    ref[_BENCH_PAD + dst_off + i] = b[_BENCH_PAD + src_off + i];
+                rt_memcpy(a + _BENCH_PAD + dst_off, b + _BENCH_PAD + src_off, size);
+                for (i = 0; i < len && a[i] == ref[i]; i ++);
+                if (i != len)
+                {
+                    rt_kprintf("memcpy failed: size %d dst +%d src +%d\n", size, dst_off, src_off);
+                    errors ++;
+                }
+
+                _bench_fill(a, len, size + 3);
+                rt_memmove(a + _BENCH_PAD + dst_off, b + _BENCH_PAD + src_off, size);
+                for (i = 0; i < size && a[_BENCH_PAD + dst_off + i] == b[_BENCH_PAD + src_off + i]; i ++);
+                if (i != size)
+                {
+                    rt_kprintf("memmove failed: size %d dst +%d src +%d\n", size, dst_off, src_off);
+                    errors ++;
+                }
+
+                /* memcmp on equal data and on one different byte at the start, middle and end */
+                rt_memcpy(a + _BENCH_PAD + dst_off, b + _BENCH_PAD + src_off, size);
+                if (rt_memcmp(a + _BENCH_PAD + dst_off, b + _BENCH_PAD + src_off, size) != 0)
+                {
+                    rt_kprintf("memcmp failed: size %d +%d +%d equal\n", size, dst_off, src_off);
+                    errors ++;
+                }
+                for (i = 0; size && i < 3; i ++)
+                {
+                    rt_size_t pos = (size - 1) * i / 2;
+                    rt_uint8_t save = a[_BENCH_PAD + dst_off + pos];
+                    int expect, res;
+
+                    a[_BENCH_PAD + dst_off + pos] = save ^ (1 << i);
+                    expect = (int)a[_BENCH_PAD + dst_off + pos] - (int)b[_BENCH_PAD + src_off + pos];
+                    res = rt_memcmp(a + _BENCH_PAD + dst_off, b + _BENCH_PAD + src_off, size);
+                    if ((res < 0) != (expect < 0) || (res == 0))
+                    {
+                        rt_kprintf("memcmp failed: size %d +%d +%d byte %d\n", size, dst_off, src_off, pos);
+                        errors ++;
+                    }
+                    a[_BENCH_PAD + dst_off + pos] = save;
+                }
+            }
+
+            /* memset */
+            _bench_fill(a, len, size + 4);
+            rt_memcpy(ref, a, len);
+            for (i = 0; i < size; i ++)
+                ref[_BENCH_PAD + dst_off + i] = 0xA5;
+            rt_memset(a + _BENCH_PAD + dst_off, 0x1A5, size);
+            for (i = 0; i < len && a[i] == ref[i]; i ++);
+            if (i != len)
+            {
+                rt_kprintf("memset failed: size %d dst +%d\n", size, dst_off);
+                errors ++;
+            }
+        }
+
+        /* memmove inside one buffer, both directions */
+        for (shift = -(int)sizeof(rt_ubase_t) - 1; shift <= (int)sizeof(rt_ubase_t) + 1; shift ++)
+        {
+            _bench_fill(a, len, size + 5);
+            rt_memcpy(ref, a, len);
+            rt_memcpy(b, a + _BENCH_PAD, size);
+            for (i = 0; i < size; i ++)
+                ref[_BENCH_PAD + shift + i] = b[i];
+            rt_memmove(a + _BENCH_PAD + shift, a + _BENCH_PAD, size);
+            for (i = 0; i < len && a[i] == ref[i]; i ++);
+            if (i != len)
+            {
+                rt_kprintf("memmove failed: size %d shift %d\n", size, shift);
+                errors ++;
+            }
+        }
+    }
+
+    return errors;
+}
+
+static int mem_bench(int argc, char **argv)
+{
+    rt_uint8_t *a, *b, *ref;
+    rt_uint32_t dt, rate;
+    int op, align, index, errors;
+
+    a = rt_malloc(_BENCH_SIZE_MAX + _BENCH_PAD);
+    b = rt_malloc(_BENCH_SIZE_MAX + _BENCH_PAD);
+    ref = rt_malloc(_BENCH_CHECK_MAX + 2 * _BENCH_PAD);
+    if (a == RT_NULL || b == RT_NULL || ref == RT_NULL)
+    {
+        rt_kprintf("no memory for the bench buffers\n");
+        errors = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    if (argc > 1 && rt_strcmp(argv[1], "check") == 0)
+    {
+        errors = _bench_check(a, b, ref);
+        rt_kprintf("check %s, %d errors\n", errors ? "failed" : "passed", errors);
+        goto __exit;
+    }
+
+    _bench_fill(a, _BENCH_SIZE_MAX + _BENCH_PAD, 1);
+    rt_memcpy(b, a, _BENCH_SIZE_MAX + _BENCH_PAD);
+
+    rt_kprintf("bytes per %s, %d bytes for each measure\n", _BENCH_UNIT, _BENCH_BYTES);
+    rt_kprintf("op      dst src");
+    for (index = 0; index < sizeof(_bench_size) / sizeof(_bench_size[0]); index ++)
+        rt_kprintf(" %7d", _bench_size[index]);
+    rt_kprintf("\n");
+
+    for (op = _BENCH_MEMCPY; op <= _BENCH_MEMCMP; op ++)
+    {
+        for (align = 0; align < sizeof(_bench_align) / sizeof(_bench_align[0]); align ++)
+        {
+            /* memset has no source, measure each destination alignment once */
+            if (op == _BENCH_MEMSET)
+            {
+                for (index = 0; index < align && _bench_align[index][0] != _bench_align[align][0]; index ++);
+                if (index < align)
+                    continue;
+            }
+
+            rt_kprintf("%-7s +%d  ", _bench_op_name[op], _bench_align[align][0]);
+            if (op == _BENCH_MEMSET)
+                rt_kprintf("   ");
+            else
+                rt_kprintf("+%d ", _bench_align[align][1]);
+
+            for (index = 0; index < sizeof(_bench_size) / sizeof(_bench_size[0]); index ++)
+            {
+                dt = _bench_measure(op, a + _bench_align[align][0], b + _bench_align[align][1],
+                                    _bench_size[index]);
+                if (dt == 0)
+                    dt = 1;
+                /* two decimals */
+                rate = (rt_uint32_t)((rt_uint64_t)(_BENCH_BYTES / _bench_size[index]) * _bench_size[index] * 100 / dt);
+                rt_kprintf(" %4d.%02d", rate / 100, rate % 100);
+            }
+            rt_kprintf("\n");
+        }
+    }
+    errors = 0;
+
+__exit:
+    if (a)
+        rt_free(a);
+    if (b)
+        rt_free(b);
+    if (ref)
+        rt_free(ref);
+
+    return errors;
+}
+MSH_CMD_EXPORT(mem_bench, kernel memory primitives bench: mem_bench [check]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_KSERVICE_USING_BENCH) */
+
 /**@}*/
@@ -12,6 +12,7 @@
  * 2010-10-14     Bernard      fix rt_realloc issue when realloc a NULL pointer.
  * 2017-07-14     armink       fix rt_realloc issue when new size is 0
  * 2018-10-02     Bernard      Add 64bit support
+ * 2026-10-19     RT-Thread    add rt_smem_frag_info
  */
 
 /*
@@ -556,6 +557,47 @@ void rt_smem_free(void *rmem)
 }
 RTM_EXPORT(rt_smem_free);
 
+/**
+ * @brief This function will get the fragmentation information of small memory.
+ *
+ * @note It walks every block of the heap, so it is meant for diagnostics only.
+ *
+ * @param m the small memory management object.
+ *
+ * @param free_blocks is a pointer to get the number of free blocks.
+ *
+ * @param max_free is a pointer to get the size of the largest free block.
+ */
+void rt_smem_frag_info(rt_smem_t m, rt_size_t *free_blocks, rt_size_t *max_free)
+{
+    struct rt_small_mem_item *mem;
+    struct rt_small_mem *small_mem;
+    rt_size_t count = 0, largest = 0, size;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+
+    small_mem = (struct rt_small_mem *)m;
+    for (mem = (struct rt_small_mem_item *)small_mem->heap_ptr;
+         mem != small_mem->heap_end;
+         mem = (struct rt_small_mem_item *)&small_mem->heap_ptr[mem->next])
+    {
+        if (MEM_ISUSED(mem))
+            continue;
+
+        count ++;
+        size = MEM_SIZE(small_mem, mem);
+        if (size > largest)
+            largest = size;
+    }
+
+    if (free_blocks)
+        *free_blocks = count;
+    if (max_free)
+        *max_free = largest;
+}
+RTM_EXPORT(rt_smem_frag_info);
+
 #ifdef RT_USING_FINSH
 #include <finsh.h>
 
@@ -14,6 +14,7 @@
  * 2017-12-10     Bernard      Add object_info enum.
  * 2018-01-25     Bernard      Fix the object find issue when enable MODULE.
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to object.c
+ * 2026-10-19     RT-Thread    add the name hash index for rt_object_find
  */
 
 #include <rtthread.h>
@@ -114,6 +115,52 @@ static struct rt_object_information _object_container[RT_Object_Info_Unknown] =
 #endif
 };
 
+#ifdef RT_USING_OBJECT_HASH
+#ifndef RT_OBJECT_HASH_SIZE
+#define RT_OBJECT_HASH_SIZE             32
+#endif
+
+/* the objects of the container lists, chained by the hash of their names */
+static struct rt_object *_object_hash[RT_OBJECT_HASH_SIZE];
+
+static rt_uint32_t _object_name_hash(const char *name)
+{
+    rt_uint32_t hash = 2166136261u;
+    int index;
+
+    /* FNV-1a on the part of the name which rt_strncmp compares */
+    for (index = 0; index < RT_NAME_MAX && name[index] != '\0'; index ++)
+    {
+        hash ^= (rt_uint8_t)name[index];
+        hash *= 16777619u;
+    }
+
+    return hash % RT_OBJECT_HASH_SIZE;
+}
+
+/* call them with the interrupt disabled */
+static void _object_hash_insert(struct rt_object *object, rt_uint32_t bucket)
+{
+    object->hash_next = _object_hash[bucket];
+    _object_hash[bucket] = object;
+}
+
+static void _object_hash_remove(struct rt_object *object, rt_uint32_t bucket)
+{
+    struct rt_object **link;
+
+    for (link = &_object_hash[bucket]; *link != RT_NULL; link = &(*link)->hash_next)
+    {
+        if (*link == object)
+        {
+            *link = object->hash_next;
+            object->hash_next = RT_NULL;
+            break;
+        }
+    }
+}
+#endif /* RT_USING_OBJECT_HASH */
+
 #ifndef __on_rt_object_attach_hook
     #define __on_rt_object_attach_hook(obj)         __ON_HOOK_ARGS(rt_object_attach_hook, (obj))
 #endif
@@ -333,6 +380,9 @@ void rt_object_init(struct rt_object         *object,
     register rt_base_t temp;
     struct rt_list_node *node = RT_NULL;
     struct rt_object_information *information;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t bucket;
+#endif /* RT_USING_OBJECT_HASH */
 #ifdef RT_USING_MODULE
     struct rt_dlmodule *module = dlmodule_self();
 #endif /* RT_USING_MODULE */
@@ -369,6 +419,10 @@ void rt_object_init(struct rt_object         *object,
 
     RT_OBJECT_HOOK_CALL(rt_object_attach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     /* lock interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -383,6 +437,9 @@ void rt_object_init(struct rt_object         *object,
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        _object_hash_insert(object, bucket);
+#endif /* RT_USING_OBJECT_HASH */
     }
 
     /* unlock interrupt */
@@ -398,12 +455,19 @@ void rt_object_init(struct rt_object         *object,
 void rt_object_detach(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t bucket;
+#endif /* RT_USING_OBJECT_HASH */
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     /* reset object type */
     object->type = 0;
 
@@ -412,6 +476,9 @@ void rt_object_detach(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(object, bucket);
+#endif /* RT_USING_OBJECT_HASH */
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -432,6 +499,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     struct rt_object *object;
     register rt_base_t temp;
     struct rt_object_information *information;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t bucket;
+#endif /* RT_USING_OBJECT_HASH */
 #ifdef RT_USING_MODULE
     struct rt_dlmodule *module = dlmodule_self();
 #endif /* RT_USING_MODULE */
@@ -465,6 +535,10 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 
     RT_OBJECT_HOOK_CALL(rt_object_attach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     /* lock interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -479,6 +553,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        _object_hash_insert(object, bucket);
+#endif /* RT_USING_OBJECT_HASH */
     }
 
     /* unlock interrupt */
@@ -496,6 +573,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 void rt_object_delete(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t bucket;
+#endif /* RT_USING_OBJECT_HASH */
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
@@ -503,6 +583,10 @@ void rt_object_delete(rt_object_t object)
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     /* reset object type */
     object->type = RT_Object_Class_Null;
 
@@ -511,6 +595,9 @@ void rt_object_delete(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(object, bucket);
+#endif /* RT_USING_OBJECT_HASH */
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -557,6 +644,59 @@ rt_uint8_t rt_object_get_type(rt_object_t object)
     return object->type & ~RT_Object_Class_Static;
 }
 
+#if !defined(RT_USING_OBJECT_HASH) || defined(RT_OBJECT_USING_BENCH)
+static rt_object_t _object_find_list(struct rt_object_information *information, const char *name)
+{
+    struct rt_object *object = RT_NULL;
+    struct rt_list_node *node = RT_NULL;
+
+    /* enter critical */
+    rt_enter_critical();
+
+    /* try to find object */
+    rt_list_for_each(node, &(information->object_list))
+    {
+        object = rt_list_entry(node, struct rt_object, list);
+        if (rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+        {
+            /* leave critical */
+            rt_exit_critical();
+
+            return object;
+        }
+    }
+
+    /* leave critical */
+    rt_exit_critical();
+
+    return RT_NULL;
+}
+#endif /* !defined(RT_USING_OBJECT_HASH) || defined(RT_OBJECT_USING_BENCH) */
+
+#ifdef RT_USING_OBJECT_HASH
+static rt_object_t _object_find_hash(struct rt_object_information *information, const char *name)
+{
+    struct rt_object *object;
+    rt_uint32_t bucket = _object_name_hash(name);
+
+    /* enter critical */
+    rt_enter_critical();
+
+    /* the newest object is at the head of a chain, the same one as the list finds */
+    for (object = _object_hash[bucket]; object != RT_NULL; object = object->hash_next)
+    {
+        if ((object->type & ~RT_Object_Class_Static) == information->type &&
+            rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+            break;
+    }
+
+    /* leave critical */
+    rt_exit_critical();
+
+    return object;
+}
+#endif /* RT_USING_OBJECT_HASH */
+
 /**
  * @brief This function will find specified name object from object
  *        container.
@@ -572,8 +712,6 @@ rt_uint8_t rt_object_get_type(rt_object_t object)
  */
 rt_object_t rt_object_find(const char *name, rt_uint8_t type)
 {
-    struct rt_object *object = RT_NULL;
-    struct rt_list_node *node = RT_NULL;
     struct rt_object_information *information = RT_NULL;
 
     information = rt_object_get_information((enum rt_object_class_type)type);
@@ -584,26 +722,120 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     /* which is invoke in interrupt status */
     RT_DEBUG_NOT_IN_INTERRUPT;
 
-    /* enter critical */
-    rt_enter_critical();
+#ifdef RT_USING_OBJECT_HASH
+    return _object_find_hash(information, name);
+#else
+    return _object_find_list(information, name);
+#endif /* RT_USING_OBJECT_HASH */
+}
 
-    /* try to find object */
-    rt_list_for_each(node, &(information->object_list))
+#if defined(RT_USING_FINSH) && defined(RT_OBJECT_USING_BENCH)
+#include <finsh.h>
+#include <stdlib.h>
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()            ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT             "cycles"
+#else
+#define _BENCH_NOW()            ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT             "ticks"
+#endif /* RT_USING_CPUTIME */
+
+#define _BENCH_ROUNDS           16
+
+static rt_uint32_t _bench_lookup(rt_object_t (*find)(struct rt_object_information *, const char *),
+                                 struct rt_object_information *information, struct rt_device *devices,
+                                 int count, const char *miss, rt_uint32_t *miss_time)
+{
+    rt_uint32_t t0, total;
+    int round, index;
+
+    t0 = _BENCH_NOW();
+    for (round = 0; round < _BENCH_ROUNDS; round ++)
     {
-        object = rt_list_entry(node, struct rt_object, list);
-        if (rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+        for (index = 0; index < count; index ++)
         {
-            /* leave critical */
-            rt_exit_critical();
-
-            return object;
+            if (find(information, devices[index].parent.name) != &devices[index].parent)
+                rt_kprintf("lookup of %s failed\n", devices[index].parent.name);
         }
     }
+    total = _BENCH_NOW() - t0;
 
-    /* leave critical */
+    t0 = _BENCH_NOW();
+    for (round = 0; round < _BENCH_ROUNDS * count; round ++)
+        find(information, miss);
+    *miss_time = _BENCH_NOW() - t0;
+
+    return total;
+}
+
+static int object_bench(int argc, char **argv)
+{
+    struct rt_object_information *information;
+    struct rt_device *devices;
+    char name[RT_NAME_MAX + 1];
+    rt_uint32_t list_hit, list_miss, hash_hit, hash_miss, lookups;
+    int count = 64, index, objects, used = 0, longest = 0, chain;
+    struct rt_object *object;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (count <= 0 || count > 999)
+    {
+        rt_kprintf("object_bench [count], count is 1 to 999\n");
+        return -RT_EINVAL;
+    }
+
+    information = rt_object_get_information(RT_Object_Class_Device);
+    devices = (struct rt_device *)rt_malloc(count * sizeof(struct rt_device));
+    if (information == RT_NULL || devices == RT_NULL)
+    {
+        rt_kprintf("no memory for %d devices\n", count);
+        if (devices)
+            rt_free(devices);
+        return -RT_ENOMEM;
+    }
+
+    /* plain devices which are never opened, registered like the ones of the drivers */
+    rt_memset(devices, 0, count * sizeof(struct rt_device));
+    for (index = 0; index < count; index ++)
+    {
+        rt_snprintf(name, sizeof(name), "bch%d", index);
+        rt_object_init(&devices[index].parent, RT_Object_Class_Device, name);
+    }
+    objects = rt_object_get_length(RT_Object_Class_Device);
+
+    lookups = _BENCH_ROUNDS * count;
+    list_hit = _bench_lookup(_object_find_list, information, devices, count, "nodev", &list_miss);
+    hash_hit = _bench_lookup(_object_find_hash, information, devices, count, "nodev", &hash_miss);
+
+    rt_enter_critical();
+    for (index = 0; index < RT_OBJECT_HASH_SIZE; index ++)
+    {
+        chain = 0;
+        for (object = _object_hash[index]; object != RT_NULL; object = object->hash_next)
+            chain ++;
+        if (chain)
+            used ++;
+        if (chain > longest)
+            longest = chain;
+    }
     rt_exit_critical();
 
-    return RT_NULL;
+    for (index = 0; index < count; index ++)
+        rt_object_detach(&devices[index].parent);
+    rt_free(devices);
+
+    rt_kprintf("%d devices, %d lookups each, time in %s\n", objects, lookups, _BENCH_UNIT);
+    rt_kprintf("lookup hit total  hit avg  miss total miss avg\n");
+    rt_kprintf("------ ---------- -------- ---------- --------\n");
+    rt_kprintf("list   %-10d %-8d %-10d %-8d\n", list_hit, list_hit / lookups, list_miss, list_miss / lookups);
+    rt_kprintf("hash   %-10d %-8d %-10d %-8d\n", hash_hit, hash_hit / lookups, hash_miss, hash_miss / lookups);
+    rt_kprintf("hash buckets: %d, used %d, longest chain %d (all the classes)\n", RT_OBJECT_HASH_SIZE, used, longest);
+
+    return 0;
 }
+MSH_CMD_EXPORT(object_bench, object lookup benchmark: object_bench [count]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_OBJECT_USING_BENCH) */
 
 /**@}*/
@@ -18,13 +18,44 @@
  *                             timeout function.
  * 2021-08-15     supperthomas add the comment
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to timer.c
+ * 2026-10-19     RT-Thread    add hierarchical timing wheel backend
  */
 
 #include <rtthread.h>
 #include <rthw.h>
 
+#ifdef RT_TIMER_USING_WHEEL
+#ifndef RT_TIMER_WHEEL_SLOT_BITS
+#define RT_TIMER_WHEEL_SLOT_BITS        4
+#endif /* RT_TIMER_WHEEL_SLOT_BITS */
+
+#define _WHEEL_SLOTS                    (1UL << RT_TIMER_WHEEL_SLOT_BITS)
+#define _WHEEL_MASK                     (_WHEEL_SLOTS - 1)
+#define _WHEEL_LEVELS                   ((32 + RT_TIMER_WHEEL_SLOT_BITS - 1) / RT_TIMER_WHEEL_SLOT_BITS)
+#define _WHEEL_JUMP                     (_WHEEL_SLOTS * _WHEEL_SLOTS)
+#define _WHEEL_INDEX(tick, lvl)         (((tick) >> ((lvl) * RT_TIMER_WHEEL_SLOT_BITS)) & _WHEEL_MASK)
+#define _WHEEL_NODE(timer)              (&(timer)->row[RT_TIMER_SKIP_LIST_LEVEL - 1])
+#define _WHEEL_TIMER(node)              rt_list_entry(node, struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1])
+
+/*
+ * Hierarchical timing wheel. A slot of level n spans SLOTS^n ticks and level n
+ * holds the timers which expire in less than SLOTS^(n+1) ticks. When a level
+ * wraps around, the next slot of the upper level is cascaded down, so all the
+ * timers of a level 0 slot expire on the same tick and are run as one batch.
+ */
+struct _timer_wheel
+{
+    rt_tick_t   now;                                /* the next tick to be run */
+    rt_uint32_t bitmap[_WHEEL_LEVELS];              /* slots which may be non-empty */
+    rt_list_t   slot[_WHEEL_LEVELS][_WHEEL_SLOTS];
+};
+
+/* hard timer wheel */
+static struct _timer_wheel _timer_wheel;
+#else
 /* hard timer list */
 static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif /* RT_TIMER_USING_WHEEL */
 
 #ifdef RT_USING_TIMER_SOFT
 
@@ -41,8 +72,13 @@ static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
 
 /* soft timer status */
 static rt_uint8_t _soft_timer_status = RT_SOFT_TIMER_IDLE;
+#ifdef RT_TIMER_USING_WHEEL
+/* soft timer wheel */
+static struct _timer_wheel _soft_timer_wheel;
+#else
 /* soft timer list */
 static rt_list_t _soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif /* RT_TIMER_USING_WHEEL */
 static struct rt_thread _timer_thread;
 ALIGN(RT_ALIGN_SIZE)
 static rt_uint8_t _timer_thread_stack[RT_TIMER_THREAD_STACK_SIZE];
@@ -153,6 +189,7 @@ static void _timer_init(rt_timer_t timer,
  * @return  Return the operation status. If the return value is RT_EOK, the function is successfully executed.
  *          If the return value is any other values, it means this operation failed.
  */
+#ifndef RT_TIMER_USING_WHEEL
 static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *timeout_tick)
 {
     struct rt_timer *timer;
@@ -179,6 +216,345 @@ static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *time
     return -RT_ERROR;
 }
 
+/**
+ * @brief Get the first timer of the timer list if it is timeout
+ *
+ * @param timer_list is the array of time list
+ *
+ * @param current_tick is the current tick
+ *
+ * @return the timeout timer, RT_NULL if there is none
+ */
+rt_inline struct rt_timer *_timer_list_next_expired(rt_list_t timer_list[], rt_tick_t current_tick)
+{
+    struct rt_timer *t;
+
+    if (rt_list_isempty(&timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+        return RT_NULL;
+
+    t = rt_list_entry(timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
+                      struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+    /*
+     * It supposes that the new tick shall less than the half duration of
+     * tick max.
+     */
+    if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        return t;
+
+    return RT_NULL;
+}
+#else
+/**
+ * @brief [internal] Initialize an empty timer wheel
+ *
+ * @param wheel is the timer wheel
+ */
+static void _timer_wheel_init(struct _timer_wheel *wheel)
+{
+    int lvl, index;
+
+    wheel->now = rt_tick_get();
+    for (lvl = 0; lvl < _WHEEL_LEVELS; lvl++)
+    {
+        wheel->bitmap[lvl] = 0;
+        for (index = 0; index < _WHEEL_SLOTS; index++)
+        {
+            rt_list_init(&wheel->slot[lvl][index]);
+        }
+    }
+}
+
+/**
+ * @brief [internal] Put a timer into the slot of its timeout tick, O(1)
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param timer is the timer, it shall not be in any list
+ */
+static void _timer_wheel_insert(struct _timer_wheel *wheel, rt_timer_t timer)
+{
+    rt_tick_t expires = timer->timeout_tick;
+    rt_tick_t delta = expires - wheel->now;
+    rt_uint32_t index;
+    int lvl;
+
+    /* the timer is already timeout, run it on the next tick of the wheel */
+    if (delta >= RT_TICK_MAX / 2)
+    {
+        expires = wheel->now;
+        delta = 0;
+    }
+
+    for (lvl = 0; lvl < _WHEEL_LEVELS - 1; lvl++)
+    {
+        if (delta < (1UL << ((lvl + 1) * RT_TIMER_WHEEL_SLOT_BITS)))
+            break;
+    }
+
+    index = _WHEEL_INDEX(expires, lvl);
+    rt_list_insert_before(&wheel->slot[lvl][index], _WHEEL_NODE(timer));
+    wheel->bitmap[lvl] |= 1UL << index;
+}
+
+/**
+ * @brief [internal] Move all the timers of a slot to the tail of a list
+ *
+ * @param to is the destination list
+ *
+ * @param from is the slot, it is empty after the move
+ */
+rt_inline void _timer_wheel_splice(rt_list_t *to, rt_list_t *from)
+{
+    if (rt_list_isempty(from))
+        return;
+
+    from->next->prev = to->prev;
+    to->prev->next   = from->next;
+    from->prev->next = to;
+    to->prev         = from->prev;
+    rt_list_init(from);
+}
+
+/**
+ * @brief [internal] Move the timers of an upper level slot to the lower levels
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param lvl is the level of the slot
+ *
+ * @param index is the index of the slot
+ */
+static void _timer_wheel_cascade(struct _timer_wheel *wheel, int lvl, rt_uint32_t index)
+{
+    rt_list_t list;
+    rt_timer_t t;
+
+    rt_list_init(&list);
+    _timer_wheel_splice(&list, &wheel->slot[lvl][index]);
+    wheel->bitmap[lvl] &= ~(1UL << index);
+
+    while (!rt_list_isempty(&list))
+    {
+        t = _WHEEL_TIMER(list.next);
+        rt_list_remove(_WHEEL_NODE(t));
+        _timer_wheel_insert(wheel, t);
+    }
+}
+
+/**
+ * @brief [internal] Find the next timeout tick of the wheel, the interrupt is disabled
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param timeout_tick is the next timer's ticks
+ *
+ * @return RT_EOK if the wheel has a timer, -RT_ERROR if it is empty
+ */
+static rt_err_t _timer_wheel_earliest(struct _timer_wheel *wheel, rt_tick_t *timeout_tick)
+{
+    rt_uint32_t index, start;
+    rt_tick_t expires, next = 0;
+    rt_bool_t found = RT_FALSE;
+    rt_list_t *node;
+    int lvl, n;
+
+    for (lvl = 0; lvl < _WHEEL_LEVELS; lvl++)
+    {
+        if (wheel->bitmap[lvl] == 0)
+            continue;
+
+        /* once cascaded, the current slot of an upper level holds the next round */
+        start = _WHEEL_INDEX(wheel->now, lvl);
+        if (wheel->now & ((1UL << (lvl * RT_TIMER_WHEEL_SLOT_BITS)) - 1))
+            start ++;
+        for (n = 0; n < _WHEEL_SLOTS; n++)
+        {
+            index = (start + n) & _WHEEL_MASK;
+            if (!(wheel->bitmap[lvl] & (1UL << index)) ||
+                rt_list_isempty(&wheel->slot[lvl][index]))
+                continue;
+
+            for (node = wheel->slot[lvl][index].next;
+                 node != &wheel->slot[lvl][index];
+                 node = node->next)
+            {
+                expires = _WHEEL_TIMER(node)->timeout_tick;
+                if ((expires - wheel->now) >= RT_TICK_MAX / 2)
+                    expires = wheel->now;
+                if (!found || (expires - wheel->now) < (next - wheel->now))
+                {
+                    next  = expires;
+                    found = RT_TRUE;
+                }
+            }
+            break;
+        }
+    }
+
+    if (!found)
+        return -RT_ERROR;
+
+    *timeout_tick = next;
+    return RT_EOK;
+}
+
+/**
+ * @brief [internal] Move the wheel to a tick at once, all the timers are inserted again
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param now is the next tick to be run, no timer shall timeout before it
+ */
+static void _timer_wheel_rebase(struct _timer_wheel *wheel, rt_tick_t now)
+{
+    rt_list_t list;
+    rt_timer_t t;
+    int lvl, index;
+
+    rt_list_init(&list);
+    for (lvl = 0; lvl < _WHEEL_LEVELS; lvl++)
+    {
+        for (index = 0; index < _WHEEL_SLOTS; index++)
+        {
+            if (wheel->bitmap[lvl] & (1UL << index))
+                _timer_wheel_splice(&list, &wheel->slot[lvl][index]);
+        }
+        wheel->bitmap[lvl] = 0;
+    }
+
+    wheel->now = now;
+    while (!rt_list_isempty(&list))
+    {
+        t = _WHEEL_TIMER(list.next);
+        rt_list_remove(_WHEEL_NODE(t));
+        _timer_wheel_insert(wheel, t);
+    }
+}
+
+/**
+ * @brief [internal] Advance the wheel to the current tick until a batch of
+ *        timers is timeout. The ticks without timer are skipped.
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param current_tick is the current tick
+ *
+ * @param expired is the list to receive the timeout timers
+ *
+ * @return RT_TRUE if some timers are moved to the expired list
+ */
+static rt_bool_t _timer_wheel_advance(struct _timer_wheel *wheel, rt_tick_t current_tick,
+                                      rt_list_t *expired)
+{
+    rt_tick_t tick, next;
+    rt_uint32_t index, slot;
+    int lvl;
+
+    /*
+     * The tick jumped over many rounds, e.g. by rt_tick_set(). Go to the first
+     * timeout at once instead of walking the ticks between, the cost is bound
+     * by the timers and not by the jump.
+     */
+    tick = current_tick - wheel->now;
+    if (tick >= _WHEEL_JUMP && tick < RT_TICK_MAX / 2)
+    {
+        if (_timer_wheel_earliest(wheel, &next) != RT_EOK || (current_tick - next) >= RT_TICK_MAX / 2)
+            next = current_tick;
+        _timer_wheel_rebase(wheel, next);
+    }
+
+    while ((current_tick - wheel->now) < RT_TICK_MAX / 2)
+    {
+        tick  = wheel->now;
+        index = tick & _WHEEL_MASK;
+
+        if (index == 0)
+        {
+            /* level 0 wraps around, cascade the upper levels */
+            for (lvl = 1; lvl < _WHEEL_LEVELS; lvl++)
+            {
+                slot = _WHEEL_INDEX(tick, lvl);
+                if (wheel->bitmap[lvl] & (1UL << slot))
+                {
+                    _timer_wheel_cascade(wheel, lvl, slot);
+                }
+                if (slot != 0)
+                    break;
+            }
+        }
+        else if (wheel->bitmap[0] == 0)
+        {
+            /* nothing on level 0, skip to the next cascade */
+            tick = (tick | _WHEEL_MASK) + 1;
+            if ((current_tick - tick) >= RT_TICK_MAX / 2)
+                tick = current_tick + 1;
+            wheel->now = tick;
+            continue;
+        }
+
+        wheel->now = tick + 1;
+        if (wheel->bitmap[0] & (1UL << index))
+        {
+            wheel->bitmap[0] &= ~(1UL << index);
+            if (!rt_list_isempty(&wheel->slot[0][index]))
+            {
+                _timer_wheel_splice(expired, &wheel->slot[0][index]);
+                return RT_TRUE;
+            }
+        }
+    }
+
+    return RT_FALSE;
+}
+
+/**
+ * @brief [internal] Get the next timeout timer of the wheel
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param expired is the list of the timeout timers being run
+ *
+ * @param current_tick is the current tick
+ *
+ * @return the timeout timer, RT_NULL if there is none
+ */
+rt_inline struct rt_timer *_timer_wheel_next_expired(struct _timer_wheel *wheel, rt_list_t *expired,
+                                                     rt_tick_t current_tick)
+{
+    if (rt_list_isempty(expired) && !_timer_wheel_advance(wheel, current_tick, expired))
+        return RT_NULL;
+
+    return _WHEEL_TIMER(expired->next);
+}
+
+/**
+ * @brief  Find the next timeout tick of the wheel
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param timeout_tick is the next timer's ticks
+ *
+ * @return  Return the operation status. If the return value is RT_EOK, the function is successfully executed.
+ *          If the return value is any other values, it means this operation failed.
+ */
+static rt_err_t _timer_wheel_next_timeout(struct _timer_wheel *wheel, rt_tick_t *timeout_tick)
+{
+    register rt_base_t level;
+    rt_err_t result;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    result = _timer_wheel_earliest(wheel, timeout_tick);
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+#endif /* RT_TIMER_USING_WHEEL */
+
 /**
  * @brief Remove the timer
  *
@@ -396,13 +772,17 @@ RTM_EXPORT(rt_timer_delete);
  */
 rt_err_t rt_timer_start(rt_timer_t timer)
 {
-    unsigned int row_lvl;
-    rt_list_t *timer_list;
     register rt_base_t level;
     register rt_bool_t need_schedule;
+#ifdef RT_TIMER_USING_WHEEL
+    struct _timer_wheel *wheel;
+#else
+    unsigned int row_lvl;
+    rt_list_t *timer_list;
     rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
     unsigned int tst_nr;
     static unsigned int random_nr;
+#endif /* RT_TIMER_USING_WHEEL */
 
     /* parameter check */
     RT_ASSERT(timer != RT_NULL);
@@ -421,6 +801,22 @@ rt_err_t rt_timer_start(rt_timer_t timer)
 
     timer->timeout_tick = rt_tick_get() + timer->init_tick;
 
+#ifdef RT_TIMER_USING_WHEEL
+#ifdef RT_USING_TIMER_SOFT
+    if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
+    {
+        /* insert timer to soft timer wheel */
+        wheel = &_soft_timer_wheel;
+    }
+    else
+#endif /* RT_USING_TIMER_SOFT */
+    {
+        /* insert timer to system timer wheel */
+        wheel = &_timer_wheel;
+    }
+
+    _timer_wheel_insert(wheel, timer);
+#else
 #ifdef RT_USING_TIMER_SOFT
     if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
     {
@@ -484,6 +880,7 @@ rt_err_t rt_timer_start(rt_timer_t timer)
          * bits. */
         tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
     }
+#endif /* RT_TIMER_USING_WHEEL */
 
     timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
 
@@ -620,6 +1017,11 @@ void rt_timer_check(void)
     rt_tick_t current_tick;
     register rt_base_t level;
     rt_list_t list;
+#ifdef RT_TIMER_USING_WHEEL
+    rt_list_t expired;
+
+    rt_list_init(&expired);
+#endif /* RT_TIMER_USING_WHEEL */
 
     rt_list_init(&list);
 
@@ -630,51 +1032,44 @@ void rt_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    while (!rt_list_isempty(&_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+#ifdef RT_TIMER_USING_WHEEL
+    while ((t = _timer_wheel_next_expired(&_timer_wheel, &expired, current_tick)) != RT_NULL)
+#else
+    while ((t = _timer_list_next_expired(_timer_list, current_tick)) != RT_NULL)
+#endif /* RT_TIMER_USING_WHEEL */
     {
-        t = rt_list_entry(_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                          struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        /* remove timer from timer list firstly */
+        _timer_remove(t);
+        if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
         {
-            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
-
-            /* remove timer from timer list firstly */
-            _timer_remove(t);
-            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
-            {
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-            }
-            /* add timer to temporary list  */
-            rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            /* call timeout function */
-            t->timeout_func(t->parameter);
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        /* add timer to temporary list  */
+        rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        /* call timeout function */
+        t->timeout_func(t->parameter);
 
-            /* re-get tick */
-            current_tick = rt_tick_get();
+        /* re-get tick */
+        current_tick = rt_tick_get();
 
-            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
-            RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
 
-            /* Check whether the timer object is detached or started again */
-            if (rt_list_isempty(&list))
-            {
-                continue;
-            }
-            rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
-                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
-            {
-                /* start it */
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-                rt_timer_start(t);
-            }
+        /* Check whether the timer object is detached or started again */
+        if (rt_list_isempty(&list))
+        {
+            continue;
+        }
+        rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+            (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
         }
-        else break;
     }
 
     /* enable interrupt */
@@ -691,7 +1086,11 @@ void rt_timer_check(void)
 rt_tick_t rt_timer_next_timeout_tick(void)
 {
     rt_tick_t next_timeout = RT_TICK_MAX;
+#ifdef RT_TIMER_USING_WHEEL
+    _timer_wheel_next_timeout(&_timer_wheel, &next_timeout);
+#else
     _timer_list_next_timeout(_timer_list, &next_timeout);
+#endif /* RT_TIMER_USING_WHEEL */
     return next_timeout;
 }
 
@@ -706,6 +1105,11 @@ void rt_soft_timer_check(void)
     struct rt_timer *t;
     register rt_base_t level;
     rt_list_t list;
+#ifdef RT_TIMER_USING_WHEEL
+    rt_list_t expired;
+
+    rt_list_init(&expired);
+#endif /* RT_TIMER_USING_WHEEL */
 
     rt_list_init(&list);
 
@@ -714,59 +1118,54 @@ void rt_soft_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    while (!rt_list_isempty(&_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    current_tick = rt_tick_get();
+#ifdef RT_TIMER_USING_WHEEL
+    while ((t = _timer_wheel_next_expired(&_soft_timer_wheel, &expired, current_tick)) != RT_NULL)
+#else
+    while ((t = _timer_list_next_expired(_soft_timer_list, current_tick)) != RT_NULL)
+#endif /* RT_TIMER_USING_WHEEL */
     {
-        t = rt_list_entry(_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                            struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
-
-        current_tick = rt_tick_get();
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        /* remove timer from timer list firstly */
+        _timer_remove(t);
+        if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
         {
-            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        /* add timer to temporary list  */
+        rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
 
-            /* remove timer from timer list firstly */
-            _timer_remove(t);
-            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
-            {
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-            }
-            /* add timer to temporary list  */
-            rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        _soft_timer_status = RT_SOFT_TIMER_BUSY;
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
 
-            _soft_timer_status = RT_SOFT_TIMER_BUSY;
-            /* enable interrupt */
-            rt_hw_interrupt_enable(level);
+        /* call timeout function */
+        t->timeout_func(t->parameter);
 
-            /* call timeout function */
-            t->timeout_func(t->parameter);
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
 
-            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
-            RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
 
-            /* disable interrupt */
-            level = rt_hw_interrupt_disable();
+        /* re-get tick */
+        current_tick = rt_tick_get();
 
-            _soft_timer_status = RT_SOFT_TIMER_IDLE;
-            /* Check whether the timer object is detached or started again */
-            if (rt_list_isempty(&list))
-            {
-                continue;
-            }
-            rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
-                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
-            {
-                /* start it */
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-                rt_timer_start(t);
-            }
+        _soft_timer_status = RT_SOFT_TIMER_IDLE;
+        /* Check whether the timer object is detached or started again */
+        if (rt_list_isempty(&list))
+        {
+            continue;
+        }
+        rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+            (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
         }
-        else break; /* not check anymore */
     }
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
@@ -786,7 +1185,11 @@ static void _timer_thread_entry(void *parameter)
     while (1)
     {
         /* get the next timeout tick */
+#ifdef RT_TIMER_USING_WHEEL
+        if (_timer_wheel_next_timeout(&_soft_timer_wheel, &next_timeout) != RT_EOK)
+#else
         if (_timer_list_next_timeout(_soft_timer_list, &next_timeout) != RT_EOK)
+#endif /* RT_TIMER_USING_WHEEL */
         {
             /* no software timer exist, suspend self. */
             rt_thread_suspend(rt_thread_self());
@@ -820,12 +1223,16 @@ static void _timer_thread_entry(void *parameter)
  */
 void rt_system_timer_init(void)
 {
+#ifdef RT_TIMER_USING_WHEEL
+    _timer_wheel_init(&_timer_wheel);
+#else
     int i;
 
     for (i = 0; i < sizeof(_timer_list) / sizeof(_timer_list[0]); i++)
     {
         rt_list_init(_timer_list + i);
     }
+#endif /* RT_TIMER_USING_WHEEL */
 }
 
 /**
@@ -836,6 +1243,9 @@ void rt_system_timer_init(void)
 void rt_system_timer_thread_init(void)
 {
 #ifdef RT_USING_TIMER_SOFT
+#ifdef RT_TIMER_USING_WHEEL
+    _timer_wheel_init(&_soft_timer_wheel);
+#else
     int i;
 
     for (i = 0;
@@ -844,6 +1254,7 @@ void rt_system_timer_thread_init(void)
     {
         rt_list_init(_soft_timer_list + i);
     }
+#endif /* RT_TIMER_USING_WHEEL */
 
     /* start software timer thread */
     rt_thread_init(&_timer_thread,
@@ -861,3 +1272,158 @@ void rt_system_timer_thread_init(void)
 }
 
 /**@}*/
+
+#if defined(RT_USING_FINSH) && defined(RT_TIMER_USING_BENCH)
+#include <finsh.h>
+#include <stdlib.h>
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()            ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT             "cycles"
+#else
+#define _BENCH_NOW()            ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT             "ticks"
+#endif /* RT_USING_CPUTIME */
+
+#define _BENCH_PROBES           256
+#define _BENCH_FAR_TICKS        (RT_TICK_PER_SECOND * 60)
+
+static volatile rt_uint32_t _bench_fired;
+static volatile rt_uint32_t _bench_first;
+static volatile rt_uint32_t _bench_last;
+
+static void _bench_timeout(void *parameter)
+{
+    rt_uint32_t now = _BENCH_NOW();
+
+    if (_bench_fired == 0)
+        _bench_first = now;
+    _bench_last = now;
+    _bench_fired ++;
+}
+
+static rt_tick_t _bench_far_tick(rt_uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return _BENCH_FAR_TICKS + ((*seed >> 16) & 0x7fff) % _BENCH_FAR_TICKS;
+}
+
+static void _bench_timer_init(rt_timer_t timer)
+{
+    /* not put in the object container, the setup shall not walk the timer objects */
+    rt_memset(timer, 0, sizeof(struct rt_timer));
+    timer->parent.type = RT_Object_Class_Timer | RT_Object_Class_Static;
+    _timer_init(timer, _bench_timeout, RT_NULL, 0,
+                RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+}
+
+static int _bench_run(int count)
+{
+    struct rt_timer *timers, probe;
+    rt_uint32_t start_total = 0, start_worst = 0, stop_total = 0, stop_worst = 0;
+    rt_uint32_t seed = 0x2017, t0, dt;
+    rt_tick_t deadline, now;
+    rt_base_t level;
+    int i, late = 0;
+
+    timers = (struct rt_timer *)rt_malloc(count * sizeof(struct rt_timer));
+    if (timers == RT_NULL)
+    {
+        rt_kprintf("no memory for %d timers\n", count);
+        return -RT_ENOMEM;
+    }
+
+    /* active timers, far enough not to timeout during the test */
+    for (i = 0; i < count; i ++)
+    {
+        _bench_timer_init(&timers[i]);
+        timers[i].init_tick = _bench_far_tick(&seed);
+        rt_timer_start(&timers[i]);
+    }
+
+    _bench_timer_init(&probe);
+    for (i = 0; i < _BENCH_PROBES; i ++)
+    {
+        probe.init_tick = _bench_far_tick(&seed);
+
+        t0 = _BENCH_NOW();
+        rt_timer_start(&probe);
+        dt = _BENCH_NOW() - t0;
+        start_total += dt;
+        if (dt > start_worst)
+            start_worst = dt;
+
+        t0 = _BENCH_NOW();
+        rt_timer_stop(&probe);
+        dt = _BENCH_NOW() - t0;
+        stop_total += dt;
+        if (dt > stop_worst)
+            stop_worst = dt;
+    }
+
+    /* re-arm all of them to timeout on the same tick */
+    for (i = 0; i < count; i ++)
+    {
+        rt_timer_stop(&timers[i]);
+    }
+    _bench_fired = 0;
+    deadline = rt_tick_get() + count + 10;
+    for (i = 0; i < count; i ++)
+    {
+        level = rt_hw_interrupt_disable();
+        now = rt_tick_get();
+        if ((deadline - now) >= RT_TICK_MAX / 2)
+            late ++;
+        timers[i].init_tick = deadline - now;
+        rt_timer_start(&timers[i]);
+        rt_hw_interrupt_enable(level);
+    }
+    while (_bench_fired < count && (rt_tick_get() - deadline) >= RT_TICK_MAX / 2)
+    {
+        rt_thread_mdelay(10);
+    }
+    rt_thread_mdelay(10);
+
+    for (i = 0; i < count; i ++)
+    {
+        rt_timer_stop(&timers[i]);
+    }
+    rt_free(timers);
+
+    rt_kprintf("%-8d %-8d %-8d %-8d %-8d %-8d\n", count,
+               start_total / _BENCH_PROBES, start_worst,
+               stop_total / _BENCH_PROBES, stop_worst,
+               _bench_fired > 1 ? (_bench_last - _bench_first) / (_bench_fired - 1) : 0);
+    if (late || _bench_fired != count)
+    {
+        rt_kprintf("%d of %d timers timeout, %d armed late\n", _bench_fired, count, late);
+    }
+
+    return RT_EOK;
+}
+
+int timer_bench(int argc, char **argv)
+{
+    int count, max = 10000;
+
+    if (argc > 1)
+        max = atoi(argv[1]);
+
+#ifdef RT_TIMER_USING_WHEEL
+    rt_kprintf("timing wheel, %d slots per level, time in %s\n", _WHEEL_SLOTS, _BENCH_UNIT);
+#else
+    rt_kprintf("skip list, %d levels, time in %s\n", RT_TIMER_SKIP_LIST_LEVEL, _BENCH_UNIT);
+#endif /* RT_TIMER_USING_WHEEL */
+    rt_kprintf("timers   start    worst    stop     worst    timeout\n");
+    rt_kprintf("-------- -------- -------- -------- -------- --------\n");
+
+    for (count = 10; count <= max; count *= 10)
+    {
+        if (_bench_run(count) != RT_EOK)
+            break;
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(timer_bench, measure timer start stop and timeout cost: timer_bench [max timers]);
+#endif /* defined(RT_USING_FINSH) && defined(RT_TIMER_USING_BENCH) */
@@ -0,0 +1,896 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first version
+ */
+
+/*
+ * TLSF (Two-Level Segregated Fit) memory allocator.
+ *
+ * Free blocks are kept in segregated lists indexed by a two level bitmap:
+ * the first level splits block sizes into power of two classes and the
+ * second level splits every class linearly into RT_TLSF_SL_INDEX_COUNT_LOG2
+ * sub ranges. Finding a suitable free block is two bit scans, and freeing a
+ * block merges it with its physical neighbours in constant time, so both
+ * allocation and release have a bounded worst case that does not depend on
+ * the number of blocks or on heap fragmentation.
+ *
+ * The algorithm is described in:
+ *   M. Masmano, I. Ripoll, A. Crespo, J. Real,
+ *   "TLSF: a New Dynamic Memory Allocator for Real-Time Systems", ECRTS 2004.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_TLSF)
+
+#ifndef RT_TLSF_SL_INDEX_COUNT_LOG2
+#define RT_TLSF_SL_INDEX_COUNT_LOG2     4
+#endif
+
+#define TLSF_SL_COUNT           (1UL << RT_TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_FL_COUNT_MAX       32
+
+/* block flags kept in the low bits of the size field */
+#define TLSF_BLOCK_FREE         0x01
+#define TLSF_BLOCK_PREV_FREE    0x02
+#define TLSF_BLOCK_FLAGS        (TLSF_BLOCK_FREE | TLSF_BLOCK_PREV_FREE)
+
+/**
+ * block header of the tlsf memory
+ *
+ * The prev_phys field overlaps the last word of the previous block, it is
+ * only valid while the previous block is free. A used block costs the size
+ * field only.
+ */
+struct rt_tlsf_block
+{
+    struct rt_tlsf_block   *prev_phys;      /**< previous physical block, valid if it is free */
+    rt_size_t               size;           /**< payload size and block flags */
+};
+
+/**
+ * free list links stored in the payload of a free block
+ */
+struct rt_tlsf_link
+{
+    struct rt_tlsf_block   *next_free;      /**< next free block in the same list */
+    struct rt_tlsf_block   *prev_free;      /**< prev free block in the same list */
+};
+
+/**
+ * Base structure of tlsf memory object
+ */
+struct rt_tlsf
+{
+    struct rt_memory        parent;         /**< inherit from rt_memory */
+    rt_uint32_t             fl_bitmap;      /**< first level bitmap */
+    rt_uint32_t            *sl_bitmap;      /**< second level bitmaps, one per first level */
+    struct rt_tlsf_block  **blocks;         /**< free list heads [fl_count][TLSF_SL_COUNT] */
+    rt_uint8_t              fl_count;       /**< number of first level classes */
+    rt_uint8_t              fl_shift;       /**< log2 of the smallest first level class */
+    rt_size_t               free_blocks;    /**< number of blocks in the free lists */
+    rt_uint8_t             *pool_start;     /**< first block of the pool */
+    rt_uint8_t             *pool_end;       /**< end of the pool */
+};
+
+#define TLSF_OVERHEAD           RT_ALIGN(sizeof(rt_size_t), RT_ALIGN_SIZE)
+#define TLSF_PREV_SIZE          sizeof(struct rt_tlsf_block *)
+#define TLSF_BLOCK_SIZE_MIN     RT_ALIGN(sizeof(struct rt_tlsf_link) + TLSF_PREV_SIZE, RT_ALIGN_SIZE)
+
+#define TLSF_BLOCK_SIZE(_b)     ((_b)->size & ~(rt_size_t)TLSF_BLOCK_FLAGS)
+#define TLSF_IS_FREE(_b)        ((_b)->size & TLSF_BLOCK_FREE)
+#define TLSF_IS_PREV_FREE(_b)   ((_b)->size & TLSF_BLOCK_PREV_FREE)
+#define TLSF_TO_PTR(_b)         ((void *)((rt_uint8_t *)(_b) + TLSF_PREV_SIZE + TLSF_OVERHEAD))
+#define TLSF_FROM_PTR(_p)       ((struct rt_tlsf_block *)((rt_uint8_t *)(_p) - TLSF_PREV_SIZE - TLSF_OVERHEAD))
+#define TLSF_LINK(_b)           ((struct rt_tlsf_link *)TLSF_TO_PTR(_b))
+
+/* index of the most significant bit set, -1 if word is zero */
+rt_inline int _tlsf_fls(rt_size_t word)
+{
+    int bit = 0;
+
+    if (word == 0)
+        return -1;
+
+#ifdef ARCH_CPU_64BIT
+    if (word & 0xffffffff00000000UL) { word >>= 32; bit += 32; }
+#endif /* ARCH_CPU_64BIT */
+    if (word & 0xffff0000) { word >>= 16; bit += 16; }
+    if (word & 0xff00)     { word >>= 8;  bit += 8;  }
+    if (word & 0xf0)       { word >>= 4;  bit += 4;  }
+    if (word & 0xc)        { word >>= 2;  bit += 2;  }
+    if (word & 0x2)        { bit += 1; }
+
+    return bit;
+}
+
+/* index of the least significant bit set, the word must not be zero */
+rt_inline int _tlsf_ffs(rt_uint32_t word)
+{
+    return __rt_ffs((int)word) - 1;
+}
+
+rt_inline struct rt_tlsf_block *_tlsf_next_phys(struct rt_tlsf_block *block)
+{
+    return (struct rt_tlsf_block *)((rt_uint8_t *)TLSF_TO_PTR(block) +
+                                    TLSF_BLOCK_SIZE(block) - TLSF_PREV_SIZE);
+}
+
+rt_inline struct rt_tlsf_block *_tlsf_link_next(struct rt_tlsf_block *block)
+{
+    struct rt_tlsf_block *next = _tlsf_next_phys(block);
+
+    next->prev_phys = block;
+    return next;
+}
+
+rt_inline void _tlsf_mark_free(struct rt_tlsf_block *block)
+{
+    struct rt_tlsf_block *next = _tlsf_link_next(block);
+
+    next->size |= TLSF_BLOCK_PREV_FREE;
+    block->size |= TLSF_BLOCK_FREE;
+}
+
+rt_inline void _tlsf_mark_used(struct rt_tlsf_block *block)
+{
+    struct rt_tlsf_block *next = _tlsf_next_phys(block);
+
+    next->size &= ~(rt_size_t)TLSF_BLOCK_PREV_FREE;
+    block->size &= ~(rt_size_t)TLSF_BLOCK_FREE;
+}
+
+/* size to the list which holds blocks of this size */
+rt_inline void _tlsf_mapping_insert(struct rt_tlsf *tlsf, rt_size_t size, int *fl, int *sl)
+{
+    int f;
+
+    if (size < ((rt_size_t)1 << tlsf->fl_shift))
+    {
+        *fl = 0;
+        *sl = (int)(size >> (tlsf->fl_shift - RT_TLSF_SL_INDEX_COUNT_LOG2));
+    }
+    else
+    {
+        f = _tlsf_fls(size);
+        *sl = (int)((size >> (f - RT_TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_COUNT);
+        *fl = f - tlsf->fl_shift + 1;
+    }
+}
+
+/* size to the first list whose blocks are all large enough */
+rt_inline void _tlsf_mapping_search(struct rt_tlsf *tlsf, rt_size_t size, int *fl, int *sl)
+{
+    if (size >= ((rt_size_t)1 << tlsf->fl_shift))
+    {
+        size += ((rt_size_t)1 << (_tlsf_fls(size) - RT_TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    _tlsf_mapping_insert(tlsf, size, fl, sl);
+}
+
+static struct rt_tlsf_block *_tlsf_search_suitable(struct rt_tlsf *tlsf, int *fl, int *sl)
+{
+    rt_uint32_t sl_map, fl_map;
+
+    if (*fl >= tlsf->fl_count)
+        return RT_NULL;
+
+    sl_map = tlsf->sl_bitmap[*fl] & (~(rt_uint32_t)0 << *sl);
+    if (!sl_map)
+    {
+        /* no block in this class, look at the next larger classes */
+        fl_map = (*fl + 1 < TLSF_FL_COUNT_MAX) ? tlsf->fl_bitmap & (~(rt_uint32_t)0 << (*fl + 1)) : 0;
+        if (!fl_map)
+            return RT_NULL;
+
+        *fl = _tlsf_ffs(fl_map);
+        sl_map = tlsf->sl_bitmap[*fl];
+    }
+    *sl = _tlsf_ffs(sl_map);
+
+    return tlsf->blocks[*fl * TLSF_SL_COUNT + *sl];
+}
+
+static void _tlsf_insert_free(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    int fl, sl;
+    struct rt_tlsf_block **head;
+
+    _tlsf_mapping_insert(tlsf, TLSF_BLOCK_SIZE(block), &fl, &sl);
+    head = &tlsf->blocks[fl * TLSF_SL_COUNT + sl];
+
+    TLSF_LINK(block)->next_free = *head;
+    TLSF_LINK(block)->prev_free = RT_NULL;
+    if (*head)
+        TLSF_LINK(*head)->prev_free = block;
+    *head = block;
+
+    tlsf->fl_bitmap |= (1UL << fl);
+    tlsf->sl_bitmap[fl] |= (1UL << sl);
+    tlsf->free_blocks ++;
+}
+
+static void _tlsf_remove_free(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    int fl, sl;
+    struct rt_tlsf_block *next, *prev;
+
+    _tlsf_mapping_insert(tlsf, TLSF_BLOCK_SIZE(block), &fl, &sl);
+    next = TLSF_LINK(block)->next_free;
+    prev = TLSF_LINK(block)->prev_free;
+
+    if (next)
+        TLSF_LINK(next)->prev_free = prev;
+    if (prev)
+    {
+        TLSF_LINK(prev)->next_free = next;
+    }
+    else
+    {
+        tlsf->blocks[fl * TLSF_SL_COUNT + sl] = next;
+        if (next == RT_NULL)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+            if (tlsf->sl_bitmap[fl] == 0)
+                tlsf->fl_bitmap &= ~(1UL << fl);
+        }
+    }
+    tlsf->free_blocks --;
+}
+
+/* cut the tail of the block off as a new block, the tail is left unlinked */
+rt_inline struct rt_tlsf_block *_tlsf_split(struct rt_tlsf_block *block, rt_size_t size)
+{
+    struct rt_tlsf_block *remain;
+
+    remain = (struct rt_tlsf_block *)((rt_uint8_t *)TLSF_TO_PTR(block) + size - TLSF_PREV_SIZE);
+    remain->size = TLSF_BLOCK_SIZE(block) - size - TLSF_OVERHEAD;
+    block->size = size | (block->size & TLSF_BLOCK_FLAGS);
+
+    return remain;
+}
+
+rt_inline rt_bool_t _tlsf_can_split(struct rt_tlsf_block *block, rt_size_t size)
+{
+    return TLSF_BLOCK_SIZE(block) >= size + TLSF_OVERHEAD + TLSF_BLOCK_SIZE_MIN;
+}
+
+/* merge a free block with its next physical block if that one is free too */
+static struct rt_tlsf_block *_tlsf_merge_next(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    struct rt_tlsf_block *next = _tlsf_next_phys(block);
+
+    if (TLSF_IS_FREE(next))
+    {
+        _tlsf_remove_free(tlsf, next);
+        block->size += TLSF_BLOCK_SIZE(next) + TLSF_OVERHEAD;
+        _tlsf_link_next(block);
+    }
+
+    return block;
+}
+
+/* give the unused tail of a used block back to the free lists */
+static void _tlsf_trim_used(struct rt_tlsf *tlsf, struct rt_tlsf_block *block, rt_size_t size)
+{
+    struct rt_tlsf_block *remain;
+
+    if (_tlsf_can_split(block, size))
+    {
+        remain = _tlsf_split(block, size);
+        _tlsf_mark_free(remain);
+        remain = _tlsf_merge_next(tlsf, remain);
+        _tlsf_insert_free(tlsf, remain);
+    }
+}
+
+/* aligned block size for a request, 0 if it can never be satisfied */
+rt_inline rt_size_t _tlsf_adjust_size(struct rt_tlsf *tlsf, rt_size_t size)
+{
+    if (size == 0 || size > tlsf->parent.total)
+        return 0;
+
+    size = RT_ALIGN(size, RT_ALIGN_SIZE);
+    return size < TLSF_BLOCK_SIZE_MIN ? TLSF_BLOCK_SIZE_MIN : size;
+}
+
+/**
+ * @brief This function will initialize tlsf memory management algorithm.
+ *
+ * @note The control structure and the free list table are placed at the
+ *       beginning of the memory, the table is sized from the memory size.
+ *
+ * @param name is the name of the tlsf memory management object.
+ *
+ * @param begin_addr the beginning address of memory.
+ *
+ * @param size is the size of the memory.
+ *
+ * @return Return a pointer to the memory object. When the return value is RT_NULL, it means the init failed.
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block, *tail;
+    rt_ubase_t end_align, begin_align, table_addr;
+    rt_size_t pool_size;
+    int fl_shift, fl_count;
+
+    tlsf = (struct rt_tlsf *)RT_ALIGN((rt_ubase_t)begin_addr, RT_ALIGN_SIZE);
+    end_align = RT_ALIGN_DOWN((rt_ubase_t)begin_addr + size, RT_ALIGN_SIZE);
+
+    /* the smallest first level class holds TLSF_SL_COUNT sizes of RT_ALIGN_SIZE step */
+    fl_shift = RT_TLSF_SL_INDEX_COUNT_LOG2 + _tlsf_fls(RT_ALIGN_SIZE);
+    if (end_align > (rt_ubase_t)tlsf && end_align - (rt_ubase_t)tlsf >= ((rt_size_t)1 << fl_shift))
+        fl_count = _tlsf_fls(end_align - (rt_ubase_t)tlsf) - fl_shift + 2;
+    else
+        fl_count = 1;
+    if (fl_count > TLSF_FL_COUNT_MAX)
+        fl_count = TLSF_FL_COUNT_MAX;
+
+    /* control structure, bitmaps and list heads are followed by the pool */
+    table_addr  = RT_ALIGN((rt_ubase_t)tlsf + sizeof(*tlsf) + fl_count * sizeof(rt_uint32_t), sizeof(void *));
+    begin_align = RT_ALIGN(table_addr + fl_count * TLSF_SL_COUNT * sizeof(struct rt_tlsf_block *) + TLSF_PREV_SIZE,
+                           RT_ALIGN_SIZE);
+
+    if ((end_align > begin_align) &&
+        (end_align - begin_align >= 2 * TLSF_OVERHEAD + TLSF_BLOCK_SIZE_MIN))
+    {
+        pool_size = RT_ALIGN_DOWN(end_align - begin_align - 2 * TLSF_OVERHEAD, RT_ALIGN_SIZE);
+        if (fl_count == TLSF_FL_COUNT_MAX &&
+            pool_size >= ((rt_size_t)1 << (TLSF_FL_COUNT_MAX + fl_shift - 1)))
+        {
+            pool_size = ((rt_size_t)1 << (TLSF_FL_COUNT_MAX + fl_shift - 1)) - RT_ALIGN_SIZE;
+        }
+    }
+    else
+    {
+        rt_kprintf("tlsf init, error begin address 0x%x, and end address 0x%x\n",
+                   (rt_ubase_t)begin_addr, (rt_ubase_t)begin_addr + size);
+
+        return RT_NULL;
+    }
+
+    rt_memset(tlsf, 0, begin_align - (rt_ubase_t)tlsf);
+    /* initialize tlsf memory object */
+    rt_object_init(&(tlsf->parent.parent), RT_Object_Class_Memory, name);
+    tlsf->parent.algorithm = "tlsf";
+    tlsf->parent.address = begin_align;
+    tlsf->parent.total = pool_size;
+    tlsf->sl_bitmap = (rt_uint32_t *)((rt_ubase_t)tlsf + sizeof(*tlsf));
+    tlsf->blocks = (struct rt_tlsf_block **)table_addr;
+    tlsf->fl_count = (rt_uint8_t)fl_count;
+    tlsf->fl_shift = (rt_uint8_t)fl_shift;
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("tlsf init, heap begin address 0x%x, size %d, fl %d, sl %d\n",
+                                begin_align, pool_size, fl_count, TLSF_SL_COUNT));
+
+    /* the whole pool is one free block, its prev_phys is never used */
+    block = (struct rt_tlsf_block *)(begin_align - TLSF_PREV_SIZE);
+    block->size = pool_size;
+    tlsf->pool_start = (rt_uint8_t *)block;
+
+    /* a zero sized used block terminates the pool */
+    tail = _tlsf_link_next(block);
+    tail->size = 0;
+    tlsf->pool_end = (rt_uint8_t *)tail;
+
+    _tlsf_mark_free(block);
+    _tlsf_insert_free(tlsf, block);
+
+    return &tlsf->parent;
+}
+RTM_EXPORT(rt_tlsf_init);
+
+/**
+ * @brief This function will remove a tlsf memory from the system.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_tlsf_detach(rt_tlsf_t m)
+{
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    rt_object_detach(&(m->parent));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_tlsf_detach);
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * @brief Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return the pointer to allocated memory or NULL if no free memory was found.
+ */
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size)
+{
+    int fl, sl;
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block, *remain;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf *)m;
+    size = _tlsf_adjust_size(tlsf, size);
+    if (size == 0)
+        return RT_NULL;
+
+    _tlsf_mapping_search(tlsf, size, &fl, &sl);
+    block = _tlsf_search_suitable(tlsf, &fl, &sl);
+    if (block == RT_NULL)
+    {
+        /* last resort before failing: a block of the exact class may still fit */
+        _tlsf_mapping_insert(tlsf, size, &fl, &sl);
+        for (block = tlsf->blocks[fl * TLSF_SL_COUNT + sl]; block; block = TLSF_LINK(block)->next_free)
+        {
+            if (TLSF_BLOCK_SIZE(block) >= size)
+                break;
+        }
+    }
+    if (block == RT_NULL)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("no memory\n"));
+
+        return RT_NULL;
+    }
+    RT_ASSERT(TLSF_BLOCK_SIZE(block) >= size);
+
+    _tlsf_remove_free(tlsf, block);
+    if (_tlsf_can_split(block, size))
+    {
+        remain = _tlsf_split(block, size);
+        _tlsf_mark_free(remain);
+        _tlsf_insert_free(tlsf, remain);
+    }
+    _tlsf_mark_used(block);
+
+    tlsf->parent.used += TLSF_BLOCK_SIZE(block) + TLSF_OVERHEAD;
+    if (tlsf->parent.max < tlsf->parent.used)
+        tlsf->parent.max = tlsf->parent.used;
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("allocate memory at 0x%x, size: %d\n",
+                                (rt_ubase_t)TLSF_TO_PTR(block), TLSF_BLOCK_SIZE(block)));
+
+    return TLSF_TO_PTR(block);
+}
+RTM_EXPORT(rt_tlsf_alloc);
+
+/**
+ * @brief This function will change the size of previously allocated memory block.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param rmem is the pointer to memory allocated by rt_tlsf_alloc.
+ *
+ * @param newsize is the required new size.
+ *
+ * @return the changed memory block address.
+ */
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block, *next;
+    rt_size_t size, adjust, combined;
+    void *nmem;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf *)m;
+    if (rmem == RT_NULL)
+        return rt_tlsf_alloc(m, newsize);
+
+    if (newsize == 0)
+    {
+        rt_tlsf_free(m, rmem);
+        return RT_NULL;
+    }
+
+    adjust = _tlsf_adjust_size(tlsf, newsize);
+    if (adjust == 0)
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("realloc: out of memory\n"));
+
+        return RT_NULL;
+    }
+
+    block = TLSF_FROM_PTR(rmem);
+    RT_ASSERT(!TLSF_IS_FREE(block));
+    next = _tlsf_next_phys(block);
+    size = TLSF_BLOCK_SIZE(block);
+    combined = size + (TLSF_IS_FREE(next) ? TLSF_BLOCK_SIZE(next) + TLSF_OVERHEAD : 0);
+
+    if (adjust > combined)
+    {
+        /* can not grow in place, move it */
+        nmem = rt_tlsf_alloc(m, newsize);
+        if (nmem != RT_NULL)
+        {
+            rt_memcpy(nmem, rmem, size);
+            rt_tlsf_free(m, rmem);
+        }
+
+        return nmem;
+    }
+
+    tlsf->parent.used -= size;
+    if (adjust > size)
+    {
+        /* absorb the free block behind */
+        _tlsf_remove_free(tlsf, next);
+        block->size += TLSF_BLOCK_SIZE(next) + TLSF_OVERHEAD;
+        _tlsf_link_next(block);
+        _tlsf_mark_used(block);
+    }
+    _tlsf_trim_used(tlsf, block, adjust);
+
+    tlsf->parent.used += TLSF_BLOCK_SIZE(block);
+    if (tlsf->parent.max < tlsf->parent.used)
+        tlsf->parent.max = tlsf->parent.used;
+
+    return rmem;
+}
+RTM_EXPORT(rt_tlsf_realloc);
+
+/**
+ * @brief This function will release the previously allocated memory block by
+ *        rt_tlsf_alloc. The released memory block is taken back to the tlsf memory.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param rmem the address of memory which will be released.
+ */
+void rt_tlsf_free(rt_tlsf_t m, void *rmem)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block, *prev;
+
+    if (rmem == RT_NULL)
+        return;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+    RT_ASSERT((((rt_ubase_t)rmem) & (RT_ALIGN_SIZE - 1)) == 0);
+
+    tlsf = (struct rt_tlsf *)m;
+    block = TLSF_FROM_PTR(rmem);
+    RT_ASSERT((rt_uint8_t *)block >= tlsf->pool_start && (rt_uint8_t *)block < tlsf->pool_end);
+    RT_ASSERT(!TLSF_IS_FREE(block));
+
+    RT_DEBUG_LOG(RT_DEBUG_MEM, ("release memory 0x%x, size: %d\n",
+                                (rt_ubase_t)rmem, TLSF_BLOCK_SIZE(block)));
+
+    tlsf->parent.used -= TLSF_BLOCK_SIZE(block) + TLSF_OVERHEAD;
+    _tlsf_mark_free(block);
+
+    /* merge with the previous block */
+    if (TLSF_IS_PREV_FREE(block))
+    {
+        prev = block->prev_phys;
+        RT_ASSERT(TLSF_IS_FREE(prev));
+        _tlsf_remove_free(tlsf, prev);
+        prev->size += TLSF_BLOCK_SIZE(block) + TLSF_OVERHEAD;
+        _tlsf_link_next(prev);
+        block = prev;
+    }
+
+    /* merge with the next block */
+    block = _tlsf_merge_next(tlsf, block);
+    _tlsf_insert_free(tlsf, block);
+}
+RTM_EXPORT(rt_tlsf_free);
+
+/**
+ * @brief This function will get the fragmentation information of tlsf memory.
+ *
+ * @note The largest free block is looked up in the highest non-empty list,
+ *       so only that list is walked.
+ *
+ * @param m the tlsf memory management object.
+ *
+ * @param free_blocks is a pointer to get the number of free blocks.
+ *
+ * @param max_free is a pointer to get the size of the largest free block.
+ */
+void rt_tlsf_frag_info(rt_tlsf_t m, rt_size_t *free_blocks, rt_size_t *max_free)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block;
+    rt_size_t largest = 0;
+    int fl, sl;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+
+    tlsf = (struct rt_tlsf *)m;
+    if (tlsf->fl_bitmap)
+    {
+        fl = _tlsf_fls(tlsf->fl_bitmap);
+        sl = _tlsf_fls(tlsf->sl_bitmap[fl]);
+        for (block = tlsf->blocks[fl * TLSF_SL_COUNT + sl]; block; block = TLSF_LINK(block)->next_free)
+        {
+            if (TLSF_BLOCK_SIZE(block) > largest)
+                largest = TLSF_BLOCK_SIZE(block);
+        }
+    }
+
+    if (free_blocks)
+        *free_blocks = tlsf->free_blocks;
+    if (max_free)
+        *max_free = largest;
+}
+RTM_EXPORT(rt_tlsf_frag_info);
+
+/**@}*/
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+int tlsfinfo(int argc, char **argv)
+{
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    struct rt_tlsf *tlsf;
+    rt_size_t free_blocks, max_free, free_size;
+    rt_base_t level;
+
+    rt_kprintf("tlsf     total    used     max used free blocks largest  frag\n");
+    rt_kprintf("-------- -------- -------- -------- ----------- -------- ----\n");
+
+    information = rt_object_get_information(RT_Object_Class_Memory);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        tlsf = (struct rt_tlsf *)rt_list_entry(node, struct rt_object, list);
+        if (rt_strcmp(tlsf->parent.algorithm, "tlsf") != 0)
+            continue;
+
+        level = rt_hw_interrupt_disable();
+        rt_tlsf_frag_info(&tlsf->parent, &free_blocks, &max_free);
+        free_size = tlsf->parent.total - tlsf->parent.used;
+        rt_hw_interrupt_enable(level);
+
+        rt_kprintf("%-*.*s %-8d %-8d %-8d %-11d %-8d %3d%%\n",
+                   RT_NAME_MAX, RT_NAME_MAX, tlsf->parent.parent.name,
+                   tlsf->parent.total, tlsf->parent.used, tlsf->parent.max,
+                   free_blocks, max_free,
+                   free_size ? (int)(100 - max_free * 100 / free_size) : 0);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(tlsfinfo, show tlsf memory usage and fragmentation);
+
+#ifdef RT_TLSF_USING_BENCH
+#include <stdlib.h>
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#define _BENCH_NOW()            ((rt_uint32_t)clock_cpu_gettime())
+#define _BENCH_UNIT             "cycles"
+#else
+#define _BENCH_NOW()            ((rt_uint32_t)rt_tick_get())
+#define _BENCH_UNIT             "ticks"
+#endif /* RT_USING_CPUTIME */
+
+#define _BENCH_SLOTS            32
+
+struct _bench_heap
+{
+    const char *name;
+    void *(*alloc)(void *heap, rt_size_t size);
+    void (*free)(void *heap, void *ptr);
+    void *heap;
+};
+
+struct _bench_result
+{
+    rt_uint32_t total;
+    rt_uint32_t worst_alloc;
+    rt_uint32_t worst_free;
+    rt_uint32_t failed;
+};
+
+/*
+ * The trace mimics the gateway: cJSON nodes and strings, AT response lines
+ * and socket packets, and the occasional large message buffer.
+ */
+static rt_size_t _bench_size(rt_uint32_t *seed, rt_size_t arena)
+{
+    rt_uint32_t r;
+
+    *seed = *seed * 1103515245 + 12345;
+    r = (*seed >> 16) & 0x7fff;
+
+    if (r % 10 < 6)
+        return 8 + r % 56;
+    if (r % 10 < 9)
+        return 64 + r % 192;
+    return 256 + r % (arena / 8);
+}
+
+static void _bench_replay(struct _bench_heap *h, rt_size_t arena, int ops, struct _bench_result *res)
+{
+    void *slot[_BENCH_SLOTS];
+    rt_uint8_t live[_BENCH_SLOTS];
+    rt_uint32_t seed = 0x2017, t0, dt;
+    rt_size_t size;
+    int i, index;
+
+    rt_memset(slot, 0, sizeof(slot));
+    rt_memset(live, 0, sizeof(live));
+    rt_memset(res, 0, sizeof(*res));
+
+    for (i = 0; i < ops; i ++)
+    {
+        size = _bench_size(&seed, arena);
+        index = (seed >> 8) % _BENCH_SLOTS;
+
+        /* the op sequence depends on the seed only, so every heap replays the same trace */
+        if (live[index])
+        {
+            t0 = _BENCH_NOW();
+            h->free(h->heap, slot[index]);
+            dt = _BENCH_NOW() - t0;
+            if (dt > res->worst_free)
+                res->worst_free = dt;
+            slot[index] = RT_NULL;
+            live[index] = 0;
+        }
+        else
+        {
+            t0 = _BENCH_NOW();
+            slot[index] = h->alloc(h->heap, size);
+            dt = _BENCH_NOW() - t0;
+            if (dt > res->worst_alloc)
+                res->worst_alloc = dt;
+            if (slot[index] == RT_NULL)
+                res->failed ++;
+            live[index] = 1;
+        }
+        res->total += dt;
+    }
+
+    for (index = 0; index < _BENCH_SLOTS; index ++)
+    {
+        if (slot[index])
+            h->free(h->heap, slot[index]);
+    }
+}
+
+static void *_bench_tlsf_alloc(void *heap, rt_size_t size)
+{
+    return rt_tlsf_alloc((rt_tlsf_t)heap, size);
+}
+
+static void _bench_tlsf_free(void *heap, void *ptr)
+{
+    rt_tlsf_free((rt_tlsf_t)heap, ptr);
+}
+
+#ifdef RT_USING_SMALL_MEM
+static void *_bench_smem_alloc(void *heap, rt_size_t size)
+{
+    return rt_smem_alloc((rt_smem_t)heap, size);
+}
+
+static void _bench_smem_free(void *heap, void *ptr)
+{
+    rt_smem_free(ptr);
+}
+#endif /* RT_USING_SMALL_MEM */
+
+#ifdef RT_USING_MEMHEAP
+static void *_bench_memheap_alloc(void *heap, rt_size_t size)
+{
+    return rt_memheap_alloc((struct rt_memheap *)heap, size);
+}
+
+static void _bench_memheap_free(void *heap, void *ptr)
+{
+    rt_memheap_free(ptr);
+}
+#endif /* RT_USING_MEMHEAP */
+
+static void _bench_report(struct _bench_heap *h, int ops, struct _bench_result *res)
+{
+    rt_kprintf("%-8s %-8d %-8d %-10d %-10d %-8d\n", h->name, ops,
+               res->total, res->worst_alloc, res->worst_free, res->failed);
+}
+
+int tlsf_bench(int argc, char **argv)
+{
+    struct _bench_heap h;
+    struct _bench_result res;
+    rt_size_t arena_size = 4096;
+    int ops = 2000;
+    void *arena;
+#ifdef RT_USING_MEMHEAP
+    struct rt_memheap memheap;
+#endif /* RT_USING_MEMHEAP */
+
+    if (argc > 1)
+        ops = atoi(argv[1]);
+    if (argc > 2)
+        arena_size = atoi(argv[2]);
+
+    arena = rt_malloc(arena_size);
+    if (arena == RT_NULL)
+    {
+        rt_kprintf("no memory for a %d bytes arena\n", arena_size);
+        return -RT_ENOMEM;
+    }
+
+    rt_kprintf("replay %d ops on a %d bytes arena, time in %s\n", ops, arena_size, _BENCH_UNIT);
+    rt_kprintf("heap     ops      total    worst alloc worst free failed\n");
+    rt_kprintf("-------- -------- -------- ---------- ---------- --------\n");
+
+    h.name = "tlsf";
+    h.alloc = _bench_tlsf_alloc;
+    h.free = _bench_tlsf_free;
+    h.heap = rt_tlsf_init("b_tlsf", arena, arena_size);
+    if (h.heap)
+    {
+        _bench_replay(&h, arena_size, ops, &res);
+        rt_tlsf_detach((rt_tlsf_t)h.heap);
+        _bench_report(&h, ops, &res);
+    }
+
+#ifdef RT_USING_SMALL_MEM
+    h.name = "small";
+    h.alloc = _bench_smem_alloc;
+    h.free = _bench_smem_free;
+    h.heap = rt_smem_init("b_small", arena, arena_size);
+    if (h.heap)
+    {
+        _bench_replay(&h, arena_size, ops, &res);
+        rt_smem_detach((rt_smem_t)h.heap);
+        _bench_report(&h, ops, &res);
+    }
+#endif /* RT_USING_SMALL_MEM */
+
+#ifdef RT_USING_MEMHEAP
+    h.name = "memheap";
+    h.alloc = _bench_memheap_alloc;
+    h.free = _bench_memheap_free;
+    h.heap = &memheap;
+    if (rt_memheap_init(&memheap, "b_mheap", arena, arena_size) == RT_EOK)
+    {
+        _bench_replay(&h, arena_size, ops, &res);
+        rt_memheap_detach(&memheap);
+        _bench_report(&h, ops, &res);
+    }
+#endif /* RT_USING_MEMHEAP */
+
+    rt_free(arena);
+    return 0;
+}
+MSH_CMD_EXPORT(tlsf_bench, replay an allocation trace on tlsf small and memheap: tlsf_bench [ops] [arena]);
+#endif /* RT_TLSF_USING_BENCH */
+#endif /* RT_USING_FINSH */
+
+#endif /* defined (RT_USING_TLSF) */
@@ -0,0 +1,122 @@
+#
+# Copyright (c) 2006-2023, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-19     RT-Thread    first version
+#
+
+# Report the slowest initialization functions from the output of the
+# "init_profile -csv" command (src/components.c, RT_USING_INIT_PROFILE),
+# compare them with the log of an earlier boot, and write the boot as a
+# Chrome trace JSON timeline (chrome://tracing or ui.perfetto.dev).
+#
+# usage: python init_report.py console.log [-n 20] [-b old.log] [-o boot.json]
+
+import sys
+import json
+import argparse
+
+PHASES = ['board', 'component', 'deferred', 'mark']
+
+class Record:
+    def __init__(self, phase, name, start, used, result):
+        self.phase = phase
+        self.name = name
+        self.start = start
+        self.used = used
+        self.result = result
+
+def parse(lines):
+    records = []
+
+    for line in lines:
+        pos = line.find('init,')
+        if pos < 0:
+            continue
+        fields = line[pos:].strip().split(',')
+        if len(fields) != 6:
+            continue
+        if fields[1] == 'phase':
+            # a new dump replaces the previous one of the same log
+            records = []
+            continue
+        try:
+            records.append(Record(fields[1], fields[2], int(fields[3]), int(fields[4]), int(fields[5])))
+        except ValueError:
+            continue
+
+    return records
+
+def report(records, top, baseline, out):
+    funcs = [r for r in records if r.phase != 'mark']
+    marks = [r for r in records if r.phase == 'mark']
+
+    for r in marks:
+        out.write('%-12s at %10.3f ms\n' % (r.name, r.start / 1000.0))
+    for phase in PHASES[:-1]:
+        used = sum(r.used for r in funcs if r.phase == phase)
+        count = len([r for r in funcs if r.phase == phase])
+        out.write('%-12s %10.3f ms in %d functions\n' % (phase, used / 1000.0, count))
+
+    failed = [r for r in funcs if r.result < 0]
+    if failed:
+        out.write('failed: %s\n' % ', '.join('%s(%d)' % (r.name, r.result) for r in failed))
+
+    old = {}
+    if baseline is not None:
+        old = dict((r.name, r.used) for r in baseline if r.phase != 'mark')
+
+    out.write('\n%10s %10s  %-10s %6s  %s\n' % ('time(us)', 'start(us)', 'phase', 'result', 'name'))
+    for r in sorted(funcs, key = lambda r: -r.used)[:top]:
+        diff = ''
+        if r.name in old:
+            diff = '  %+d us' % (r.used - old[r.name])
+        elif baseline is not None:
+            diff = '  new'
+        out.write('%10d %10d  %-10s %6d  %s%s\n' % (r.used, r.start, r.phase, r.result, r.name, diff))
+
+def timeline(records):
+    events = []
+
+    for r in records:
+        tid = PHASES.index(r.phase) if r.phase in PHASES else 0
+        if r.phase == 'mark':
+            events.append({'name': r.name, 'ph': 'i', 's': 'g', 'pid': 0, 'tid': tid, 'ts': r.start})
+        else:
+            events.append({'name': r.name, 'ph': 'X', 'pid': 0, 'tid': tid, 'ts': r.start,
+                           'dur': r.used, 'args': {'result': r.result}})
+    for tid, name in enumerate(PHASES):
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': tid, 'args': {'name': name}})
+
+    return events
+
+def main():
+    parser = argparse.ArgumentParser(description = 'report the RT-Thread "init_profile -csv" output')
+    parser.add_argument('log', help = 'console log holding the output')
+    parser.add_argument('-n', '--top', type = int, default = 20, help = 'functions to list, default 20')
+    parser.add_argument('-b', '--baseline', help = 'console log of an earlier boot to compare with')
+    parser.add_argument('-o', '--output', help = 'Chrome trace JSON file to write')
+    args = parser.parse_args()
+
+    with open(args.log, 'r', errors = 'replace') as f:
+        records = parse(f)
+    if not records:
+        sys.stderr.write('no "init," lines in %s\n' % args.log)
+        sys.exit(1)
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline, 'r', errors = 'replace') as f:
+            baseline = parse(f)
+
+    report(records, args.top, baseline, sys.stdout)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'traceEvents': timeline(records), 'displayTimeUnit': 'ms'}, f)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,246 @@
+#
+# Copyright (c) 2006-2023, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-19     RT-Thread    first version
+#
+
+# Decode the output of the "trace dump" command (components/utilities/trace)
+# into a Chrome trace JSON timeline (chrome://tracing or ui.perfetto.dev), and
+# print the CPU share and the blocking time breakdown of each thread.
+#
+# usage: python trace_decode.py console.log [-o trace.json]
+
+import sys
+import json
+import argparse
+
+EV_START, EV_SWITCH, EV_IRQ_ENTER, EV_IRQ_LEAVE, EV_TRYTAKE, EV_TAKE, EV_PUT, \
+    EV_SUSPEND, EV_RESUME, EV_MARK, EV_BEGIN, EV_END = range(12)
+
+THREAD_READY = 1
+THREAD_SUSPEND = 2
+THREAD_CLOSE = 4
+
+CLASS_NAMES = {2: 'sem', 3: 'mutex', 4: 'event', 5: 'mailbox', 6: 'mq'}
+IPC_EVENTS = {EV_TRYTAKE: 'trytake', EV_TAKE: 'take', EV_PUT: 'put'}
+
+IRQ_TID = 0
+MARK_TID = 1
+
+class Trace:
+    def __init__(self):
+        self.freq = 0
+        self.total = 0
+        self.lost = 0
+        self.threads = {}
+        self.objects = {}
+        self.records = []
+
+    def thread_name(self, addr):
+        if addr in self.threads:
+            return self.threads[addr][0]
+        return '0x%08x' % addr
+
+    def object_name(self, addr, cls = 0):
+        if addr in self.objects:
+            return '%s %s' % (CLASS_NAMES.get(self.objects[addr][0], '?'), self.objects[addr][1])
+        return '%s 0x%08x' % (CLASS_NAMES.get(cls, '?'), addr)
+
+def parse(lines):
+    trace = Trace()
+    found = False
+
+    for line in lines:
+        pos = line.find('trace:')
+        if pos < 0:
+            continue
+        line = line[pos + len('trace:'):].strip()
+        kind, _, body = line.partition(',')
+        fields = body.split(',')
+
+        if kind == 'header':
+            # a new dump replaces the previous one of the same log
+            trace = Trace()
+            found = True
+            trace.freq = int(fields[1])
+            trace.total = int(fields[3])
+            trace.lost = int(fields[4])
+        elif kind == 'thread':
+            trace.threads[int(fields[0], 16)] = (fields[1], int(fields[2]))
+        elif kind == 'object':
+            trace.objects[int(fields[0], 16)] = (int(fields[1]), fields[2])
+        elif kind == 'records':
+            for text in body.split():
+                for i in range(0, len(text) - 23, 24):
+                    rec = text[i:i + 24]
+                    trace.records.append((int(rec[0:8], 16), int(rec[8:16], 16),
+                                          int(rec[16:20], 16), int(rec[20:22], 16),
+                                          int(rec[22:24], 16)))
+
+    if not found:
+        raise ValueError('no "trace:header" line, is it the output of "trace dump"?')
+    return trace
+
+def unwrap(records):
+    # the time stamps are the low 32 bits of the cpu time
+    base = 0
+    last = None
+    for time, obj, arg, event, aux in records:
+        if last is not None and time < last:
+            base += 1 << 32
+        last = time
+        yield base + time, obj, arg, event, aux
+
+class ThreadStat:
+    def __init__(self):
+        self.cpu = 0
+        self.ready = 0
+        self.blocked = {}
+        self.switches = 0
+        self.out_time = None        # when it was switched out
+        self.out_reason = None      # None when preempted, the blocking object otherwise
+        self.pending = None         # the last object it tried to take
+
+def analyse(trace):
+    to_us = 1000000.0 / trace.freq
+    events = []
+    stats = {}
+    current = None
+    run_start = None
+    irq_stack = []
+    irq_time = 0
+    first = last = None
+
+    def stat(addr):
+        if addr not in stats:
+            stats[addr] = ThreadStat()
+        return stats[addr]
+
+    def slice_event(name, tid, start, end, args = None):
+        ev = {'name': name, 'ph': 'X', 'pid': 0, 'tid': tid,
+              'ts': start * to_us, 'dur': (end - start) * to_us}
+        if args:
+            ev['args'] = args
+        events.append(ev)
+
+    for time, obj, arg, event, aux in unwrap(trace.records):
+        if first is None:
+            first = time
+        last = time
+
+        if event == EV_START:
+            current, run_start = obj, time
+            stat(obj)
+        elif event == EV_SWITCH:
+            if current is not None:
+                st = stat(current)
+                st.cpu += time - run_start
+                st.out_time = time
+                if aux == THREAD_READY:
+                    st.out_reason = None
+                elif st.pending is not None:
+                    st.out_reason = trace.object_name(*st.pending)
+                else:
+                    st.out_reason = 'delay'
+                slice_event(trace.thread_name(current), current, run_start, time)
+
+            st = stat(obj)
+            st.switches += 1
+            if st.out_time is not None:
+                if st.out_reason is None:
+                    st.ready += time - st.out_time
+                else:
+                    st.blocked[st.out_reason] = st.blocked.get(st.out_reason, 0) + time - st.out_time
+            st.out_time = None
+            st.pending = None
+            current, run_start = obj, time
+        elif event == EV_IRQ_ENTER:
+            irq_stack.append((time, aux))
+        elif event == EV_IRQ_LEAVE:
+            if irq_stack:
+                start, number = irq_stack.pop()
+                if not irq_stack:
+                    irq_time += time - start
+                    if current is not None:
+                        stat(current).cpu -= time - start
+                slice_event('irq %d' % (number - 16 if number >= 16 else number), IRQ_TID, start, time)
+        elif event in IPC_EVENTS:
+            name = trace.object_name(obj, aux)
+            tid = IRQ_TID if irq_stack or current is None else current
+            if tid != IRQ_TID:
+                if event == EV_TRYTAKE:
+                    stat(current).pending = (obj, aux)
+                elif event == EV_TAKE:
+                    stat(current).pending = None
+            events.append({'name': '%s %s' % (IPC_EVENTS[event], name), 'ph': 'i', 's': 't',
+                           'pid': 0, 'tid': tid, 'ts': time * to_us})
+        elif event in (EV_SUSPEND, EV_RESUME):
+            tid = IRQ_TID if irq_stack or current is None else current
+            events.append({'name': '%s %s' % ('suspend' if event == EV_SUSPEND else 'resume',
+                                              trace.thread_name(obj)),
+                           'ph': 'i', 's': 't', 'pid': 0, 'tid': tid, 'ts': time * to_us})
+        elif event in (EV_MARK, EV_BEGIN, EV_END):
+            ph = {EV_MARK: 'i', EV_BEGIN: 'B', EV_END: 'E'}[event]
+            ev = {'name': 'mark %d' % obj, 'ph': ph, 'pid': 0, 'tid': MARK_TID,
+                  'ts': time * to_us, 'args': {'value': arg}}
+            if ph == 'i':
+                ev['s'] = 't'
+            events.append(ev)
+
+    if current is not None and last is not None:
+        stat(current).cpu += last - run_start
+        slice_event(trace.thread_name(current), current, run_start, last)
+
+    names = [(IRQ_TID, 'interrupts'), (MARK_TID, 'markers')]
+    names += [(addr, trace.thread_name(addr)) for addr in stats]
+    for tid, name in names:
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': tid, 'args': {'name': name}})
+
+    span = (last - first) if first is not None else 0
+    return events, stats, irq_time, span, to_us
+
+def report(trace, stats, irq_time, span, to_us, out):
+    out.write('%d records, %d written, %d lost, %d counts per second\n' %
+              (len(trace.records), trace.total, trace.lost, trace.freq))
+    if trace.total > len(trace.records):
+        out.write('the ring wrapped, the oldest %d records are gone\n' % (trace.total - len(trace.records)))
+    if span == 0:
+        return
+    out.write('span: %.3f ms, interrupts: %.3f ms (%.1f%%)\n\n' %
+              (span * to_us / 1000, irq_time * to_us / 1000, irq_time * 100.0 / span))
+
+    out.write('%-10s %5s %10s %6s %10s %10s %8s\n' %
+              ('thread', 'prio', 'cpu(ms)', 'cpu%', 'ready(ms)', 'block(ms)', 'switches'))
+    for addr, st in sorted(stats.items(), key = lambda item: -item[1].cpu):
+        prio = trace.threads[addr][1] if addr in trace.threads else -1
+        out.write('%-10s %5d %10.3f %5.1f%% %10.3f %10.3f %8d\n' %
+                  (trace.thread_name(addr), prio, st.cpu * to_us / 1000, st.cpu * 100.0 / span,
+                   st.ready * to_us / 1000, sum(st.blocked.values()) * to_us / 1000, st.switches))
+
+    out.write('\nblocking time by object:\n')
+    for addr, st in sorted(stats.items(), key = lambda item: -sum(item[1].blocked.values())):
+        for reason, ticks in sorted(st.blocked.items(), key = lambda item: -item[1]):
+            out.write('  %-10s %-24s %10.3f ms\n' % (trace.thread_name(addr), reason, ticks * to_us / 1000))
+
+def main():
+    parser = argparse.ArgumentParser(description = 'decode the RT-Thread "trace dump" output')
+    parser.add_argument('log', help = 'console log holding the dump')
+    parser.add_argument('-o', '--output', help = 'Chrome trace JSON file to write')
+    args = parser.parse_args()
+
+    with open(args.log, 'r', errors = 'replace') as f:
+        trace = parse(f)
+
+    events, stats, irq_time, span, to_us = analyse(trace)
+    report(trace, stats, irq_time, span, to_us, sys.stdout)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,254 @@
+#
+# Copyright (c) 2006-2023, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-19     RT-Thread    first version
+#
+
+# Rebuild the text of the ulog binary mode (ULOG_USING_BINARY). The target only
+# prints "ulog:bin,<hex>" lines holding the address of the format and the tag,
+# so the strings are read from the ELF file of the same firmware build.
+# The other lines of the log are copied as they are.
+#
+# usage: python ulog_decode.py rtthread.elf console.log [-o decoded.log]
+
+import sys
+import struct
+import argparse
+
+BIN_FRAME_MAGIC = 0x11
+
+LEVEL_INFO = {0: 'A/', 3: 'E/', 4: 'W/', 6: 'I/', 7: 'D/'}
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+class Elf:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+        self.is64 = self.data[4] == 2
+        self.endian = '<' if self.data[5] == 1 else '>'
+        self.sections = []
+
+        if self.is64:
+            shoff, = struct.unpack_from(self.endian + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(self.endian + 'HH', self.data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(self.endian + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(self.endian + 'HH', self.data, 0x2E)
+
+        for i in range(shnum):
+            base = shoff + i * shentsize
+            if self.is64:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(self.endian + 'IIQQQQ', self.data, base)
+            else:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(self.endian + 'IIIIII', self.data, base)
+            # only the loaded sections with contents, the constant strings are in .rodata
+            if flags & SHF_ALLOC and sh_type != SHT_NOBITS and size:
+                self.sections.append((addr, size, offset))
+
+    @property
+    def pointer_size(self):
+        return 8 if self.is64 else 4
+
+    def string(self, addr):
+        for start, size, offset in self.sections:
+            if start <= addr < start + size:
+                begin = offset + addr - start
+                end = self.data.find(b'\0', begin, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[begin:end].decode('utf-8', 'replace')
+        return None
+
+class Args:
+    def __init__(self, data, endian):
+        self.data = data
+        self.endian = endian
+        self.pos = 0
+
+    def words(self, count):
+        if self.pos + 4 * count > len(self.data):
+            self.pos = len(self.data)
+            return None
+        values = struct.unpack_from(self.endian + 'I' * count, self.data, self.pos)
+        self.pos += 4 * count
+        return values
+
+    def string(self):
+        if self.pos >= len(self.data):
+            return None
+        end = self.data.find(b'\0', self.pos)
+        if end < 0:
+            end = len(self.data)
+        text = self.data[self.pos:end].decode('utf-8', 'replace')
+        # the same padding as ulog_binary_pack
+        self.pos += (end - self.pos) // 4 * 4 + 4
+        return text
+
+    def double(self):
+        if self.pos + 8 > len(self.data):
+            self.pos = len(self.data)
+            return None
+        value, = struct.unpack_from(self.endian + 'd', self.data, self.pos)
+        self.pos += 8
+        return value
+
+def signed(value, bits):
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+def format_args(fmt, args):
+    # walk the format in the same way as ulog_binary_pack in ulog.c
+    out = []
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        if c != '%':
+            out.append(c)
+            i += 1
+            continue
+
+        i += 1
+        spec = '%'
+        while i < len(fmt) and (fmt[i] in '-+ #.*' or fmt[i].isdigit()):
+            if fmt[i] == '*':
+                word = args.words(1)
+                spec += str(signed(word[0], 32)) if word else ''
+            else:
+                spec += fmt[i]
+            i += 1
+        long_cnt = short_cnt = 0
+        while i < len(fmt) and fmt[i] in 'hlzjt':
+            if fmt[i] == 'l':
+                long_cnt += 1
+            elif fmt[i] == 'h':
+                short_cnt += 1
+            elif fmt[i] == 'j':
+                long_cnt = 2
+            i += 1
+        if i >= len(fmt):
+            break
+        conv = fmt[i]
+        i += 1
+
+        if conv == '%':
+            out.append('%')
+        elif conv == 's':
+            value = args.string()
+            out.append('?' if value is None else (spec + 's') % value)
+        elif conv in 'eEfFgGaA':
+            value = args.double()
+            out.append('?' if value is None else (spec + (conv if conv not in 'aA' else 'e')) % value)
+        elif conv == 'p':
+            word = args.words(1)
+            out.append('?' if word is None else '0x%08x' % word[0])
+        else:
+            if long_cnt >= 2:
+                words = args.words(2)
+                value = None if words is None else words[0] | (words[1] << 32)
+                bits = 64
+            else:
+                words = args.words(1)
+                value = None if words is None else words[0]
+                # the char and short arguments are promoted to int
+                bits = {0: 32, 1: 16}.get(short_cnt, 8)
+                if value is not None:
+                    value &= (1 << bits) - 1
+            if value is None:
+                out.append('?')
+            elif conv in 'di':
+                out.append((spec + 'd') % signed(value, bits))
+            elif conv in 'uxXo':
+                out.append((spec + ('d' if conv == 'u' else conv)) % value)
+            elif conv == 'c':
+                out.append((spec + 'c') % chr(value & 0xFF))
+            else:
+                out.append('%' + conv)
+    return ''.join(out)
+
+class Decoder:
+    def __init__(self, elf):
+        self.elf = elf
+        self.freq = 0
+        self.base = 0
+        self.last = None
+
+    def time(self, value):
+        # the time is the low 32 bits of the cpu time or the tick
+        if self.last is not None and value < self.last:
+            self.base += 1 << 32
+        self.last = value
+        value += self.base
+        if self.freq:
+            return '%d.%06d' % (value // self.freq, value % self.freq * 1000000 // self.freq)
+        return '%d' % value
+
+    def frame(self, data):
+        endian = self.elf.endian
+        psize = self.elf.pointer_size
+        head = 8 + 2 * psize
+        if len(data) < head:
+            return '<short ulog frame>'
+
+        word, time = struct.unpack_from(endian + 'II', data, 0)
+        fmt_addr, tag_addr = struct.unpack_from(endian + ('QQ' if psize == 8 else 'II'), data, 8)
+        magic = word & 0xFF
+        level = (word >> 8) & 0xFF
+        args_len = word >> 17
+        if magic != BIN_FRAME_MAGIC:
+            return '<bad ulog frame magic 0x%02x>' % magic
+
+        fmt = self.elf.string(fmt_addr)
+        tag = self.elf.string(tag_addr)
+        if fmt is None:
+            return '<format 0x%08x not found, is the ELF file of this build?>' % fmt_addr
+        if tag is None:
+            tag = '0x%08x' % tag_addr
+
+        text = format_args(fmt, Args(data[head:head + args_len], endian))
+        return '[%s] %s%s: %s' % (self.time(time), LEVEL_INFO.get(level, '%d/' % level), tag, text)
+
+    def line(self, line):
+        pos = line.find('ulog:bin')
+        if pos < 0:
+            return line.rstrip('\r\n')
+
+        kind, _, body = line[pos:].strip().partition(',')
+        if kind == 'ulog:bin_header':
+            fields = body.split(',')
+            self.freq = int(fields[1])
+            return None
+        if kind == 'ulog:bin_lost':
+            return '<%s logs lost, the async buffer was full>' % body
+        if kind == 'ulog:bin':
+            try:
+                return self.frame(bytes.fromhex(body))
+            except ValueError:
+                return '<broken ulog frame>'
+        return line.rstrip('\r\n')
+
+def main():
+    parser = argparse.ArgumentParser(description = 'decode the ulog binary mode output')
+    parser.add_argument('elf', help = 'ELF file of the firmware which printed the log')
+    parser.add_argument('log', help = 'console log holding the "ulog:bin" lines')
+    parser.add_argument('-o', '--output', help = 'file to write, the default is stdout')
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf))
+    out = open(args.output, 'w') if args.output else sys.stdout
+    with open(args.log, 'r', errors = 'replace') as f:
+        for line in f:
+            text = decoder.line(line)
+            if text is not None:
+                out.write(text + '\n')
+    if args.output:
+        out.close()
+
+if __name__ == '__main__':
+    main()